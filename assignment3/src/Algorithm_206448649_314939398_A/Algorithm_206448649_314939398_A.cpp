@@ -31,6 +31,54 @@ void Algorithm_206448649_314939398_A::setBatteryMeter(const BatteryMeter &batter
     this->batteryMeter = &batteryMeter;
 }
 
+void Algorithm_206448649_314939398_A::setGridLayout(GridLayout layout) {
+    vertices.setLayout(layout);
+    dirtyPos.setLayout(layout);
+    bfsVisited.setLayout(layout);
+    bfsParent.setLayout(layout);
+}
+
+// the first field of a state, so a state of the other algorithm (or another version of this one) is refused
+static constexpr std::uint32_t STATE_TAG = 0x31534141; // "AAS1"
+
+std::string Algorithm_206448649_314939398_A::saveState() const {
+    StateWriter writer;
+    writer.write(STATE_TAG);
+    writer.write(std::uint64_t(maxBatterySteps));
+    writer.write(std::uint8_t(firstStep));
+    writer.write(std::uint64_t(totalSteps));
+    writer.write(currPosition);
+    writer.write(prevPosition);
+    writer.write(std::uint8_t(returnToDockingStation));
+    writer.write(std::uint8_t(followPathToDirtyPoint));
+    writer.writeSteps(pathToDirtyPoint);
+    writer.writeSteps(tripStepsLog);
+    writer.writeVertices(vertices);
+    writer.writeDirt(dirtyPos);
+    return writer.getState();
+}
+
+void Algorithm_206448649_314939398_A::loadState(const std::string &state) {
+    StateReader reader(state);
+    if (reader.read<std::uint32_t>() != STATE_TAG) {
+        throw std::runtime_error("Not a state of Algorithm_206448649_314939398_A");
+    }
+    maxBatterySteps = std::size_t(reader.read<std::uint64_t>());
+    firstStep = reader.read<std::uint8_t>() != 0;
+    totalSteps = std::size_t(reader.read<std::uint64_t>());
+    currPosition = reader.readPosition();
+    prevPosition = reader.readPosition();
+    returnToDockingStation = reader.read<std::uint8_t>() != 0;
+    followPathToDirtyPoint = reader.read<std::uint8_t>() != 0;
+    reader.readSteps(pathToDirtyPoint);
+    reader.readSteps(tripStepsLog);
+    reader.readVertices(vertices);
+    reader.readDirt(dirtyPos);
+    if (!reader.done()) {
+        throw std::runtime_error("Invalid state of Algorithm_206448649_314939398_A");
+    }
+}
+
 Step Algorithm_206448649_314939398_A::nextStep() {
     Step res;
     if (firstStep) {
@@ -38,7 +86,7 @@ Step Algorithm_206448649_314939398_A::nextStep() {
         maxBatterySteps = batteryMeter->getBatteryState();
         relax();
     }
-    if (totalSteps >= int(maxSteps)) {
+    if (totalSteps >= maxSteps) {
         res = Step::Finish;
         return res;
     }
@@ -89,8 +137,8 @@ Step Algorithm_206448649_314939398_A::nextStep() {
         relax();
     }
     if (int(batteryMeter->getBatteryState()) <= (vertices[currPosition]->d + 1) ||
-        (int(maxSteps) - totalSteps) <= (vertices[currPosition]->d + 1)) {
-        if (totalSteps == int(maxSteps)) {
+        maxSteps - totalSteps <= size_t(vertices[currPosition]->d + 1)) {
+        if (totalSteps == maxSteps) {
             res = Step::Finish;
             return res;
         }
@@ -131,13 +179,14 @@ void Algorithm_206448649_314939398_A::relax() {
     for (Direction dir: {Direction::North, Direction::East, Direction::South, Direction::West}) {
         auto newPosition = moveInDirection(currVertex->position, dir);
         if (!wallsSensor->isWall(dir)) {
-            if (vertices.find(newPosition) != vertices.end()) {
+            auto &newVertexSlot = vertices[newPosition];
+            if (newVertexSlot) {
                 // If newPosition exists in vertices
-                if (currVertex->d > vertices[newPosition]->d + 1) {
-                    currVertex->d = vertices[newPosition]->d + 1;
+                if (currVertex->d > newVertexSlot->d + 1) {
+                    currVertex->d = newVertexSlot->d + 1;
                     currVertex->pai = getMatchingStep(dir);
                 }
-                auto newVertex = vertices[newPosition];
+                auto newVertex = newVertexSlot;
                 // Update neighbors list for both vertices
                 if (std::find(currVertex->neighbors.begin(), currVertex->neighbors.end(), newPosition) ==
                     currVertex->neighbors.end()) {
@@ -154,7 +203,7 @@ void Algorithm_206448649_314939398_A::relax() {
                 currVertex->neighbors.push_back(newPosition);
                 newVertex->neighbors.push_back(currVertex->position);
                 dirtyPos[newVertex->position] = newVertex->vertexDirtLevel; // newVertex->vertexDirtLevel = MAX_INT
-                vertices[newPosition] = std::move(newVertex);
+                newVertexSlot = std::move(newVertex);
             }
         }
     }
@@ -184,44 +233,42 @@ Step Algorithm_206448649_314939398_A::moveTo(std::pair<int, int> targetPosition)
 }
 
 std::pair<int, int> Algorithm_206448649_314939398_A::findClosestDirtyPoint(std::vector<Step> &path) {
-    std::queue<std::pair<int, int>> q;
-    std::unordered_map<std::pair<int, int>, bool, VertexHash> visited;
-    std::unordered_map<std::pair<int, int>, std::pair<int, int>, VertexHash> parent;
-    std::unordered_map<std::pair<int, int>, int, VertexHash> distance;
+    // reuse the BFS scratch of the previous call (no allocations once the explored map stops growing)
+    bfsQueue.clear();
+    bfsVisited.resetValues();
+    bfsParent.resetValues();
 
-    q.push(dockingStation);
-    visited[dockingStation] = true;
-    distance[dockingStation] = 0;
+    bfsQueue.push_back(dockingStation);
+    bfsVisited[dockingStation] = true;
 
     std::pair<int, int> closestDirtyPoint = dockingStation;
     int maxDirtLevel = 0;
     bool foundClosest = false;
 
-    while (!q.empty() && !foundClosest) {
-        size_t size = q.size();  // Number of nodes at the current distance level
+    std::size_t head = 0;
+    while (head < bfsQueue.size() && !foundClosest) {
+        size_t size = bfsQueue.size() - head;  // Number of nodes at the current distance level
         for (int i = 0; i < int(size); ++i) {
-            auto current = q.front();
-            q.pop();
+            auto current = bfsQueue[head++];
             if (dirtyPos[current] > maxDirtLevel) {
                 closestDirtyPoint = current;
                 maxDirtLevel = dirtyPos[current];
                 foundClosest = true;
             }
             for (const auto &neighbor: vertices[current]->neighbors) {
-                if (!visited[neighbor]) {
-                    visited[neighbor] = true;
-                    parent[neighbor] = current;
-                    distance[neighbor] = distance[current] + 1;
-                    q.push(neighbor);
+                if (!bfsVisited[neighbor]) {
+                    bfsVisited[neighbor] = true;
+                    bfsParent[neighbor] = current;
+                    bfsQueue.push_back(neighbor);
                 }
             }
         }
     }
     std::pair<int, int> step = closestDirtyPoint;
     while (step != dockingStation) {
-        auto parentStep = parent[step];
+        auto parentStep = bfsParent[step];
         path.insert(path.begin(), moveTo(step));
         step = parentStep;
     }
     return closestDirtyPoint;
-}
\ No newline at end of file
+}
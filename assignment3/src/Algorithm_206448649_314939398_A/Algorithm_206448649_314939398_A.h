@@ -2,6 +2,7 @@
 #define ASSIGNMENT3_ALGORITHM_206448649_314939398_A_H
 
 #include "utils.h"
+#include "Grid.h"
 #include "enums.h"
 #include "DirtSensor.h"
 #include "WallSensor.h"
@@ -9,8 +10,11 @@
 #include "AbstractAlgorithm.h"
 #include "AlgorithmRegistrar.h"
 #include "AlgorithmRegistration.h"
+#include "AlgorithmExtensions.h"
+#include "AlgorithmState.h"
 
-class Algorithm_206448649_314939398_A : public AbstractAlgorithm {
+class Algorithm_206448649_314939398_A : public AbstractAlgorithm, public GridLayoutAwareAlgorithm,
+                                        public SerializableAlgorithm {
 public:
     Algorithm_206448649_314939398_A();
     void setMaxSteps(size_t maxSteps) override;
@@ -18,24 +22,32 @@ public:
     void setDirtSensor(const DirtSensor& dirtSensor) override;
     void setBatteryMeter(const BatteryMeter& batteryMeter) override;
     Step nextStep() override;
+    void setGridLayout(GridLayout layout) override;
+    std::string saveState() const override;
+    void loadState(const std::string& state) override;
 
 private:
+    friend struct AlgorithmBenchAccess; // bench/AlgorithmBench.cpp
     size_t maxSteps;
     const WallsSensor* wallsSensor;
     const DirtSensor* dirtSensor;
     const BatteryMeter* batteryMeter;
     size_t maxBatterySteps;
     bool firstStep = true;
-    int totalSteps;
+    size_t totalSteps;
     std::deque<Step> tripStepsLog;
-    std::unordered_map<std::pair<int, int>, std::shared_ptr<Vertex>, VertexHash> vertices;
-    std::unordered_map<std::pair<int, int>, int, VertexHash> dirtyPos;
+    TiledMap<std::shared_ptr<Vertex>> vertices;
+    TiledMap<int> dirtyPos;
     std::pair<int, int> dockingStation;
     std::pair<int, int> currPosition;
     std::pair<int, int> prevPosition;
     bool returnToDockingStation = false;
     bool followPathToDirtyPoint = false;
     std::vector<Step> pathToDirtyPoint;
+    // findClosestDirtyPoint() scratch, kept between calls
+    std::vector<std::pair<int, int>> bfsQueue;
+    TiledMap<bool> bfsVisited;
+    TiledMap<std::pair<int, int>> bfsParent;
 
     // private methods:
     Step moveTo(std::pair<int, int> targetPosition);
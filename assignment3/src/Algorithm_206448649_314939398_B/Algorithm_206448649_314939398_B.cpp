@@ -5,16 +5,21 @@ REGISTER_ALGORITHM(Algorithm_206448649_314939398_B);
 }
 
 
-#include <algorithm>  // for std::shuffle
-#include <random>     // for std::default_random_engine
-#include <chrono>     // for std::chrono::system_clock
+#include <random>     // for std::random_device
+
+// unseeded instances keep the old behavior: a different run every time
+static std::uint64_t randomSeed() {
+    std::random_device device;
+    return (std::uint64_t(device()) << 32) | device();
+}
 
 
 Algorithm_206448649_314939398_B::Algorithm_206448649_314939398_B() : maxSteps(0), wallsSensor(nullptr),
                                                                      dirtSensor(nullptr), batteryMeter(nullptr),
                                                                      maxBatterySteps(0), totalSteps(0),
                                                                      dockingStation(0, 0), currPosition(0, 0),
-                                                                     prevPosition(0, 0) {
+                                                                     prevPosition(0, 0),
+                                                                     rng(randomSeed()) {
     // Create a new Vertex for the docking station
     auto dockingStationVertex = std::make_shared<Vertex>(dockingStation, 0, Step::Stay);
     vertices[dockingStation] = dockingStationVertex;
@@ -37,6 +42,66 @@ void Algorithm_206448649_314939398_B::setBatteryMeter(const BatteryMeter &batter
     this->batteryMeter = &batteryMeter;
 }
 
+void Algorithm_206448649_314939398_B::setSeed(std::uint64_t seed) {
+    rng.reseed(seed);
+}
+
+void Algorithm_206448649_314939398_B::setGridLayout(GridLayout layout) {
+    vertices.setLayout(layout);
+    dirtyPos.setLayout(layout);
+}
+
+// the first field of a state, so a state of the other algorithm (or another version of this one) is refused
+static constexpr std::uint32_t STATE_TAG = 0x31534241; // "ABS1"
+
+std::string Algorithm_206448649_314939398_B::saveState() const {
+    StateWriter writer;
+    writer.write(STATE_TAG);
+    writer.write(std::uint64_t(maxBatterySteps));
+    writer.write(std::uint8_t(firstStep));
+    writer.write(std::uint64_t(totalSteps));
+    writer.write(currPosition);
+    writer.write(prevPosition);
+    writer.write(std::uint8_t(returnToDockingStation));
+    writer.write(lastPosition);
+    writer.write(std::uint8_t(followPathToLastPoint));
+    writer.writeSteps(pathToLastPoint);
+    for (std::uint64_t word: rng.getState()) {
+        writer.write(word);
+    }
+    writer.writeSteps(tripStepsLog);
+    writer.writeVertices(vertices);
+    writer.writeDirt(dirtyPos);
+    return writer.getState();
+}
+
+void Algorithm_206448649_314939398_B::loadState(const std::string &state) {
+    StateReader reader(state);
+    if (reader.read<std::uint32_t>() != STATE_TAG) {
+        throw std::runtime_error("Not a state of Algorithm_206448649_314939398_B");
+    }
+    maxBatterySteps = std::size_t(reader.read<std::uint64_t>());
+    firstStep = reader.read<std::uint8_t>() != 0;
+    totalSteps = std::size_t(reader.read<std::uint64_t>());
+    currPosition = reader.readPosition();
+    prevPosition = reader.readPosition();
+    returnToDockingStation = reader.read<std::uint8_t>() != 0;
+    lastPosition = reader.readPosition();
+    followPathToLastPoint = reader.read<std::uint8_t>() != 0;
+    reader.readSteps(pathToLastPoint);
+    std::array<std::uint64_t, 4> rngState;
+    for (std::uint64_t &word: rngState) {
+        word = reader.read<std::uint64_t>();
+    }
+    rng.setState(rngState);
+    reader.readSteps(tripStepsLog);
+    reader.readVertices(vertices);
+    reader.readDirt(dirtyPos);
+    if (!reader.done()) {
+        throw std::runtime_error("Invalid state of Algorithm_206448649_314939398_B");
+    }
+}
+
 Step Algorithm_206448649_314939398_B::nextStep() {
     Step res;
     if (firstStep) {
@@ -44,7 +109,7 @@ Step Algorithm_206448649_314939398_B::nextStep() {
         maxBatterySteps = batteryMeter->getBatteryState();
         relax();
     }
-    if (totalSteps >= int(maxSteps)) {
+    if (totalSteps >= maxSteps) {
         res = Step::Finish;
         return res;
     }
@@ -94,8 +159,8 @@ Step Algorithm_206448649_314939398_B::nextStep() {
         relax();
     }
     if (int(batteryMeter->getBatteryState()) <= (vertices[currPosition]->d + 1) ||
-        (int(maxSteps) - totalSteps) <= (vertices[currPosition]->d + 1)) {
-        if (totalSteps == int(maxSteps)) {
+        maxSteps - totalSteps <= size_t(vertices[currPosition]->d + 1)) {
+        if (totalSteps == maxSteps) {
             res = Step::Finish;
             return res;
         }
@@ -137,13 +202,14 @@ void Algorithm_206448649_314939398_B::relax() {
     for (Direction dir: {Direction::North, Direction::East, Direction::South, Direction::West}) {
         auto newPosition = moveInDirection(currVertex->position, dir);
         if (!wallsSensor->isWall(dir)) {
-            if (vertices.find(newPosition) != vertices.end()) {
+            auto &newVertexSlot = vertices[newPosition];
+            if (newVertexSlot) {
                 // If newPosition exists in vertices
-                if (currVertex->d > vertices[newPosition]->d + 1) {
-                    currVertex->d = vertices[newPosition]->d + 1;
+                if (currVertex->d > newVertexSlot->d + 1) {
+                    currVertex->d = newVertexSlot->d + 1;
                     currVertex->pai = getMatchingStep(dir);
                 }
-                auto newVertex = vertices[newPosition];
+                auto newVertex = newVertexSlot;
                 // Update neighbors list for both vertices
                 if (std::find(currVertex->neighbors.begin(), currVertex->neighbors.end(), newPosition) ==
                     currVertex->neighbors.end()) {
@@ -160,21 +226,19 @@ void Algorithm_206448649_314939398_B::relax() {
                 currVertex->neighbors.push_back(newPosition);
                 newVertex->neighbors.push_back(currVertex->position);
                 dirtyPos[newVertex->position] = newVertex->vertexDirtLevel; // newVertex->vertexDirtLevel = MAX_INT
-                vertices[newPosition] = std::move(newVertex);
+                newVertexSlot = std::move(newVertex);
             }
         }
     }
 }
 
 Step Algorithm_206448649_314939398_B::chooseNeighbor() {
-    std::vector<Direction> directions = {Direction::North, Direction::East, Direction::South, Direction::West};
+    std::array<Direction, 4> directions = {Direction::North, Direction::East, Direction::South, Direction::West};
 
-    // Create a random number generator
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::default_random_engine generator(seed);
-
-    // Shuffle the directions
-    std::shuffle(directions.begin(), directions.end(), generator);
+    // Shuffle the directions (Fisher-Yates with the instance generator)
+    for (std::uint32_t i = directions.size() - 1; i > 0; i--) {
+        std::swap(directions[i], directions[rng.below(i + 1)]);
+    }
 
     Direction direction;
     int maxDirtLevel = -1;
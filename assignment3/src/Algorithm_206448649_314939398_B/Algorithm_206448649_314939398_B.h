@@ -2,6 +2,8 @@
 #define ASSIGNMENT3_ALGORITHM_206448649_314939398_B_H
 
 #include "utils.h"
+#include "Grid.h"
+#include "Random.h"
 #include "enums.h"
 #include "DirtSensor.h"
 #include "WallSensor.h"
@@ -9,10 +11,13 @@
 #include "AbstractAlgorithm.h"
 #include "AlgorithmRegistrar.h"
 #include "AlgorithmRegistration.h"
+#include "AlgorithmExtensions.h"
+#include "AlgorithmState.h"
 
 #include <deque>
 
-class Algorithm_206448649_314939398_B : public AbstractAlgorithm {
+class Algorithm_206448649_314939398_B : public AbstractAlgorithm, public GridLayoutAwareAlgorithm,
+                                        public SeedableAlgorithm, public SerializableAlgorithm {
 public:
     Algorithm_206448649_314939398_B();
 
@@ -21,18 +26,23 @@ public:
     void setDirtSensor(const DirtSensor& dirtSensor) override;
     void setBatteryMeter(const BatteryMeter& batteryMeter) override;
     Step nextStep() override;
+    void setGridLayout(GridLayout layout) override;
+    std::string saveState() const override;
+    void loadState(const std::string& state) override;
+    void setSeed(std::uint64_t seed) override;
 
 private:
+    friend struct AlgorithmBenchAccess; // bench/AlgorithmBench.cpp
     size_t maxSteps;
     const WallsSensor* wallsSensor;
     const DirtSensor* dirtSensor;
     const BatteryMeter* batteryMeter;
     size_t maxBatterySteps;
     bool firstStep = true;
-    int totalSteps;
+    size_t totalSteps;
     std::deque<Step> tripStepsLog;
-    std::unordered_map<std::pair<int, int>, std::shared_ptr<Vertex>, VertexHash> vertices;
-    std::unordered_map<std::pair<int, int>, int, VertexHash> dirtyPos;
+    TiledMap<std::shared_ptr<Vertex>> vertices;
+    TiledMap<int> dirtyPos;
     std::pair<int, int> dockingStation;
     std::pair<int, int> currPosition;
     std::pair<int, int> prevPosition;
@@ -40,6 +50,7 @@ private:
     bool returnToDockingStation = false;
     bool followPathToLastPoint = false;
     std::deque<Step> pathToLastPoint;
+    Xoshiro256 rng; // breaks ties between neighbors, seeded from std::random_device unless setSeed() is called
 
     // private methods:
     Step moveTo(std::pair<int, int> targetPosition);
@@ -0,0 +1,144 @@
+#include "House.h"
+#include "BenchCorpus.h"
+#include "../Algorithm_206448649_314939398_A/Algorithm_206448649_314939398_A.h"
+#include "../Algorithm_206448649_314939398_B/Algorithm_206448649_314939398_B.h"
+#include <benchmark/benchmark.h>
+
+/* The algorithm side of a step, without the simulator: nextStep() on a minimal house that only moves the robot
+ * and cleans, and the private hot paths (relax, findClosestDirtyPoint) once the algorithm explored part of the
+ * house. The private members are reached through AlgorithmBenchAccess, a friend of both algorithms. */
+
+struct AlgorithmBenchAccess {
+    template<typename Algorithm>
+    static void relax(Algorithm &algorithm) { algorithm.relax(); }
+
+    static std::pair<int, int> findClosestDirtyPoint(Algorithm_206448649_314939398_A &algorithm,
+                                                     std::vector<Step> &path) {
+        return algorithm.findClosestDirtyPoint(path);
+    }
+};
+
+namespace {
+
+/* The sensors of a corpus house, with an unlimited battery (always full) */
+class BenchHouse : public WallsSensor, public DirtSensor, public BatteryMeter {
+public:
+    explicit BenchHouse(int size) {
+        if (!readHouse(getCorpusHouse(size), GridLayout::RowMajor, house)) {
+            throw std::runtime_error("Invalid bench house");
+        }
+        position = house.dockingStation;
+    }
+
+    bool isWall(Direction d) const override {
+        auto [row, col] = moveInDirection(position, d);
+        return !house.layout.inBounds(row, col) || house.layout.at(row, col) == 'W';
+    }
+
+    int dirtLevel() const override {
+        char c = house.layout.at(position.first, position.second);
+        return c >= '1' && c <= '9' ? c - '0' : 0;
+    }
+
+    std::size_t getBatteryState() const override { return std::size_t(house.maxBattery); }
+
+    void apply(Step step) {
+        if (step == Step::Stay) {
+            if (dirtLevel() > 0) {
+                house.layout.at(position.first, position.second)--;
+            }
+        } else if (step != Step::Finish) {
+            position = moveInDirection(position, getMatchingDirection(step));
+        }
+    }
+
+    int getMaxSteps() const { return house.maxSteps; }
+
+private:
+    House house;
+    std::pair<int, int> position;
+};
+
+/* an algorithm attached to 'house', seeded if it can be */
+template<typename Algorithm>
+std::unique_ptr<Algorithm> makeAlgorithm(BenchHouse &house, std::size_t maxSteps) {
+    auto algorithm = std::make_unique<Algorithm>();
+    algorithm->setMaxSteps(maxSteps);
+    algorithm->setWallsSensor(house);
+    algorithm->setDirtSensor(house);
+    algorithm->setBatteryMeter(house);
+    if (auto *seedable = dynamic_cast<SeedableAlgorithm *>(algorithm.get())) {
+        seedable->setSeed(0);
+    }
+    return algorithm;
+}
+
+/* runs 'steps' steps (or until the algorithm finishes), so the explored map is no longer trivial */
+template<typename Algorithm>
+void explore(Algorithm &algorithm, BenchHouse &house, int steps) {
+    for (int i = 0; i < steps; i++) {
+        Step step = algorithm.nextStep();
+        if (step == Step::Finish) {
+            return;
+        }
+        house.apply(step);
+    }
+}
+
+// steps taken before measuring relax / findClosestDirtyPoint
+int explorationSteps(int size) {
+    return std::min(size * size, 20000);
+}
+
+template<typename Algorithm>
+void BM_NextStep(benchmark::State &state) {
+    const int size = int(state.range(0));
+    auto house = std::make_unique<BenchHouse>(size);
+    auto algorithm = makeAlgorithm<Algorithm>(*house, std::size_t(house->getMaxSteps()));
+    for (auto _: state) {
+        Step step = algorithm->nextStep();
+        if (step == Step::Finish) {
+            // start over on a clean copy of the house
+            state.PauseTiming();
+            house = std::make_unique<BenchHouse>(size);
+            algorithm = makeAlgorithm<Algorithm>(*house, std::size_t(house->getMaxSteps()));
+            state.ResumeTiming();
+            continue;
+        }
+        house->apply(step);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+
+template<typename Algorithm>
+void BM_Relax(benchmark::State &state) {
+    const int size = int(state.range(0));
+    BenchHouse house(size);
+    auto algorithm = makeAlgorithm<Algorithm>(house, std::size_t(house.getMaxSteps()));
+    explore(*algorithm, house, explorationSteps(size));
+    for (auto _: state) {
+        AlgorithmBenchAccess::relax(*algorithm);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+
+void BM_FindClosestDirtyPoint(benchmark::State &state) {
+    const int size = int(state.range(0));
+    BenchHouse house(size);
+    auto algorithm = makeAlgorithm<Algorithm_206448649_314939398_A>(house, std::size_t(house.getMaxSteps()));
+    explore(*algorithm, house, explorationSteps(size));
+    std::vector<Step> path;
+    for (auto _: state) {
+        path.clear();
+        benchmark::DoNotOptimize(AlgorithmBenchAccess::findClosestDirtyPoint(*algorithm, path));
+    }
+    state.counters["path_length"] = double(path.size());
+}
+
+}
+
+BENCHMARK_TEMPLATE(BM_NextStep, Algorithm_206448649_314939398_A)->Apply(applyCorpusSizes);
+BENCHMARK_TEMPLATE(BM_NextStep, Algorithm_206448649_314939398_B)->Apply(applyCorpusSizes);
+BENCHMARK_TEMPLATE(BM_Relax, Algorithm_206448649_314939398_A)->Apply(applyCorpusSizes);
+BENCHMARK_TEMPLATE(BM_Relax, Algorithm_206448649_314939398_B)->Apply(applyCorpusSizes);
+BENCHMARK(BM_FindClosestDirtyPoint)->Apply(applyCorpusSizes)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,85 @@
+#ifndef ASSIGNMENT3_BENCHCORPUS_H
+#define ASSIGNMENT3_BENCHCORPUS_H
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+/* The synthetic houses of the benchmarks: size x size, random walls (10%) and dirt (40%), the docking station in the
+ * middle. A house is a function of its size and max steps only, so results compare across machines and builds.
+ * The small corpus houses are committed in bench/corpus (BENCH_CORPUS_DIR), the large ones are generated on first
+ * use into the benchmark directory. */
+
+// corpus sizes, from the smallest committed house to the largest generated one
+constexpr int BENCH_CORPUS_SIZES[] = {10, 32, 64, 256, 1024, 4096};
+
+// the largest committed size, the others are generated
+constexpr int BENCH_CORPUS_MAX_COMMITTED = 256;
+
+/* the working directory of the benchmarks (output files are written there) */
+inline const std::filesystem::path &benchDir() {
+    static const std::filesystem::path dir = [] {
+        auto path = std::filesystem::temp_directory_path() / "myrobot_bench";
+        std::filesystem::create_directories(path);
+        // output files are written to the working directory
+        std::filesystem::current_path(path);
+        return path;
+    }();
+    return dir;
+}
+
+inline void writeBenchHouse(const std::filesystem::path &path, int size, int maxSteps) {
+    std::mt19937 generator(size);
+    std::uniform_int_distribution<int> distribution(0, 19);
+    std::ofstream file(path);
+    file << "Bench house " << size << "x" << size << '\n';
+    file << "MaxSteps = " << maxSteps << '\n';
+    file << "MaxBattery = " << 4 * size << '\n';
+    file << "Rows = " << size << '\n';
+    file << "Cols = " << size << '\n';
+    for (int r = 0; r < size; r++) {
+        std::string row(size, ' ');
+        for (int c = 0; c < size; c++) {
+            int cell = distribution(generator);
+            row[c] = cell < 2 ? 'W' : (cell < 10 ? char('0' + cell) : ' ');
+        }
+        if (r == size / 2) {
+            row[size / 2] = 'D';
+        }
+        file << row << '\n';
+    }
+}
+
+/* a house file with the given max steps, generated into the benchmark directory if missing */
+inline std::string makeHouseFile(int size, int maxSteps) {
+    auto path = benchDir() / ("bench_" + std::to_string(size) + "_" + std::to_string(maxSteps) + ".house");
+    if (!std::filesystem::exists(path)) {
+        writeBenchHouse(path, size, maxSteps);
+    }
+    return path.string();
+}
+
+/* max steps of the corpus houses: enough to explore the small ones, capped so a run stays under a second */
+constexpr int benchCorpusMaxSteps(int size) {
+    return size * size * 4 < 100000 ? size * size * 4 : 100000;
+}
+
+/* the corpus house of this size: the committed file, or a generated one for the large sizes */
+inline std::string getCorpusHouse(int size) {
+    std::filesystem::path committed = std::filesystem::path(BENCH_CORPUS_DIR) / ("house_" + std::to_string(size) + ".house");
+    if (size <= BENCH_CORPUS_MAX_COMMITTED && std::filesystem::exists(committed)) {
+        return committed.string();
+    }
+    return makeHouseFile(size, benchCorpusMaxSteps(size));
+}
+
+/* one benchmark argument per corpus size */
+inline void applyCorpusSizes(benchmark::internal::Benchmark *benchmark) {
+    for (int size: BENCH_CORPUS_SIZES) {
+        benchmark->Arg(size);
+    }
+}
+
+#endif //ASSIGNMENT3_BENCHCORPUS_H
@@ -0,0 +1,89 @@
+#include "Grid.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+
+/* Compares the row-major and the Morton (Z-order tiled) layouts of the house grid and of the algorithms'
+ * explored map, on the access pattern of a simulation step: 4 wall checks + a dirt read around the robot.
+ * Cache misses: run with --benchmark_perf_counters=CACHE-MISSES (needs libpfm) or under 'perf stat -e cache-misses'. */
+
+namespace {
+
+// a random walk that moves North/South as often as East/West
+std::vector<Direction> makeWalk(std::size_t length) {
+    std::mt19937 generator(206448649);
+    std::uniform_int_distribution<int> distribution(0, 3);
+    std::vector<Direction> walk(length);
+    for (auto &dir: walk) {
+        dir = Direction(distribution(generator));
+    }
+    return walk;
+}
+
+void fillHouse(Grid<char> &grid, int size, GridLayout layout) {
+    grid.reset(size, size, layout, ' ');
+    std::mt19937 generator(314939398);
+    std::uniform_int_distribution<int> distribution(0, 15);
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            int cell = distribution(generator);
+            grid.at(r, c) = cell == 0 ? 'W' : (cell < 10 ? char('0' + cell) : ' ');
+        }
+    }
+}
+
+void BM_GridWalk(benchmark::State &state, GridLayout layout) {
+    const int size = int(state.range(0));
+    Grid<char> grid;
+    fillHouse(grid, size, layout);
+    const auto walk = makeWalk(1 << 20);
+    const int rowStep[] = {-1, 0, 1, 0};
+    const int colStep[] = {0, 1, 0, -1};
+
+    // long strides (a robot crossing a big house) so the walk leaves the cache every few steps
+    const int stride = std::max(1, size / 64);
+    int row = size / 2, col = size / 2;
+    std::size_t i = 0;
+    for (auto _: state) {
+        Direction dir = walk[i++ & (walk.size() - 1)];
+        int walls = 0;
+        for (int d = 0; d < 4; d++) {
+            int r = row + rowStep[d], c = col + colStep[d];
+            walls += !grid.inBounds(r, c) || grid.at(r, c) == 'W';
+        }
+        char dirt = grid.at(row, col);
+        benchmark::DoNotOptimize(walls);
+        benchmark::DoNotOptimize(dirt);
+        row = std::clamp(row + rowStep[int(dir)] * stride, 0, size - 1);
+        col = std::clamp(col + colStep[int(dir)] * stride, 0, size - 1);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+    state.SetLabel(getGridLayoutName(layout));
+}
+
+void BM_ExploredMapWalk(benchmark::State &state, GridLayout layout) {
+    TiledMap<int> map(layout);
+    const auto walk = makeWalk(1 << 20);
+    const int rowStep[] = {-1, 0, 1, 0};
+    const int colStep[] = {0, 1, 0, -1};
+
+    std::pair<int, int> position{0, 0};
+    std::size_t i = 0;
+    for (auto _: state) {
+        Direction dir = walk[i++ & (walk.size() - 1)];
+        for (int d = 0; d < 4; d++) {
+            benchmark::DoNotOptimize(map[{position.first + rowStep[d], position.second + colStep[d]}]);
+        }
+        map[position]++;
+        position = {position.first + rowStep[int(dir)], position.second + colStep[int(dir)]};
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+    state.SetLabel(getGridLayoutName(layout));
+}
+
+}
+
+BENCHMARK_CAPTURE(BM_GridWalk, row_major, GridLayout::RowMajor)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_GridWalk, morton, GridLayout::Morton)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_ExploredMapWalk, row_major, GridLayout::RowMajor);
+BENCHMARK_CAPTURE(BM_ExploredMapWalk, morton, GridLayout::Morton);
@@ -0,0 +1,36 @@
+#include "Simulator.h"
+#include "BenchCorpus.h"
+#include <benchmark/benchmark.h>
+
+/* The simulator side of a step: the sensor calls an algorithm makes (isWall x4 + dirtLevel around the robot),
+ * and parsing a house file (readHouseFile), on every corpus house. */
+
+namespace {
+
+void BM_SensorReads(benchmark::State &state) {
+    Simulator simulator;
+    simulator.readHouseFile(getCorpusHouse(int(state.range(0))));
+    for (auto _: state) {
+        int walls = 0;
+        for (Direction dir: {Direction::North, Direction::East, Direction::South, Direction::West}) {
+            walls += simulator.isWall(dir);
+        }
+        benchmark::DoNotOptimize(walls);
+        benchmark::DoNotOptimize(simulator.dirtLevel());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+
+void BM_ReadHouseFile(benchmark::State &state) {
+    const std::string houseFile = getCorpusHouse(int(state.range(0)));
+    Simulator simulator;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(simulator.readHouseFile(houseFile));
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(std::filesystem::file_size(houseFile)));
+}
+
+}
+
+BENCHMARK(BM_SensorReads)->Apply(applyCorpusSizes);
+BENCHMARK(BM_ReadHouseFile)->Apply(applyCorpusSizes)->Unit(benchmark::kMillisecond);
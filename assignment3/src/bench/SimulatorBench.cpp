@@ -0,0 +1,56 @@
+#include "Simulator.h"
+#include "BenchCorpus.h"
+#include <benchmark/benchmark.h>
+
+/* Throughput of a whole Simulator::run():
+ * - per simulation policy: the same house and algorithm, with the full step log + output file (FullOutputPolicy)
+ *   and in summary-only mode (SummaryOnlyPolicy)
+ * - per algorithm, end to end on every corpus house (summary-only) */
+
+namespace {
+
+template<typename Policy>
+void BM_SimulatorRun(benchmark::State &state) {
+    const std::string houseFile = makeHouseFile(int(state.range(0)), int(state.range(1)));
+    int64_t steps = 0;
+    for (auto _: state) {
+        state.PauseTiming();
+        Simulator simulator;
+        simulator.readHouseFile(houseFile);
+        simulator.setAlgorithm(std::make_unique<Algorithm_206448649_314939398_A>());
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(simulator.run<Policy>());
+        steps += simulator.getTotalSteps();
+    }
+    state.counters["steps_per_second"] = benchmark::Counter(double(steps), benchmark::Counter::kIsRate);
+}
+
+template<typename Algorithm>
+void BM_SimulatorRunCorpus(benchmark::State &state) {
+    const std::string houseFile = getCorpusHouse(int(state.range(0)));
+    int64_t steps = 0;
+    for (auto _: state) {
+        state.PauseTiming();
+        Simulator simulator;
+        simulator.readHouseFile(houseFile);
+        simulator.setAlgorithm(std::make_unique<Algorithm>());
+        simulator.setSeed(0); // B breaks ties at random, every iteration runs the same walk
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(simulator.run<SummaryOnlyPolicy>());
+        steps += simulator.getTotalSteps();
+    }
+    state.counters["steps_per_second"] = benchmark::Counter(double(steps), benchmark::Counter::kIsRate);
+}
+
+}
+
+BENCHMARK_TEMPLATE(BM_SimulatorRun, FullOutputPolicy)->Args({64, 20000})->Args({256, 200000})
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SimulatorRun, SummaryOnlyPolicy)->Args({64, 20000})->Args({256, 200000})
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SimulatorRunCorpus, Algorithm_206448649_314939398_A)->Apply(applyCorpusSizes)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SimulatorRunCorpus, Algorithm_206448649_314939398_B)->Apply(applyCorpusSizes)
+        ->Unit(benchmark::kMillisecond);
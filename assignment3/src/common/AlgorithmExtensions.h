@@ -0,0 +1,35 @@
+#ifndef ALGORITHM_EXTENSIONS_H_
+#define ALGORITHM_EXTENSIONS_H_
+
+#include "enums.h"
+#include <cstdint>
+#include <string>
+
+/* Optional interfaces an algorithm may implement on top of AbstractAlgorithm.
+ * The simulator detects them with dynamic_cast, algorithms that don't implement them keep working as is. */
+
+class GridLayoutAwareAlgorithm {
+public:
+	virtual ~GridLayoutAwareAlgorithm() {}
+	// called once per house, before the first nextStep(), with the layout the simulator selected for the house grid
+	virtual void setGridLayout(GridLayout layout) = 0;
+};
+
+class SeedableAlgorithm {
+public:
+	virtual ~SeedableAlgorithm() {}
+	// called before the first nextStep(). The same seed on the same house must give the same run
+	virtual void setSeed(std::uint64_t seed) = 0;
+};
+
+class SerializableAlgorithm {
+public:
+	virtual ~SerializableAlgorithm() {}
+	// the whole state of the run so far (explored map, position, plans...), in a format of the algorithm's choice
+	virtual std::string saveState() const = 0;
+	// continues the run saved by saveState(), on a new instance that got its setters (and setGridLayout) but no
+	// nextStep() call yet. Throws std::runtime_error if 'state' is not a state of this algorithm
+	virtual void loadState(const std::string &state) = 0;
+};
+
+#endif  // ALGORITHM_EXTENSIONS_H_
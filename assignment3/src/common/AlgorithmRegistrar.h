@@ -6,6 +6,8 @@
 #include <vector>
 #include <functional>
 #include <iostream>
+#include <mutex>
+#include <utility>
 
 #include "AbstractAlgorithm.h"
 
@@ -18,6 +20,7 @@ class AlgorithmRegistrar {
     class AlgorithmFactoryPair {
         std::string name_;
         AlgorithmFactory algorithmFactory_;
+        friend class AlgorithmRegistrar;
     public:
         AlgorithmFactoryPair(const std::string &name, AlgorithmFactory algorithmFactory)
                 : name_(name), algorithmFactory_(std::move(algorithmFactory)) {}
@@ -28,6 +31,7 @@ class AlgorithmRegistrar {
     };
 
     std::vector<AlgorithmFactoryPair> algorithms;
+    mutable std::mutex mutex;
 
     // Static pointer to the singleton instance
     static AlgorithmRegistrar* instance;
@@ -42,18 +46,38 @@ public:
     }
 
     void registerAlgorithm(const std::string &name, AlgorithmFactory algorithmFactory) {
+        std::lock_guard<std::mutex> lock(mutex);
         algorithms.emplace_back(name, std::move(algorithmFactory));
     }
 
+    // begin() / end() are not thread safe: iterate only while no library is being loaded
     auto begin() const { return algorithms.begin(); }
 
     auto end() const { return algorithms.end(); }
 
     std::size_t count() const {
+        std::lock_guard<std::mutex> lock(mutex);
         return algorithms.size();
     }
 
-    void clear() { algorithms.clear(); }
+    // Removes the algorithms registered from index 'first' on and returns their names and factories,
+    // e.g. to move the algorithms of a library just loaded to a registry that tracks their versions
+    std::vector<std::pair<std::string, AlgorithmFactory>> takeFrom(std::size_t first) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::pair<std::string, AlgorithmFactory>> taken;
+        for (std::size_t i = first; i < algorithms.size(); i++) {
+            taken.emplace_back(algorithms[i].name(), std::move(algorithms[i].algorithmFactory_));
+        }
+        if (first < algorithms.size()) {
+            algorithms.erase(algorithms.begin() + std::ptrdiff_t(first), algorithms.end());
+        }
+        return taken;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        algorithms.clear();
+    }
 };
 
 #endif  // ALGO_REGISTRAR__
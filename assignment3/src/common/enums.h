@@ -3,5 +3,6 @@
 
 enum class Direction { North, East, South, West };
 enum class Step { North, East, South, West, Stay, Finish };
+enum class GridLayout { RowMajor, Morton };
 
 #endif  // ROBOT_ENUMS_H_
@@ -0,0 +1,173 @@
+#include "AlgorithmRegistry.h"
+#include "AlgorithmExtensions.h"
+#include "ResultCache.h"
+#include "utils.h"
+#include <link.h>
+#include <unistd.h>
+
+AlgorithmLibrary::~AlgorithmLibrary() {
+    if (handle) {
+        dlclose(handle);
+    }
+}
+
+void AlgorithmLibrary::keepMapped() const {
+    link_map *map = nullptr;
+    if (handle && dlinfo(handle, RTLD_DI_LINKMAP, &map) == 0) {
+        // a reference that is never closed, to the mapping already loaded (the private copy is removed)
+        dlopen(map->l_name, RTLD_LAZY | RTLD_NOLOAD | RTLD_NODELETE);
+    }
+}
+
+void AlgorithmRegistry::loadDirectory(const std::filesystem::path &dirPath, bool hashContent) {
+    // Drop whatever was registered before (e.g. by statically linked algorithms)
+    AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+
+    // Iterate over dirPath to find .so files and load them
+    for (const auto &entry: std::filesystem::directory_iterator(dirPath)) {
+        if (entry.is_regular_file() &&
+            (entry.path().extension() == ".so" || entry.path().extension() == ".dylib")) {
+            loadLibrary(entry.path(), hashContent);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (files.empty()) {
+        throw std::runtime_error("Cannot find .so files in " + std::filesystem::current_path().string());
+    }
+    // The algorithm ids are sorted by name (the summary rows order)
+    std::sort(current.begin(), current.end(),
+              [](const auto &a, const auto &b) { return a->name < b->name; });
+}
+
+std::size_t AlgorithmRegistry::loadLibrary(const std::filesystem::path &path, bool hashContent) {
+    std::lock_guard<std::mutex> loadLock(loadMutex);
+    AlgorithmRegistrar &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    const std::size_t first = registrar.count();
+
+    // Read the file state before opening it, so a build installed meanwhile is seen as a change by the next reload
+    std::error_code ec;
+    LoadedFile file{path, std::filesystem::last_write_time(path, ec), std::filesystem::file_size(path, ec)};
+
+    void *handle = openPrivateCopy(path);
+    if (!handle) {
+        registrar.takeFrom(first);
+        return 0;
+    }
+    auto library = std::make_shared<AlgorithmLibrary>(handle, path);
+    // Every algorithm registered while loading this library (the new registrar entries) comes from it.
+    // Declared after 'library', so the factories are destroyed while the library is still loaded
+    auto registrations = registrar.takeFrom(first);
+    const std::uint64_t libraryHash = hashContent ? ResultCache::hashFile(path) : 0;
+
+    std::size_t registered = 0;
+    for (auto &[name, factory]: registrations) {
+        auto version = std::make_shared<AlgorithmVersion>();
+        {
+            // Check if the algorithm creation fails (returns nullptr)
+            std::unique_ptr<AbstractAlgorithm> probe = factory ? factory() : nullptr;
+            if (!probe) {
+                writeError(name + ".error", "Algorithm Factory returned a nulptr for: " + name);
+                continue;
+            }
+            version->seedable = dynamic_cast<SeedableAlgorithm *>(probe.get()) != nullptr;
+        }
+        version->library = library;
+        version->name = name;
+        version->factory = std::move(factory);
+        version->contentHash = ResultCache::hashBytes(name.data(), name.size(), libraryHash);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = std::find_if(current.begin(), current.end(),
+                               [&name](const auto &algorithm) { return algorithm->name == name; });
+        if (it == current.end()) {
+            current.push_back(std::move(version));
+        } else if ((*it)->library->getPath() == path) {
+            // A new build: tasks already holding the old version finish on it
+            version->version = (*it)->version + 1;
+            *it = std::move(version);
+        } else {
+            continue; // the same name from another library, the first one loaded is kept
+        }
+        registered++;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(files.begin(), files.end(),
+                           [&path](const LoadedFile &loaded) { return loaded.path == path; });
+    if (it == files.end()) {
+        files.push_back(file);
+    } else {
+        *it = file;
+    }
+    return registered;
+}
+
+std::size_t AlgorithmRegistry::reloadChangedLibraries(bool hashContent) {
+    std::vector<std::filesystem::path> changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &file: files) {
+            std::error_code ec;
+            auto writeTime = std::filesystem::last_write_time(file.path, ec);
+            if (ec) {
+                continue; // removed: the current version stays
+            }
+            auto size = std::filesystem::file_size(file.path, ec);
+            if (!ec && (writeTime != file.writeTime || size != file.size)) {
+                changed.push_back(file.path);
+            }
+        }
+    }
+    for (const auto &path: changed) {
+        loadLibrary(path, hashContent);
+    }
+    return changed.size();
+}
+
+std::shared_ptr<const AlgorithmVersion> AlgorithmRegistry::get(std::size_t algoId) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current[algoId];
+}
+
+std::size_t AlgorithmRegistry::count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current.size();
+}
+
+std::vector<std::string> AlgorithmRegistry::getNames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> names;
+    for (const auto &algorithm: current) {
+        names.push_back(algorithm->name);
+    }
+    return names;
+}
+
+void AlgorithmRegistry::pinAfterTimeout(std::shared_ptr<const AlgorithmVersion> version) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::find(pinnedAfterTimeout.begin(), pinnedAfterTimeout.end(), version) == pinnedAfterTimeout.end()) {
+        pinnedAfterTimeout.push_back(std::move(version));
+    }
+}
+
+void *AlgorithmRegistry::openPrivateCopy(const std::filesystem::path &path) {
+    std::string errorFileName = path.stem().string() + ".error";
+    auto copy = std::filesystem::temp_directory_path() /
+                ("myrobot_" + std::to_string(getpid()) + "_" + std::to_string(++loadCounter) + "_" +
+                 path.filename().string());
+    std::error_code ec;
+    std::filesystem::copy_file(path, copy, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+        writeError(errorFileName, "Failed to copy algorithm file: " + path.string() + "\n" + ec.message());
+        return nullptr;
+    }
+    void *handle = dlopen(copy.c_str(), RTLD_LAZY);
+    std::string error = handle ? "" : dlerror();
+    // The library stays mapped, the copy is not needed anymore
+    std::filesystem::remove(copy, ec);
+    if (!handle) {
+        writeError(errorFileName, "Failed to open algorithm file: " + path.string() + "\ndlerror: " + error);
+    }
+    return handle;
+}
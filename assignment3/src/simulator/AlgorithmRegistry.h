@@ -0,0 +1,100 @@
+#ifndef ASSIGNMENT3_ALGORITHMREGISTRY_H
+#define ASSIGNMENT3_ALGORITHMREGISTRY_H
+
+#include "AlgorithmRegistrar.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* A dlopen handle, closed when the last AlgorithmVersion (and so the last task) using the library is gone */
+class AlgorithmLibrary {
+public:
+    AlgorithmLibrary(void *handle, std::filesystem::path path) : handle(handle), path(std::move(path)) {}
+
+    ~AlgorithmLibrary();
+
+    AlgorithmLibrary(const AlgorithmLibrary &) = delete;
+
+    AlgorithmLibrary &operator=(const AlgorithmLibrary &) = delete;
+
+    const std::filesystem::path &getPath() const { return path; }
+
+    /* the library is never unmapped, even once closed: for the code of a thread that is left running at exit */
+    void keepMapped() const;
+
+private:
+    void *handle;
+    std::filesystem::path path; // the file in the algorithms directory (not the private copy that was opened)
+};
+
+/* One loaded build of a registered algorithm. Immutable, shared by the tasks that run it */
+struct AlgorithmVersion {
+    // first member, so it is destroyed last: 'factory' and the algorithms it creates live in the library code
+    std::shared_ptr<AlgorithmLibrary> library;
+    std::string name;
+    AlgorithmFactory factory;
+    std::uint64_t contentHash = 0; // hash of the library file and of the name (result cache key part)
+    std::uint32_t version = 1; // 1 for the first load, incremented by every reload
+    bool seedable = false; // implements SeedableAlgorithm
+};
+
+/* Versioned, thread-safe registry of the algorithms of the loaded libraries, by dense algorithm id.
+ * A library is (re)loaded from a private copy of its file, so a new build of an already loaded file is really
+ * loaded again (dlopen would return the old handle for the same file). The algorithms it registers replace
+ * the current versions of the same names:
+ * - tasks take the current version with get() and keep it until they are done, so in-flight tasks finish
+ *   on the old build while the next tasks start on the new one;
+ * - once the last task of the old version is done, the old library is dlclosed.
+ * The ids of the algorithms never change, a reload that registers a new name appends an id.
+ * The versions of the runs cancelled by a timeout are pinned instead (see pinAfterTimeout()): their algorithm may
+ * still be unwinding in the library code, so these libraries are only closed with the registry, at shutdown. */
+class AlgorithmRegistry {
+public:
+    AlgorithmRegistry() = default;
+
+    AlgorithmRegistry(const AlgorithmRegistry &) = delete;
+
+    AlgorithmRegistry &operator=(const AlgorithmRegistry &) = delete;
+
+    /* loads every library of 'dirPath', the ids are then sorted by algorithm name. Throws if there is none */
+    void loadDirectory(const std::filesystem::path &dirPath, bool hashContent);
+
+    /* loads or reloads the library 'path'. Returns the number of algorithms it registered
+     * (0 if it failed to load: the .error file is written) */
+    std::size_t loadLibrary(const std::filesystem::path &path, bool hashContent);
+
+    /* reloads the loaded libraries whose file changed (modification time or size) since they were loaded,
+     * returns the number of reloaded libraries */
+    std::size_t reloadChangedLibraries(bool hashContent);
+
+    /* the current version of an algorithm, kept alive for as long as the caller holds it */
+    std::shared_ptr<const AlgorithmVersion> get(std::size_t algoId) const;
+
+    std::size_t count() const;
+
+    std::vector<std::string> getNames() const;
+
+    /* keeps 'version' and its library loaded until the registry is destroyed (a version is pinned once) */
+    void pinAfterTimeout(std::shared_ptr<const AlgorithmVersion> version);
+
+private:
+    struct LoadedFile {
+        std::filesystem::path path;
+        std::filesystem::file_time_type writeTime;
+        std::uintmax_t size;
+    };
+
+    mutable std::mutex mutex; // guards 'current', 'files' and 'pinnedAfterTimeout'
+    std::mutex loadMutex; // one load at a time: the registrations of a library are the registrar entries it adds
+    std::vector<std::shared_ptr<const AlgorithmVersion>> current; // by algorithm id
+    std::vector<LoadedFile> files;
+    std::vector<std::shared_ptr<const AlgorithmVersion>> pinnedAfterTimeout; // guarded by 'mutex'
+    std::uint64_t loadCounter = 0; // names the private copies
+
+    void *openPrivateCopy(const std::filesystem::path &path);
+};
+
+#endif //ASSIGNMENT3_ALGORITHMREGISTRY_H
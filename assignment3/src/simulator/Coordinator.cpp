@@ -0,0 +1,252 @@
+#include "Coordinator.h"
+
+namespace {
+
+// how long a worker waits before asking again when every run is leased
+constexpr int WAIT_MS = 200;
+
+std::vector<std::string> splitFields(const std::string &line) {
+    std::vector<std::string> fields;
+    std::istringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, '\t')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+}
+
+Coordinator::Coordinator(Runner &runner, std::string address, int leaseMs)
+        : runner(runner), address(std::move(address)), leaseMs(leaseMs), houseNames(runner.getHouseNames()),
+          algoNames(runner.getAlgorithmNames()) {}
+
+JobResults Coordinator::run(const Job &job, const Runner::RecordCallback &onRecord) {
+    JobResults jobResults;
+    const std::size_t numOfRuns = std::max(job.numOfSeeds, 1);
+    jobResults.results.reset(job.houseIds.size(), job.algoIds.size(), numOfRuns);
+
+    // The houses are validated here (a job without algorithms), only the runs of the valid ones are handed out
+    Job validation;
+    validation.houseIds = job.houseIds;
+    runner.run(validation, nullptr);
+    for (std::size_t h = 0; h < job.houseIds.size(); h++) {
+        jobResults.validHouses.push_back(runner.isHouseValid(job.houseIds[h]));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->job = &job;
+        this->onRecord = &onRecord;
+        results = &jobResults.results;
+        tasks.clear();
+        pending.clear();
+        leases.clear();
+        numOfDone = 0;
+        for (std::size_t h = 0; h < job.houseIds.size(); h++) {
+            if (!jobResults.validHouses[h]) {
+                continue;
+            }
+            for (std::size_t a = 0; a < job.algoIds.size(); a++) {
+                const bool seeded = job.numOfSeeds > 0 && runner.isAlgorithmSeedable(job.algoIds[a]);
+                for (std::size_t run = 0; run < (seeded ? numOfRuns : 1); run++) {
+                    // only the first seed of a pair writes the output file, as in a local run
+                    tasks.push_back({h, a, run, seeded ? run : NO_SEED, !job.summaryOnly && run == 0});
+                    pending.push_back(tasks.size() - 1);
+                }
+            }
+        }
+    }
+
+    if (!isJobDone()) {
+        StreamSocket listener = StreamSocket::listen(address);
+        std::cout << "Coordinating " << tasks.size() << " runs on " << address << std::endl;
+        // One thread per worker connection. The sockets are kept (and not moved) while their threads use them
+        std::vector<std::unique_ptr<StreamSocket>> connections;
+        std::vector<std::thread> threads;
+        while (!isJobDone()) {
+            StreamSocket connection = listener.accept(WAIT_MS);
+            if (connection.valid()) {
+                connections.push_back(std::make_unique<StreamSocket>(std::move(connection)));
+                threads.emplace_back(&Coordinator::serveConnection, this, std::ref(*connections.back()),
+                                     connections.size() - 1);
+            }
+            // Leases also expire while no worker asks for a task (e.g. every worker is stuck)
+            releaseLeases();
+        }
+        listener.close();
+        std::string unixPath = StreamSocket::getUnixPath(address);
+        if (!unixPath.empty()) {
+            std::filesystem::remove(unixPath);
+        }
+        // The workers that are still connected see the connection close, and exit
+        for (auto &connection: connections) {
+            connection->shutdown();
+        }
+        for (auto &t: threads) {
+            t.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    this->job = nullptr;
+    this->onRecord = nullptr;
+    results = nullptr;
+    return jobResults;
+}
+
+void Coordinator::serveConnection(StreamSocket &connection, std::size_t connectionId) {
+    std::string request;
+    while (connection.readLine(request)) {
+        std::string response;
+        try {
+            response = handleRequest(request, connectionId);
+        } catch (const std::exception &e) {
+            response = std::string("error\t") + e.what();
+        }
+        if (!connection.writeAll(response + "\n")) {
+            break;
+        }
+    }
+    // The runs this worker was leased go to the other workers
+    releaseLeases(connectionId);
+}
+
+std::string Coordinator::handleRequest(const std::string &request, std::size_t connectionId) {
+    std::vector<std::string> fields = splitFields(request);
+    if (fields.empty()) {
+        throw std::runtime_error("Empty request");
+    }
+    const std::string &command = fields[0];
+    if (command == "next") {
+        releaseLeases();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (numOfDone == tasks.size()) {
+            return "done";
+        }
+        return leaseTask(connectionId);
+    }
+
+    std::size_t taskId = fields.size() > 1 ? std::stoul(fields[1]) : tasks.size();
+    // the memory of the run (peak bytes, allocations) follows if the worker tracks it
+    if (command == "result" && (fields.size() == 7 || fields.size() == 9)) {
+        RunRecord record;
+        record.score = std::stoll(fields[2]);
+        record.status = parseRunStatus(fields[3]);
+        record.steps = std::stoll(fields[4]);
+        record.dirtLeft = std::stoll(fields[5]);
+        record.wallTimeUs = std::stoull(fields[6]);
+        if (fields.size() == 9) {
+            record.peakBytes = std::stoull(fields[7]);
+            record.allocations = std::stoull(fields[8]);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (taskId >= tasks.size()) {
+            throw std::runtime_error("Unknown task: " + fields[1]);
+        }
+        // The first result wins: a run leased again after its lease expired may be reported twice
+        if (tasks[taskId].state != TaskState::Done) {
+            completeTask(taskId, record);
+        }
+        return "ok";
+    }
+    if (command == "fail" && fields.size() >= 2) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (taskId >= tasks.size()) {
+            throw std::runtime_error("Unknown task: " + fields[1]);
+        }
+        const Task &task = tasks[taskId];
+        if (task.state == TaskState::Leased && task.connection == connectionId) {
+            releaseTask(taskId, fields.size() > 2 ? fields[2] : "failed");
+        }
+        return "ok";
+    }
+    throw std::runtime_error("Invalid request: " + request);
+}
+
+std::string Coordinator::leaseTask(std::size_t connectionId) {
+    while (!pending.empty()) {
+        std::size_t taskId = pending.front();
+        pending.pop_front();
+        Task &task = tasks[taskId];
+        if (task.state != TaskState::Pending) {
+            continue; // a late result completed it while it was queued again
+        }
+        std::size_t houseId = job->houseIds[task.houseIndex];
+        task.state = TaskState::Leased;
+        task.attempts++;
+        task.connection = connectionId;
+        task.deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(leaseMs + 2 * std::int64_t(runner.getHouse(houseId).maxSteps));
+        leases.emplace(task.deadline, taskId);
+
+        std::ostringstream response;
+        response << "task\t" << taskId << '\t' << houseNames[houseId] << '\t'
+                 << algoNames[job->algoIds[task.algoIndex]] << '\t';
+        if (task.seed == NO_SEED) {
+            response << '-';
+        } else {
+            response << task.seed;
+        }
+        response << '\t' << (task.writeOutput ? 1 : 0);
+        return response.str();
+    }
+    return "wait\t" + std::to_string(WAIT_MS);
+}
+
+void Coordinator::completeTask(std::size_t taskId, RunRecord record) {
+    Task &task = tasks[taskId];
+    if (task.state == TaskState::Leased) {
+        leases.erase({task.deadline, taskId});
+    }
+    task.state = TaskState::Done;
+    numOfDone++;
+    record.houseId = std::uint32_t(job->houseIds[task.houseIndex]);
+    record.algoId = std::uint32_t(job->algoIds[task.algoIndex]);
+    record.seed = task.seed;
+    results->setScore(task.houseIndex, task.algoIndex, record.score, task.run);
+    if (*onRecord) {
+        (*onRecord)(record);
+    }
+}
+
+void Coordinator::releaseTask(std::size_t taskId, const std::string &reason) {
+    Task &task = tasks[taskId];
+    leases.erase({task.deadline, taskId});
+    std::string run = houseNames[job->houseIds[task.houseIndex]] + " x " + algoNames[job->algoIds[task.algoIndex]];
+    if (task.attempts >= MAX_ATTEMPTS) {
+        std::cerr << "Giving up on " << run << " after " << task.attempts << " attempts: " << reason << std::endl;
+        RunRecord record;
+        record.score = ResultsMatrix::NO_SCORE;
+        record.status = RunStatus::Error;
+        completeTask(taskId, record);
+        return;
+    }
+    std::cerr << "Retrying " << run << ": " << reason << std::endl;
+    task.state = TaskState::Pending;
+    pending.push_back(taskId);
+}
+
+void Coordinator::releaseLeases(std::optional<std::size_t> closedConnection) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+    while (!leases.empty() && leases.begin()->first < now) {
+        releaseTask(leases.begin()->second, "lease expired");
+    }
+    if (closedConnection) {
+        std::vector<std::size_t> held;
+        for (const auto &[deadline, taskId]: leases) {
+            if (tasks[taskId].connection == *closedConnection) {
+                held.push_back(taskId);
+            }
+        }
+        for (std::size_t taskId: held) {
+            releaseTask(taskId, "worker disconnected");
+        }
+    }
+}
+
+bool Coordinator::isJobDone() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numOfDone == tasks.size();
+}
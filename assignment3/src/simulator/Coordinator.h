@@ -0,0 +1,80 @@
+#ifndef ASSIGNMENT3_COORDINATOR_H
+#define ASSIGNMENT3_COORDINATOR_H
+
+#include "Runner.h"
+#include "Socket.h"
+#include <deque>
+#include <optional>
+
+/* Runs a job on worker processes (see WorkerClient), possibly on other machines, instead of local threads.
+ * The coordinator validates the houses itself, listens on a socket (see StreamSocket for the addresses) and leases
+ * the runs of the job to the worker connections, one at a time. Every connection is a request / response dialog of
+ * tab separated lines, houses and algorithms are named as in the output files (workers may list them in another order):
+ * - next                                     -> "task <id> <house> <algorithm> <seed or -> <write output 0/1>",
+ *                                               "wait <ms>" (every run is leased, ask again later) or "done"
+ * - result <id> <score> <status> <steps> <dirt left> <wall time us> [<peak bytes> <allocations>]  -> "ok"
+ * - fail <id> <message>                      -> "ok", the worker cannot run the task (unknown house / algorithm)
+ * A lease expires after leaseMs plus twice the max steps of the house (the simulation timeout is max steps ms), and
+ * the leases of a connection that closes expire at once: the run goes back to the queue, up to MAX_ATTEMPTS times,
+ * then it is recorded as an Error. A run whose result arrives after it was leased again keeps the first result. */
+class Coordinator {
+public:
+    static constexpr int MAX_ATTEMPTS = 3;
+
+    Coordinator(Runner &runner, std::string address, int leaseMs);
+
+    /* same as Runner::run: returns once every run of the job has a result, calls 'onRecord' for each of them */
+    JobResults run(const Job &job, const Runner::RecordCallback &onRecord);
+
+private:
+    enum class TaskState : std::uint8_t { Pending, Leased, Done };
+
+    struct Task {
+        std::size_t houseIndex; // positions in job.houseIds / job.algoIds
+        std::size_t algoIndex;
+        std::size_t run;
+        std::uint64_t seed;
+        bool writeOutput;
+        TaskState state = TaskState::Pending;
+        int attempts = 0;
+        std::size_t connection = 0; // holder of the lease
+        std::chrono::steady_clock::time_point deadline{}; // of the lease, set when it is handed out
+    };
+
+    Runner &runner;
+    std::string address;
+    int leaseMs;
+
+    // the state of the current job, shared by the connection threads
+    std::mutex mutex;
+    const Job *job = nullptr;
+    const Runner::RecordCallback *onRecord = nullptr;
+    ResultsMatrix *results = nullptr;
+    std::vector<Task> tasks;
+    std::deque<std::size_t> pending;
+    std::set<std::pair<std::chrono::steady_clock::time_point, std::size_t>> leases; // (deadline, task id)
+    std::size_t numOfDone = 0;
+    std::vector<std::string> houseNames;
+    std::vector<std::string> algoNames;
+
+    void serveConnection(StreamSocket &connection, std::size_t connectionId);
+
+    /* 'request' is a tab separated line, returns the response line */
+    std::string handleRequest(const std::string &request, std::size_t connectionId);
+
+    /* lease the next pending task to 'connectionId', the mutex is held */
+    std::string leaseTask(std::size_t connectionId);
+
+    /* the mutex is held */
+    void completeTask(std::size_t taskId, RunRecord record);
+
+    /* puts a leased task back in the queue (or records it as an Error after MAX_ATTEMPTS), the mutex is held */
+    void releaseTask(std::size_t taskId, const std::string &reason);
+
+    /* releases the expired leases, and every lease of 'closedConnection' if given. Takes the mutex */
+    void releaseLeases(std::optional<std::size_t> closedConnection = std::nullopt);
+
+    bool isJobDone();
+};
+
+#endif //ASSIGNMENT3_COORDINATOR_H
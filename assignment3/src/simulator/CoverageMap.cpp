@@ -0,0 +1,64 @@
+#include "CoverageMap.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+
+constexpr std::uint8_t WALL = 0x80;
+
+}
+
+void CoverageMap::reset(const Grid<char> &layout, std::pair<int, int> dock, long long maxSteps,
+                        long long initialDirt) {
+    rows = layout.getRows();
+    cols = layout.getCols();
+    visits.assign(std::size_t(rows) * cols, 0);
+    cleans.resize(visits.size());
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            cleans[std::size_t(r) * cols + c] = layout.at(r, c) == 'W' ? WALL : 0;
+        }
+    }
+    visitedCells = 0;
+    curve.clear();
+    curve.reserve(CURVE_POINTS + 2);
+    sampleInterval = std::max(1LL, (maxSteps + CURVE_POINTS - 1) / CURVE_POINTS);
+    nextSample = sampleInterval;
+    lastStep = 0;
+    lastDirt = initialDirt;
+    visit(dock.first, dock.second);
+    curve.push_back({0, initialDirt, visitedCells});
+}
+
+std::string CoverageMap::formatImage() const {
+    std::string header = "P6\n" + std::to_string(cols) + " " + std::to_string(rows) + "\n255\n";
+    std::string image;
+    image.reserve(header.size() + visits.size() * 3);
+    image += header;
+    // the red scale is logarithmic, a cell visited once is still visible next to a corridor visited thousands of times
+    std::uint32_t maxVisits = visits.empty() ? 0 : *std::max_element(visits.begin(), visits.end());
+    double scale = maxVisits > 0 ? 255.0 / std::log1p(double(maxVisits)) : 0;
+    for (std::size_t i = 0; i < visits.size(); i++) {
+        if (cleans[i] & WALL) {
+            image += {char(0), char(0), char(160)};
+            continue;
+        }
+        auto red = std::uint8_t(std::lround(std::log1p(double(visits[i])) * scale));
+        auto green = std::uint8_t(std::min(255, int(cleans[i]) * 28));
+        image += {char(red), char(green), char(0)};
+    }
+    return image;
+}
+
+std::string CoverageMap::formatCurve() const {
+    std::ostringstream csv;
+    csv << "step,dirt_left,visited_cells\n";
+    for (const Sample &s: curve) {
+        csv << s.step << ',' << s.dirtLeft << ',' << s.visitedCells << '\n';
+    }
+    if (curve.back().step != lastStep) {
+        csv << lastStep << ',' << lastDirt << ',' << visitedCells << '\n';
+    }
+    return csv.str();
+}
@@ -0,0 +1,66 @@
+#ifndef ASSIGNMENT3_COVERAGEMAP_H
+#define ASSIGNMENT3_COVERAGEMAP_H
+
+#include "Grid.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* How a run covered its house: the visits and the cleanings of every cell, and the dirt left sampled every
+ * maxSteps / CURVE_POINTS steps, so runs of different algorithms can be compared beyond their final score.
+ * Recording is an increment per step on a flat row major array (5 bytes per cell), cheap enough to stay on in a
+ * whole tournament. Exported as a PPM heatmap and a CSV curve at the end of the run. */
+class CoverageMap {
+public:
+    // points of the dirt left curve (plus the first and the last step)
+    static constexpr int CURVE_POINTS = 512;
+
+    /* starts a run on 'layout', with the robot on the docking station */
+    void reset(const Grid<char> &layout, std::pair<int, int> dock, long long maxSteps, long long initialDirt);
+
+    void visit(int row, int col) {
+        if (row >= 0 && row < rows && col >= 0 && col < cols) {
+            std::uint32_t &cell = visits[std::size_t(row) * cols + col];
+            visitedCells += cell == 0;
+            cell++;
+        }
+    }
+
+    void clean(int row, int col) { cleans[std::size_t(row) * cols + col]++; }
+
+    /* after every step */
+    void sample(long long step, long long dirtLeft) {
+        lastStep = step;
+        lastDirt = dirtLeft;
+        if (step >= nextSample) {
+            curve.push_back({step, dirtLeft, visitedCells});
+            nextSample += sampleInterval;
+        }
+    }
+
+    /* binary PPM, one pixel per cell: walls in blue, the visits in red (log scale) and the cleanings in green */
+    std::string formatImage() const;
+
+    /* step,dirt_left,visited_cells */
+    std::string formatCurve() const;
+
+private:
+    struct Sample {
+        long long step;
+        long long dirtLeft;
+        long long visitedCells;
+    };
+
+    int rows = 0;
+    int cols = 0;
+    std::vector<std::uint32_t> visits;
+    std::vector<std::uint8_t> cleans; // the top bit marks a wall (at most 9 cleanings per cell)
+    long long visitedCells = 0;
+    std::vector<Sample> curve;
+    long long sampleInterval = 1;
+    long long nextSample = 0;
+    long long lastStep = 0;
+    long long lastDirt = 0;
+};
+
+#endif //ASSIGNMENT3_COVERAGEMAP_H
@@ -0,0 +1,183 @@
+#include "Daemon.h"
+
+namespace {
+
+std::vector<std::string> splitList(const std::string &value) {
+    std::vector<std::string> items;
+    std::istringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/* the runner ids of 'names', in the order given, without duplicates */
+std::vector<std::size_t> lookupIds(const std::vector<std::string> &names,
+                                   const std::unordered_map<std::string, std::size_t> &ids, const std::string &kind) {
+    std::vector<std::size_t> result;
+    std::set<std::size_t> seen;
+    for (const auto &name: names) {
+        auto it = ids.find(name);
+        if (it == ids.end()) {
+            throw std::runtime_error("Unknown " + kind + ": " + name);
+        }
+        if (seen.insert(it->second).second) {
+            result.push_back(it->second);
+        }
+    }
+    return result;
+}
+
+}
+
+Daemon::Daemon(Runner &runner, std::string socketPath, int reloadIntervalMs)
+        : runner(runner), socketPath(std::move(socketPath)), reloadIntervalMs(reloadIntervalMs),
+          houseNames(runner.getHouseNames()) {
+    for (std::size_t houseId = 0; houseId < houseNames.size(); houseId++) {
+        houseIds.emplace(houseNames[houseId], houseId);
+    }
+    refreshAlgorithmNames();
+}
+
+void Daemon::refreshAlgorithmNames() {
+    algoNames = runner.getAlgorithmNames();
+    algoIds.clear();
+    for (std::size_t algoId = 0; algoId < algoNames.size(); algoId++) {
+        algoIds.emplace(algoNames[algoId], algoId);
+    }
+}
+
+void Daemon::watchAlgorithms() {
+    std::unique_lock<std::mutex> lock(watcherMutex);
+    while (!watcherCv.wait_for(lock, std::chrono::milliseconds(reloadIntervalMs), [this] { return stopping; })) {
+        std::size_t reloaded = runner.reloadAlgorithms();
+        if (reloaded > 0) {
+            std::cout << "Reloaded " << reloaded << " algorithm libraries" << std::endl;
+        }
+    }
+}
+
+void Daemon::serve() {
+    StreamSocket listener = StreamSocket::listen(socketPath);
+    std::cout << "Listening on " << socketPath << std::endl;
+    std::thread watcher;
+    if (reloadIntervalMs > 0) {
+        watcher = std::thread(&Daemon::watchAlgorithms, this);
+    }
+    bool running = true;
+    while (running) {
+        StreamSocket client = listener.accept();
+        if (!client.valid()) {
+            continue;
+        }
+        std::string request;
+        while (running && client.readLine(request)) {
+            running = handleRequest(client, request);
+        }
+    }
+    listener.close();
+    std::string unixPath = StreamSocket::getUnixPath(socketPath);
+    if (!unixPath.empty()) {
+        std::filesystem::remove(unixPath);
+    }
+    if (watcher.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(watcherMutex);
+            stopping = true;
+        }
+        watcherCv.notify_one();
+        watcher.join();
+    }
+}
+
+bool Daemon::handleRequest(StreamSocket &client, const std::string &request) {
+    std::istringstream ss(request);
+    std::string command;
+    ss >> command;
+    refreshAlgorithmNames();
+    try {
+        if (command == "list") {
+            std::string response;
+            for (const auto &name: houseNames) {
+                response += "house " + name + "\n";
+            }
+            for (const auto &name: algoNames) {
+                response += "algorithm " + name + "\n";
+            }
+            client.writeAll(response + "END\n");
+        } else if (command == "run") {
+            runJob(client, parseJob(ss));
+        } else if (command == "reload") {
+            client.writeAll("END " + std::to_string(runner.reloadAlgorithms()) + "\n");
+        } else if (command == "shutdown") {
+            client.writeAll("END\n");
+            return false;
+        } else {
+            throw std::runtime_error("Invalid request: " + request);
+        }
+    } catch (const std::exception &e) {
+        client.writeAll(std::string("ERROR ") + e.what() + "\n");
+    }
+    return true;
+}
+
+void Daemon::runJob(StreamSocket &client, const Job &job) {
+    auto startTime = std::chrono::steady_clock::now();
+    std::mutex clientMutex; // the workers stream their records concurrently
+    std::size_t runs = 0;
+    runner.run(job, [&](const RunRecord &record) {
+        std::string line = ResultsSink::formatLine(ResultsFormat::JSONLines, record, houseNames[record.houseId],
+                                                   algoNames[record.algoId]);
+        std::lock_guard<std::mutex> lock(clientMutex);
+        runs++;
+        client.writeAll(line); // a client that went away does not stop the job, its results are still cached
+    });
+    auto wallTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+    client.writeAll("END " + std::to_string(runs) + " " + std::to_string(wallTimeMs) + "\n");
+}
+
+Job Daemon::parseJob(std::istringstream &request) const {
+    Job job;
+    job.summaryOnly = runner.getOptions().summaryOnly;
+    job.numOfSeeds = runner.getOptions().numOfSeeds;
+    bool housesGiven = false, algorithmsGiven = false;
+    std::string arg;
+    while (request >> arg) {
+        if (arg == "summary_only") {
+            job.summaryOnly = true;
+            continue;
+        }
+        std::size_t equals = arg.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error("Invalid argument format: " + arg);
+        }
+        std::string key = arg.substr(0, equals);
+        std::string value = arg.substr(equals + 1);
+        if (key == "houses") {
+            job.houseIds = lookupIds(splitList(value), houseIds, "house");
+            housesGiven = true;
+        } else if (key == "algorithms") {
+            job.algoIds = lookupIds(splitList(value), algoIds, "algorithm");
+            algorithmsGiven = true;
+        } else if (key == "seeds") {
+            job.numOfSeeds = std::stoi(value);
+            if (job.numOfSeeds < 0) {
+                throw std::runtime_error("Invalid number of seeds: " + value);
+            }
+        } else {
+            throw std::runtime_error("Invalid argument key: " + key);
+        }
+    }
+    Job fullJob = runner.makeFullJob();
+    if (!housesGiven) {
+        job.houseIds = fullJob.houseIds;
+    }
+    if (!algorithmsGiven) {
+        job.algoIds = fullJob.algoIds;
+    }
+    return job;
+}
@@ -0,0 +1,54 @@
+#ifndef ASSIGNMENT3_DAEMON_H
+#define ASSIGNMENT3_DAEMON_H
+
+#include "Runner.h"
+#include "Socket.h"
+#include <condition_variable>
+#include <unordered_map>
+
+/* Serves jobs over a Unix domain or TCP socket (see StreamSocket for the addresses), on a runner whose algorithms
+ * are loaded and houses parsed once.
+ * A connection sends request lines, each answered by response lines ending with "END ..." or "ERROR <message>":
+ * - list                          -> "house <name>" and "algorithm <name>" lines, "END"
+ * - run [houses=<name>,<name>...] [algorithms=<name>,...] [seeds=N] [summary_only]
+ *                                 -> one JSON line per finished run as soon as it finishes (the -results_format=jsonl
+ *                                    records), "END <runs> <wall time ms>". Every house / algorithm if not given.
+ * - reload                        -> reloads the algorithm libraries that changed, "END <reloaded libraries>"
+ * - shutdown                      -> "END", the daemon exits
+ * Jobs run one at a time, each one on all the runner threads; other clients wait in the listen backlog.
+ * Besides, every 'reloadIntervalMs' (0: never) a watcher thread reloads the libraries that changed, also while a
+ * job runs: its in-flight tasks finish on the old build, the following ones run the new build. */
+class Daemon {
+public:
+    Daemon(Runner &runner, std::string socketPath, int reloadIntervalMs);
+
+    /* returns after a shutdown request */
+    void serve();
+
+private:
+    Runner &runner;
+    std::string socketPath;
+    int reloadIntervalMs;
+    std::mutex watcherMutex;
+    std::condition_variable watcherCv;
+    bool stopping = false;
+    std::vector<std::string> houseNames;
+    std::vector<std::string> algoNames;
+    std::unordered_map<std::string, std::size_t> houseIds;
+    std::unordered_map<std::string, std::size_t> algoIds;
+
+    void watchAlgorithms();
+
+    /* refresh the names (and ids) of the algorithms, a reload may add algorithms */
+    void refreshAlgorithmNames();
+
+    /* returns false on a shutdown request */
+    bool handleRequest(StreamSocket &client, const std::string &request);
+
+    void runJob(StreamSocket &client, const Job &job);
+
+    /* throws std::runtime_error on an invalid request */
+    Job parseJob(std::istringstream &request) const;
+};
+
+#endif //ASSIGNMENT3_DAEMON_H
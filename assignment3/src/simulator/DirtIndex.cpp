@@ -0,0 +1,36 @@
+#include "DirtIndex.h"
+
+void DirtIndex::reset(int rows, int cols) {
+    this->rows = rows;
+    this->cols = cols;
+    wordsPerRow = (cols + 63) / 64;
+    regionRows = (rows + REGION_SIZE - 1) / REGION_SIZE;
+    regionCols = (cols + REGION_SIZE - 1) / REGION_SIZE;
+    totalDirt = 0;
+    dirtyCells = 0;
+    // assign() keeps the capacity, so resetting for a house of similar size does not allocate
+    bits.assign(std::size_t(rows) * wordsPerRow, 0);
+    rowDirtyCells.assign(rows, 0);
+    regions.assign(std::size_t(regionRows) * regionCols, Region());
+}
+
+void DirtIndex::setDirt(int row, int col, int dirt) {
+    updateDirt(row, col, 0, dirt);
+}
+
+void DirtIndex::updateDirt(int row, int col, int oldDirt, int newDirt) {
+    Region &region = regionOf(row, col);
+    totalDirt += newDirt - oldDirt;
+    region.dirt += newDirt - oldDirt;
+
+    bool wasDirty = oldDirt > 0;
+    bool nowDirty = newDirt > 0;
+    if (wasDirty == nowDirty) {
+        return;
+    }
+    int delta = nowDirty ? 1 : -1;
+    bits[std::size_t(row) * wordsPerRow + (col >> 6)] ^= std::uint64_t(1) << (col & 63);
+    rowDirtyCells[row] += delta;
+    region.dirtyCells += delta;
+    dirtyCells += delta;
+}
@@ -0,0 +1,86 @@
+#ifndef ASSIGNMENT3_DIRTINDEX_H
+#define ASSIGNMENT3_DIRTINDEX_H
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+/* Sparse index of the house cells that still have dirt.
+ * Keeps one bit per cell (set while the cell is dirty), the number of dirty cells per row, and dirt / dirty cell
+ * counters per REGION_SIZE x REGION_SIZE region. Every update is O(1), so the simulator can answer
+ * "is the house clean" in O(1) and per-region queries in O(1) / O(regions) without scanning the grid. */
+class DirtIndex {
+public:
+    static constexpr int REGION_SIZE = 64;
+
+    void reset(int rows, int cols);
+
+    /* set the dirt of a cell while loading the house (right after reset(), when every cell is still clean) */
+    void setDirt(int row, int col, int dirt);
+
+    /* the dirt of (row, col) changed from oldDirt to newDirt */
+    void updateDirt(int row, int col, int oldDirt, int newDirt);
+
+    bool isClean() const { return totalDirt == 0; }
+
+    long long getTotalDirt() const { return totalDirt; }
+
+    long long getDirtyCells() const { return dirtyCells; }
+
+    bool isDirty(int row, int col) const {
+        return (bits[std::size_t(row) * wordsPerRow + (col >> 6)] >> (col & 63)) & 1;
+    }
+
+    int getDirtyCellsInRow(int row) const { return rowDirtyCells[row]; }
+
+    int getRegionRows() const { return regionRows; }
+
+    int getRegionCols() const { return regionCols; }
+
+    long long getRegionDirt(int regionRow, int regionCol) const {
+        return regions[std::size_t(regionRow) * regionCols + regionCol].dirt;
+    }
+
+    int getRegionDirtyCells(int regionRow, int regionCol) const {
+        return regions[std::size_t(regionRow) * regionCols + regionCol].dirtyCells;
+    }
+
+    /* call f(row, col) for every dirty cell, skipping clean rows and clean 64 cell words */
+    template<typename F>
+    void forEachDirtyCell(F f) const {
+        for (int row = 0; row < rows; row++) {
+            if (rowDirtyCells[row] == 0) {
+                continue;
+            }
+            const std::uint64_t *rowBits = &bits[std::size_t(row) * wordsPerRow];
+            for (int w = 0; w < wordsPerRow; w++) {
+                for (std::uint64_t word = rowBits[w]; word != 0; word &= word - 1) {
+                    f(row, (w << 6) + std::countr_zero(word));
+                }
+            }
+        }
+    }
+
+private:
+    struct Region {
+        long long dirt = 0;
+        int dirtyCells = 0;
+    };
+
+    int rows = 0;
+    int cols = 0;
+    int wordsPerRow = 0;
+    int regionRows = 0;
+    int regionCols = 0;
+    long long totalDirt = 0;
+    long long dirtyCells = 0;
+    std::vector<std::uint64_t> bits;
+    std::vector<int> rowDirtyCells;
+    std::vector<Region> regions;
+
+    Region &regionOf(int row, int col) {
+        return regions[std::size_t(row / REGION_SIZE) * regionCols + col / REGION_SIZE];
+    }
+};
+
+#endif //ASSIGNMENT3_DIRTINDEX_H
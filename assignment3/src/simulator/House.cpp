@@ -0,0 +1,105 @@
+#include "House.h"
+
+bool readHouse(const std::string &filePath, GridLayout layout, House &house) {
+    house.filePath = filePath;
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        std::cout << "readHouse ERROR: Failed to open file" << std::endl;
+        std::cout << "Invalid file name: " << filePath << std::endl;
+        return false;
+    }
+
+    /* extract the house_files file name from the path, to be used in the output file name */
+    std::filesystem::path inputPath(filePath);
+    house.fileName = inputPath.filename().string();
+    const std::string &input_file_name = house.fileName;
+
+    /* initialize house name, MaxSteps, MaxBattery, Rows, Cols */
+    std::string line;
+    for (int i = 0; i < 5; i++) {
+        if (!getline(file, line)) {
+            std::cout << "readHouse ERROR: File missing information" << std::endl;
+            std::cout << "Invalid file name: " << input_file_name << std::endl;
+            file.close();
+            return false;
+        }
+        if (i == 0) {
+            house.name = line;
+        }
+        std::istringstream ss(line);
+        std::string key;
+        long long value;
+        getline(ss, key, '=');
+        key.erase(key.find_last_not_of(" \t\n\r\f\v") + 1); // Trim trailing spaces from key
+        ss >> value;
+        if (key == "MaxSteps") house.maxSteps = value;
+        else if (key == "MaxBattery") house.maxBattery = int(value);
+        else if (key == "Rows") house.rows = int(value);
+        else if (key == "Cols") house.cols = int(value);
+    }
+    // sanity check for: maxSteps, maxBatterySteps, rows, cols
+    const int rows = house.rows;
+    const int cols = house.cols;
+    if (house.maxSteps < 0 || house.maxBattery < 0 || rows < 0 || cols < 0) {
+        std::cout << "readHouse ERROR: Invalid house file parameter (maxSteps / MaxBatterySteps / house rows / house cols" << std::endl;
+        std::cout << "Invalid file: " << input_file_name << std::endl;
+        file.close();
+        return false;
+    }
+    bool dockingStationFound = false;
+    int houseLayoutRowsNum = 0;
+    std::vector<std::string> layoutRows;
+    /* get house layout */
+    // if the number of rows in the given layout is greater than 'Rows' -> ignore the rest of the rows
+    while (getline(file, line) && houseLayoutRowsNum < rows) {
+        houseLayoutRowsNum++;
+        std::string currRow(line);
+        // if the number of cols in the layout is smaller than 'Cols' -> pad the row with ' '
+        if (int(currRow.size()) < cols) {
+            currRow.resize(cols, ' ');
+        }
+        // if the number of cols in the given layout is greater than 'Cols' -> shorten the row by deleting the last elements
+        else if (int(currRow.size()) > cols) {
+            currRow.resize(cols);
+        }
+        // append the currRow to the house layout
+        layoutRows.push_back(currRow);
+
+        // Check if the currRow contains the docking station 'D'
+        auto it = std::find(currRow.begin(), currRow.end(), 'D');
+        if (it != currRow.end()) {
+            if (!dockingStationFound) {
+                dockingStationFound = true;
+                int index = std::distance(currRow.begin(), it);
+                house.dockingStation = std::make_pair(layoutRows.size() - 1, index);
+            } else {
+                std::cout << "readHouse ERROR: More than 1 docking station defined in layout" << std::endl;
+                std::cout << "Invalid file name: " << input_file_name << std::endl;
+                file.close();
+                return false;
+            }
+        }
+    }
+    if (!dockingStationFound) {
+        std::cout << "readHouse ERROR: No docking station defined in layout" << std::endl;
+        std::cout << "Invalid file name: " << input_file_name << std::endl;
+        file.close();
+        return false;
+    }
+    // copy the rows into the house grid (rows missing from the file stay out of the grid bounds)
+    // and index the dirty cells, which also sums up the total dirt in the house
+    house.layout.reset(int(layoutRows.size()), cols, layout, ' ');
+    house.dirt.reset(int(layoutRows.size()), cols);
+    for (int r = 0; r < int(layoutRows.size()); r++) {
+        for (int c = 0; c < cols; c++) {
+            char cell = layoutRows[r][c];
+            house.layout.at(r, c) = cell;
+            if (cell >= '1' && cell <= '9') {
+                house.dirt.setDirt(r, c, cell - '0');
+            }
+        }
+    }
+    file.close();
+    // If house file is valid, return TRUE
+    return true;
+}
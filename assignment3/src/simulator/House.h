@@ -0,0 +1,28 @@
+#ifndef ASSIGNMENT3_HOUSE_H
+#define ASSIGNMENT3_HOUSE_H
+
+#include "utils.h"
+#include "Grid.h"
+#include "DirtIndex.h"
+
+/* A parsed and validated house file.
+ * Parsed once, then shared (read only) by every simulation that runs on this house, see Simulator::reset(). */
+struct House {
+    std::string filePath;
+    std::string fileName; // file name without the directories, used in the output file names
+    std::string name; // first line of the house file
+    std::int64_t maxSteps = -1;
+    int maxBattery = -1;
+    int rows = -1;
+    int cols = -1;
+    // rows missing from the file are left out of the grid (out of bounds cells are walls)
+    Grid<char> layout;
+    DirtIndex dirt;
+    std::pair<int, int> dockingStation;
+    std::uint64_t contentHash = 0; // hash of the file bytes, set only when the result cache is used
+};
+
+/* returns FALSE if house file cannot be open or is invalid, and TRUE (and fills 'house') if house file is valid */
+bool readHouse(const std::string &filePath, GridLayout layout, House &house);
+
+#endif //ASSIGNMENT3_HOUSE_H
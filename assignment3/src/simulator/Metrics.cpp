@@ -0,0 +1,269 @@
+#include "Metrics.h"
+#include "OutputWriter.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::string escape(const std::string &s) {
+    std::string escaped;
+    for (char c: s) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+/* the summary of a histogram as a JSON object */
+std::string jsonHistogram(const LatencyHistogram::Snapshot &h) {
+    std::ostringstream out;
+    out << "{\"count\":" << h.count << ",\"mean\":" << h.mean() << ",\"p50\":" << h.percentile(50)
+        << ",\"p90\":" << h.percentile(90) << ",\"p99\":" << h.percentile(99) << ",\"max\":" << h.max << "}";
+    return out.str();
+}
+
+/* a Prometheus summary: quantiles, _sum and _count. 'labels' is empty or 'key="value"' */
+void promHistogram(std::ostringstream &out, const std::string &name, const std::string &labels,
+                   const LatencyHistogram::Snapshot &h) {
+    std::string separator = labels.empty() ? "" : ",";
+    for (double q: {0.5, 0.9, 0.99}) {
+        out << name << "{" << labels << separator << "quantile=\"" << q << "\"} " << h.percentile(q * 100) << "\n";
+    }
+    std::string braces = labels.empty() ? "" : "{" + labels + "}";
+    out << name << "_sum" << braces << " " << h.sum << "\n";
+    out << name << "_count" << braces << " " << h.count << "\n";
+}
+
+}
+
+MetricsFormat parseMetricsFormat(const std::string &format) {
+    if (format == "prom") return MetricsFormat::Prometheus;
+    if (format == "json") return MetricsFormat::JSON;
+    throw std::runtime_error("Invalid metrics format: " + format + " (expected prom / json)");
+}
+
+Metrics::Metrics(std::size_t numOfWorkers, std::vector<std::string> houseNames, std::vector<std::string> algoNames)
+        : houseNames(std::move(houseNames)), algoNames(std::move(algoNames)) {
+    for (std::size_t i = 0; i < numOfWorkers; i++) {
+        auto worker = std::make_unique<WorkerMetrics>();
+        worker->algorithms = std::make_unique<AlgorithmMetrics[]>(this->algoNames.size());
+        worker->houses = std::make_unique<HouseMetrics[]>(this->houseNames.size());
+        workers.push_back(std::move(worker));
+    }
+}
+
+Metrics::~Metrics() {
+    stopExport();
+}
+
+void Metrics::tasksQueued(std::size_t numOfTasks) {
+    queued.fetch_add(numOfTasks, std::memory_order_relaxed);
+}
+
+void Metrics::taskClaimed(std::size_t worker, std::uint64_t waitUs) {
+    workers[worker]->queueWaitUs.record(waitUs);
+}
+
+void Metrics::taskCached(std::size_t worker) {
+    workers[worker]->cached.add(1);
+}
+
+void Metrics::taskDone(std::size_t worker, const RunRecord &record) {
+    WorkerMetrics &w = *workers[worker];
+    const bool timeout = record.status == RunStatus::Timeout;
+    const bool error = record.status == RunStatus::Error;
+    const auto steps = std::uint64_t(std::max<std::int64_t>(record.steps, 0));
+    w.runs.add(1);
+    w.steps.add(steps);
+    w.timeouts.add(timeout);
+    w.errors.add(error);
+    if (record.algoId < algoNames.size()) {
+        AlgorithmMetrics &a = w.algorithms[record.algoId];
+        a.runs.add(1);
+        a.steps.add(steps);
+        a.timeouts.add(timeout);
+        a.errors.add(error);
+        a.wallTimeUs.record(record.wallTimeUs);
+    }
+    if (record.houseId < houseNames.size()) {
+        HouseMetrics &h = w.houses[record.houseId];
+        h.runs.add(1);
+        h.steps.add(steps);
+        h.wallTimeUs.add(record.wallTimeUs);
+    }
+}
+
+LatencyHistogram *Metrics::getStepLatency(std::size_t worker, std::size_t algoId) {
+    return algoId < algoNames.size() ? &workers[worker]->algorithms[algoId].stepLatencyNs : nullptr;
+}
+
+std::uint64_t Metrics::getTotalSteps() const {
+    std::uint64_t steps = 0;
+    for (const auto &w: workers) {
+        steps += w->steps.get();
+    }
+    return steps;
+}
+
+std::string Metrics::format(MetricsFormat format, double stepsPerSecond) const {
+    // Merge the workers
+    struct Totals {
+        std::uint64_t runs = 0, steps = 0, timeouts = 0, errors = 0;
+        LatencyHistogram::Snapshot wallTimeUs, stepLatencyNs;
+    };
+    std::vector<Totals> algorithms(algoNames.size());
+    struct HouseTotals {
+        std::uint64_t runs = 0, steps = 0, wallTimeUs = 0;
+    };
+    std::vector<HouseTotals> houses(houseNames.size());
+    Totals total;
+    std::uint64_t cached = 0;
+    LatencyHistogram::Snapshot queueWaitUs;
+    for (const auto &w: workers) {
+        total.runs += w->runs.get();
+        total.steps += w->steps.get();
+        total.timeouts += w->timeouts.get();
+        total.errors += w->errors.get();
+        cached += w->cached.get();
+        queueWaitUs.merge(w->queueWaitUs);
+        for (std::size_t a = 0; a < algoNames.size(); a++) {
+            const AlgorithmMetrics &m = w->algorithms[a];
+            algorithms[a].runs += m.runs.get();
+            algorithms[a].steps += m.steps.get();
+            algorithms[a].timeouts += m.timeouts.get();
+            algorithms[a].errors += m.errors.get();
+            algorithms[a].wallTimeUs.merge(m.wallTimeUs);
+            algorithms[a].stepLatencyNs.merge(m.stepLatencyNs);
+        }
+        for (std::size_t h = 0; h < houseNames.size(); h++) {
+            const HouseMetrics &m = w->houses[h];
+            houses[h].runs += m.runs.get();
+            houses[h].steps += m.steps.get();
+            houses[h].wallTimeUs += m.wallTimeUs.get();
+        }
+    }
+    // every claimed task records its queue wait
+    std::uint64_t claimed = queueWaitUs.count;
+    std::uint64_t queueDepth = queued > claimed ? queued - claimed : 0;
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::ostringstream out;
+    if (format == MetricsFormat::JSON) {
+        out << "{\"uptime_seconds\":" << uptime << ",\"steps_per_second\":" << stepsPerSecond
+            << ",\"queue_depth\":" << queueDepth << ",\"runs\":" << total.runs << ",\"cached\":" << cached
+            << ",\"steps\":" << total.steps << ",\"timeouts\":" << total.timeouts << ",\"errors\":" << total.errors
+            << ",\"queue_wait_us\":" << jsonHistogram(queueWaitUs) << ",\"workers\":[";
+        for (std::size_t i = 0; i < workers.size(); i++) {
+            out << (i ? "," : "") << "{\"worker\":" << i << ",\"runs\":" << workers[i]->runs.get()
+                << ",\"cached\":" << workers[i]->cached.get() << ",\"steps\":" << workers[i]->steps.get() << "}";
+        }
+        out << "],\"algorithms\":[";
+        for (std::size_t a = 0; a < algoNames.size(); a++) {
+            const Totals &t = algorithms[a];
+            out << (a ? "," : "") << "{\"name\":\"" << escape(algoNames[a]) << "\",\"runs\":" << t.runs
+                << ",\"steps\":" << t.steps << ",\"timeouts\":" << t.timeouts << ",\"errors\":" << t.errors
+                << ",\"wall_time_us\":" << jsonHistogram(t.wallTimeUs)
+                << ",\"next_step_ns\":" << jsonHistogram(t.stepLatencyNs) << "}";
+        }
+        out << "],\"houses\":[";
+        for (std::size_t h = 0; h < houseNames.size(); h++) {
+            out << (h ? "," : "") << "{\"name\":\"" << escape(houseNames[h]) << "\",\"runs\":" << houses[h].runs
+                << ",\"steps\":" << houses[h].steps << ",\"wall_time_us\":" << houses[h].wallTimeUs << "}";
+        }
+        out << "]}\n";
+        return out.str();
+    }
+
+    out << "# TYPE myrobot_uptime_seconds gauge\nmyrobot_uptime_seconds " << uptime << "\n";
+    out << "# TYPE myrobot_steps_per_second gauge\nmyrobot_steps_per_second " << stepsPerSecond << "\n";
+    out << "# TYPE myrobot_queue_depth gauge\nmyrobot_queue_depth " << queueDepth << "\n";
+    out << "# TYPE myrobot_cached_total counter\nmyrobot_cached_total " << cached << "\n";
+    out << "# TYPE myrobot_queue_wait_us summary\n";
+    promHistogram(out, "myrobot_queue_wait_us", "", queueWaitUs);
+    out << "# TYPE myrobot_worker_runs_total counter\n";
+    for (std::size_t i = 0; i < workers.size(); i++) {
+        out << "myrobot_worker_runs_total{worker=\"" << i << "\"} " << workers[i]->runs.get() << "\n";
+    }
+    out << "# TYPE myrobot_worker_steps_total counter\n";
+    for (std::size_t i = 0; i < workers.size(); i++) {
+        out << "myrobot_worker_steps_total{worker=\"" << i << "\"} " << workers[i]->steps.get() << "\n";
+    }
+    auto algoLabel = [this](std::size_t a) { return "algorithm=\"" + escape(algoNames[a]) + "\""; };
+    auto houseLabel = [this](std::size_t h) { return "house=\"" + escape(houseNames[h]) + "\""; };
+    out << "# TYPE myrobot_runs_total counter\n";
+    for (std::size_t a = 0; a < algoNames.size(); a++) {
+        out << "myrobot_runs_total{" << algoLabel(a) << "} " << algorithms[a].runs << "\n";
+    }
+    out << "# TYPE myrobot_steps_total counter\n";
+    for (std::size_t a = 0; a < algoNames.size(); a++) {
+        out << "myrobot_steps_total{" << algoLabel(a) << "} " << algorithms[a].steps << "\n";
+    }
+    out << "# TYPE myrobot_timeouts_total counter\n";
+    for (std::size_t a = 0; a < algoNames.size(); a++) {
+        out << "myrobot_timeouts_total{" << algoLabel(a) << "} " << algorithms[a].timeouts << "\n";
+    }
+    out << "# TYPE myrobot_errors_total counter\n";
+    for (std::size_t a = 0; a < algoNames.size(); a++) {
+        out << "myrobot_errors_total{" << algoLabel(a) << "} " << algorithms[a].errors << "\n";
+    }
+    out << "# TYPE myrobot_run_wall_time_us summary\n";
+    for (std::size_t a = 0; a < algoNames.size(); a++) {
+        promHistogram(out, "myrobot_run_wall_time_us", algoLabel(a), algorithms[a].wallTimeUs);
+    }
+    out << "# TYPE myrobot_next_step_ns summary\n";
+    for (std::size_t a = 0; a < algoNames.size(); a++) {
+        promHistogram(out, "myrobot_next_step_ns", algoLabel(a), algorithms[a].stepLatencyNs);
+    }
+    out << "# TYPE myrobot_house_runs_total counter\n";
+    for (std::size_t h = 0; h < houseNames.size(); h++) {
+        out << "myrobot_house_runs_total{" << houseLabel(h) << "} " << houses[h].runs << "\n";
+    }
+    out << "# TYPE myrobot_house_steps_total counter\n";
+    for (std::size_t h = 0; h < houseNames.size(); h++) {
+        out << "myrobot_house_steps_total{" << houseLabel(h) << "} " << houses[h].steps << "\n";
+    }
+    out << "# TYPE myrobot_house_wall_time_us_total counter\n";
+    for (std::size_t h = 0; h < houseNames.size(); h++) {
+        out << "myrobot_house_wall_time_us_total{" << houseLabel(h) << "} " << houses[h].wallTimeUs << "\n";
+    }
+    return out.str();
+}
+
+void Metrics::startExport(std::string fileName, MetricsFormat format, int intervalMs) {
+    this->fileName = std::move(fileName);
+    exportFormat = format;
+    this->intervalMs = std::max(intervalMs, 1);
+    exporter = std::thread(&Metrics::exportLoop, this);
+}
+
+void Metrics::stopExport() {
+    if (!exporter.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(exportMutex);
+        stopping = true;
+    }
+    exportCv.notify_one();
+    exporter.join();
+    exportNow();
+}
+
+void Metrics::exportLoop() {
+    std::unique_lock<std::mutex> lock(exportMutex);
+    while (!exportCv.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return stopping; })) {
+        exportNow();
+    }
+}
+
+void Metrics::exportNow() {
+    auto now = std::chrono::steady_clock::now();
+    std::uint64_t steps = getTotalSteps();
+    double seconds = std::chrono::duration<double>(now - lastExport).count();
+    double stepsPerSecond = seconds > 0 ? double(steps - lastSteps) / seconds : 0;
+    lastSteps = steps;
+    lastExport = now;
+    OutputWriter::getOutputWriter().write(fileName, format(exportFormat, stepsPerSecond), OutputWriter::Mode::Truncate);
+}
@@ -0,0 +1,114 @@
+#ifndef ASSIGNMENT3_METRICS_H
+#define ASSIGNMENT3_METRICS_H
+
+#include "ResultsSink.h"
+#include "Histogram.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class MetricsFormat { Prometheus, JSON };
+
+MetricsFormat parseMetricsFormat(const std::string &format);
+
+/* Counters and latency histograms of a tournament, kept per worker so recording them is a few relaxed stores on
+ * memory no other worker writes, and merged only when they are exported:
+ * - per algorithm: runs, steps, timeouts, errors, run wall time (us), nextStep() latency (ns)
+ * - per house: runs, steps, wall time
+ * - per worker: runs, cached results, time waiting for a task (us)
+ * - global: queue depth (tasks not claimed yet) and steps per second since the previous export.
+ * Houses and algorithms are the ones known when the metrics are created, runs of algorithms added later
+ * (hot reload) only count in the per worker totals.
+ * startExport() rewrites the metrics file every interval, and once more on stopExport(). */
+class Metrics {
+public:
+    Metrics(std::size_t numOfWorkers, std::vector<std::string> houseNames, std::vector<std::string> algoNames);
+
+    ~Metrics();
+
+    Metrics(const Metrics &) = delete;
+
+    Metrics &operator=(const Metrics &) = delete;
+
+    /* a valid house of a job adds its 'numOfTasks' to the queue. Thread safe */
+    void tasksQueued(std::size_t numOfTasks);
+
+    /* the worker took a task from the queue after waiting 'waitUs' for it */
+    void taskClaimed(std::size_t worker, std::uint64_t waitUs);
+
+    /* the worker found the result of its task in the cache */
+    void taskCached(std::size_t worker);
+
+    /* the worker ran a task (record.houseId / algoId are runner ids) */
+    void taskDone(std::size_t worker, const RunRecord &record);
+
+    /* the histogram 'worker' merges the nextStep() latencies of its runs of 'algoId' into (only the worker writes
+     * it), nullptr for an unknown algorithm */
+    LatencyHistogram *getStepLatency(std::size_t worker, std::size_t algoId);
+
+    /* the merged metrics, 'stepsPerSecond' is reported as is */
+    std::string format(MetricsFormat format, double stepsPerSecond) const;
+
+    void startExport(std::string fileName, MetricsFormat format, int intervalMs);
+
+    /* writes the final metrics, returns once they are queued in the OutputWriter */
+    void stopExport();
+
+private:
+    /* a counter with a single writer, read by the exporter */
+    struct Counter {
+        std::atomic<std::uint64_t> value{0};
+
+        void add(std::uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+
+        std::uint64_t get() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    struct AlgorithmMetrics {
+        Counter runs, steps, timeouts, errors;
+        LatencyHistogram wallTimeUs;
+        LatencyHistogram stepLatencyNs;
+    };
+
+    struct HouseMetrics {
+        Counter runs, steps, wallTimeUs;
+    };
+
+    // allocated separately, so two workers never write the same cache line
+    struct WorkerMetrics {
+        Counter runs, cached, steps, timeouts, errors;
+        LatencyHistogram queueWaitUs;
+        std::unique_ptr<AlgorithmMetrics[]> algorithms;
+        std::unique_ptr<HouseMetrics[]> houses;
+    };
+
+    std::vector<std::string> houseNames;
+    std::vector<std::string> algoNames;
+    std::vector<std::unique_ptr<WorkerMetrics>> workers;
+    std::atomic<std::uint64_t> queued{0};
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    // periodic export
+    std::string fileName;
+    MetricsFormat exportFormat = MetricsFormat::Prometheus;
+    int intervalMs = 1000;
+    std::thread exporter;
+    std::mutex exportMutex;
+    std::condition_variable exportCv;
+    bool stopping = false;
+    std::uint64_t lastSteps = 0;
+    std::chrono::steady_clock::time_point lastExport = startTime;
+
+    std::uint64_t getTotalSteps() const;
+
+    void exportLoop();
+
+    /* writes the metrics file, called by the exporter thread (or after it stopped) */
+    void exportNow();
+};
+
+#endif //ASSIGNMENT3_METRICS_H
@@ -0,0 +1,150 @@
+#include "ResultCache.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+
+std::uint64_t ResultCache::hashBytes(const char *data, std::size_t size, std::uint64_t hash) {
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::uint64_t ResultCache::hashValue(std::uint64_t value, std::uint64_t hash) {
+    char bytes[sizeof(value)];
+    for (std::size_t i = 0; i < sizeof(value); i++) {
+        bytes[i] = char(value >> (8 * i));
+    }
+    return hashBytes(bytes, sizeof(value), hash);
+}
+
+std::uint64_t ResultCache::hashFile(const std::string &filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for hashing: " + filePath);
+    }
+    std::uint64_t hash = HASH_SEED;
+    std::vector<char> buffer(1 << 16);
+    while (file) {
+        file.read(buffer.data(), std::streamsize(buffer.size()));
+        hash = hashBytes(buffer.data(), std::size_t(file.gcount()), hash);
+    }
+    return hash;
+}
+
+std::uint64_t ResultCache::makeKey(std::uint64_t houseHash, std::uint64_t algorithmHash, std::uint64_t seed,
+                                   std::uint64_t memoryCapBytes) {
+    std::uint64_t hash = hashValue(algorithmHash, hashValue(houseHash));
+    if (seed != NO_SEED) {
+        hash = hashValue(seed, hash);
+    }
+    if (memoryCapBytes != 0) {
+        hash = hashValue(memoryCapBytes, hash);
+    }
+    return hashValue(SIMULATOR_VERSION, hash);
+}
+
+bool ResultCache::isCacheable(RunStatus status) {
+    return status == RunStatus::Finished || status == RunStatus::Working || status == RunStatus::Dead;
+}
+
+ResultCache::ResultCache(std::string fileName) : fileName(std::move(fileName)) {
+    bool cutLine = load();
+    fd = open(this->fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open the result cache " + this->fileName + ": " + std::strerror(errno));
+    }
+    // the next lines must not be glued to the end of the line cut by a crash
+    if (cutLine && ::write(fd, "\n", 1) != 1) {
+        std::cerr << "Failed to append to the result cache " << this->fileName << std::endl;
+    }
+}
+
+ResultCache::~ResultCache() {
+    close(fd);
+}
+
+bool ResultCache::load() {
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        return false; // first run, nothing cached yet
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (file.eof()) {
+            return !line.empty(); // no '\n': cut by a crash
+        }
+        std::istringstream ss(line);
+        std::uint64_t key;
+        Entry entry{};
+        std::string status;
+        if (!(ss >> std::hex >> key >> std::dec >> entry.score >> status >> entry.steps >> entry.dirtLeft)) {
+            continue; // not a cache line
+        }
+        entry.status = parseRunStatus(status);
+        if (!isCacheable(entry.status)) {
+            continue; // written by an older version that also kept timeouts and errors
+        }
+        // the memory of the run, only there if it was tracked
+        if (!(ss >> entry.peakBytes >> entry.allocations)) {
+            entry.peakBytes = 0;
+            entry.allocations = 0;
+        }
+        entries[key] = entry;
+    }
+    return false;
+}
+
+bool ResultCache::lookup(std::uint64_t key, RunRecord &record) const {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    record.score = it->second.score;
+    record.status = it->second.status;
+    record.steps = it->second.steps;
+    record.dirtLeft = it->second.dirtLeft;
+    record.wallTimeUs = 0;
+    record.peakBytes = it->second.peakBytes;
+    record.allocations = it->second.allocations;
+    return true;
+}
+
+void ResultCache::store(std::uint64_t key, const RunRecord &record) {
+    if (!isCacheable(record.status)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pending.emplace_back(key, Entry{record.score, record.status, record.steps, record.dirtLeft,
+                                        record.peakBytes, record.allocations});
+    }
+    std::ostringstream line;
+    line << std::hex << std::setw(16) << std::setfill('0') << key << std::dec << ' ' << record.score << ' '
+         << getRunStatusName(record.status) << ' ' << record.steps << ' ' << record.dirtLeft;
+    if (record.peakBytes > 0 || record.allocations > 0) {
+        line << ' ' << record.peakBytes << ' ' << record.allocations;
+    }
+    line << '\n';
+    // a single write of a whole line at the end of the file, whatever the other workers append meanwhile
+    std::string text = line.str();
+    if (::write(fd, text.data(), text.size()) != ssize_t(text.size())) {
+        std::cerr << "Failed to append to the result cache " << fileName << std::endl;
+    }
+}
+
+void ResultCache::commit() {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    for (const auto &[key, entry]: pending) {
+        entries[key] = entry;
+    }
+    pending.clear();
+}
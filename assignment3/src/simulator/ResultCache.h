@@ -0,0 +1,87 @@
+#ifndef ASSIGNMENT3_RESULTCACHE_H
+#define ASSIGNMENT3_RESULTCACHE_H
+
+#include "ResultsSink.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+// Bump whenever a change to the simulator (rules, scoring, output) changes the results of a run,
+// every cached result is then treated as stale
+constexpr std::uint32_t SIMULATOR_VERSION = 1;
+
+/* On-disk cache of run results, keyed by the content of what produced them:
+ * key = hash(house file bytes, algorithm library bytes, algorithm name, seed (seeded runs only), memory cap (if any),
+ * SIMULATOR_VERSION).
+ * A re-run only simulates the pairs whose key is not in the cache, and since every result is appended to the
+ * cache file (synchronously, by the worker) as soon as its task completes, an interrupted run resumes where it
+ * stopped.
+ * The file is append only, one result per line: <key hex> <score> <status> <steps> <dirt left>, followed by
+ * <peak bytes> <allocations> if the run tracked its memory.
+ * A line cut by a crash is ignored (and ended before appending); if a key appears more than once the last line
+ * wins. */
+class ResultCache {
+public:
+    // 64 bit FNV-1a
+    static constexpr std::uint64_t HASH_SEED = 14695981039346656037ull;
+
+    static std::uint64_t hashBytes(const char *data, std::size_t size, std::uint64_t hash = HASH_SEED);
+
+    static std::uint64_t hashValue(std::uint64_t value, std::uint64_t hash = HASH_SEED);
+
+    /* hash of the whole file content, throws if the file cannot be read */
+    static std::uint64_t hashFile(const std::string &filePath);
+
+    static std::uint64_t makeKey(std::uint64_t houseHash, std::uint64_t algorithmHash, std::uint64_t seed = NO_SEED,
+                                 std::uint64_t memoryCapBytes = 0);
+
+    /* only the runs that ended on their own (FINISHED, WORKING, DEAD) are cached. Timeouts and errors depend on the
+     * machine load rather than on the inputs */
+    static bool isCacheable(RunStatus status);
+
+    /* loads the results already in 'fileName' (if it exists) and opens it to append. Throws std::runtime_error if
+     * it cannot be opened */
+    explicit ResultCache(std::string fileName);
+
+    ~ResultCache();
+
+    ResultCache(const ResultCache &) = delete;
+
+    ResultCache &operator=(const ResultCache &) = delete;
+
+    /* the map is only read while the workers run, so lookups from several threads need no lock */
+    bool lookup(std::uint64_t key, RunRecord &record) const;
+
+    /* appends the result to the cache file if isCacheable(): a single write() to the file opened with O_APPEND, so
+     * the line is in the file once store() returns, even if the process is killed next. Thread safe.
+     * The result is only visible to lookup() after commit() */
+    void store(std::uint64_t key, const RunRecord &record);
+
+    /* makes the results stored so far visible to lookup(). Not thread safe: called between two tournaments */
+    void commit();
+
+    std::size_t size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        std::int64_t score;
+        RunStatus status;
+        std::int64_t steps;
+        std::int64_t dirtLeft;
+        std::uint64_t peakBytes;
+        std::uint64_t allocations;
+    };
+
+    std::string fileName;
+    int fd = -1; // opened with O_APPEND
+    std::unordered_map<std::uint64_t, Entry> entries;
+    std::mutex pendingMutex;
+    std::vector<std::pair<std::uint64_t, Entry>> pending; // stored, not committed yet
+
+    /* returns true if the file ends with a line cut by a crash */
+    bool load();
+};
+
+#endif //ASSIGNMENT3_RESULTCACHE_H
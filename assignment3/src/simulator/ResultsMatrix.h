@@ -0,0 +1,102 @@
+#ifndef ASSIGNMENT3_RESULTSMATRIX_H
+#define ASSIGNMENT3_RESULTSMATRIX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/* Statistics of the scores of the runs (seeds) of one house x algorithm pair */
+struct ScoreStats {
+    std::size_t runs = 0;
+    double mean = 0;
+    double stddev = 0; // population standard deviation
+    std::int64_t min = 0;
+    std::int64_t p50 = 0;
+    std::int64_t p90 = 0;
+    std::int64_t p99 = 0;
+    std::int64_t max = 0;
+};
+
+/* percentiles use the nearest rank method, so they are always one of the scores */
+inline ScoreStats computeScoreStats(std::vector<std::int64_t> scores) {
+    ScoreStats stats;
+    stats.runs = scores.size();
+    if (scores.empty()) {
+        return stats;
+    }
+    std::sort(scores.begin(), scores.end());
+    double sum = 0;
+    for (std::int64_t score: scores) {
+        sum += double(score);
+    }
+    stats.mean = sum / double(scores.size());
+    double squares = 0;
+    for (std::int64_t score: scores) {
+        squares += (double(score) - stats.mean) * (double(score) - stats.mean);
+    }
+    stats.stddev = std::sqrt(squares / double(scores.size()));
+    auto percentile = [&scores](double p) {
+        auto rank = std::size_t(std::ceil(p / 100.0 * double(scores.size())));
+        return scores[std::max<std::size_t>(rank, 1) - 1];
+    };
+    stats.min = scores.front();
+    stats.p50 = percentile(50);
+    stats.p90 = percentile(90);
+    stats.p99 = percentile(99);
+    stats.max = scores.back();
+    return stats;
+}
+
+/* Scores of a tournament, one cell per (house id, algorithm id, run), where the runs are the seeds of a pair
+ * (a single run unless -seeds is given).
+ * Preallocated before the workers start. Every cell is written by exactly one task, so workers publish their
+ * scores without any lock; the matrix is read once the workers are joined. */
+class ResultsMatrix {
+public:
+    static constexpr std::int64_t NO_SCORE = std::numeric_limits<std::int64_t>::min();
+
+    void reset(std::size_t houses, std::size_t algorithms, std::size_t runs = 1) {
+        numOfAlgorithms = algorithms;
+        numOfRuns = runs;
+        scores.assign(houses * algorithms * runs, NO_SCORE);
+    }
+
+    void setScore(std::size_t houseId, std::size_t algoId, std::int64_t score, std::size_t run = 0) {
+        scores[index(houseId, algoId, run)] = score;
+    }
+
+    std::int64_t getScore(std::size_t houseId, std::size_t algoId, std::size_t run = 0) const {
+        return scores[index(houseId, algoId, run)];
+    }
+
+    bool hasScore(std::size_t houseId, std::size_t algoId, std::size_t run = 0) const {
+        return getScore(houseId, algoId, run) != NO_SCORE;
+    }
+
+    std::size_t getRuns() const { return numOfRuns; }
+
+    /* the scores of all the runs of a pair that have one */
+    std::vector<std::int64_t> getScores(std::size_t houseId, std::size_t algoId) const {
+        std::vector<std::int64_t> pairScores;
+        for (std::size_t run = 0; run < numOfRuns; run++) {
+            if (hasScore(houseId, algoId, run)) {
+                pairScores.push_back(getScore(houseId, algoId, run));
+            }
+        }
+        return pairScores;
+    }
+
+private:
+    std::size_t numOfAlgorithms = 0;
+    std::size_t numOfRuns = 1;
+    std::vector<std::int64_t> scores;
+
+    std::size_t index(std::size_t houseId, std::size_t algoId, std::size_t run) const {
+        return (houseId * numOfAlgorithms + algoId) * numOfRuns + run;
+    }
+};
+
+#endif //ASSIGNMENT3_RESULTSMATRIX_H
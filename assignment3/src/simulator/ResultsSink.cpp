@@ -0,0 +1,383 @@
+#include "ResultsSink.h"
+#include "OutputWriter.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little, "the binary results format is little endian");
+
+namespace {
+
+template<typename T>
+void appendRaw(std::string &out, const T &value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void appendName(std::string &out, const std::string &name) {
+    appendRaw(out, std::uint32_t(name.size()));
+    out += name;
+}
+
+std::string jsonEscape(const std::string &s) {
+    static const char HEX[] = "0123456789abcdef";
+    std::string escaped;
+    for (char c: s) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += "\\u00";
+            escaped += HEX[static_cast<unsigned char>(c) >> 4];
+            escaped += HEX[c & 0xf];
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+template<typename T>
+bool readRaw(const std::string &in, std::size_t &offset, T &value) {
+    if (in.size() - offset < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, in.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+bool readName(const std::string &in, std::size_t &offset, std::string &name) {
+    std::uint32_t size;
+    if (!readRaw(in, offset, size) || in.size() - offset < size) {
+        return false;
+    }
+    name = in.substr(offset, size);
+    offset += size;
+    return true;
+}
+
+/* the id of 'name' in 'names', added at the end if it is not there yet */
+std::uint32_t nameId(std::vector<std::string> &names, const std::string &name) {
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end()) {
+        names.push_back(name);
+        return std::uint32_t(names.size() - 1);
+    }
+    return std::uint32_t(it - names.begin());
+}
+
+/* a CSV line of formatLine(). The house name may hold commas, the 8 columns after the algorithm do not */
+bool parseCSVLine(const std::string &line, ResultsStream &stream, RunRecord &record) {
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    for (std::size_t comma; (comma = line.find(',', start)) != std::string::npos; start = comma + 1) {
+        fields.push_back(line.substr(start, comma - start));
+    }
+    fields.push_back(line.substr(start));
+    if (fields.size() < 10) {
+        return false;
+    }
+    std::size_t n = fields.size() - 8;
+    std::string house = fields[0];
+    for (std::size_t i = 1; i + 1 < n; i++) {
+        house += ',' + fields[i];
+    }
+    try {
+        record.seed = fields[n].empty() ? NO_SEED : std::stoull(fields[n]);
+        record.score = std::stoll(fields[n + 1]);
+        record.status = parseRunStatus(fields[n + 2]);
+        record.steps = std::stoll(fields[n + 3]);
+        record.dirtLeft = std::stoll(fields[n + 4]);
+        record.wallTimeUs = std::stoull(fields[n + 5]);
+        record.peakBytes = std::stoull(fields[n + 6]);
+        record.allocations = std::stoull(fields[n + 7]);
+    } catch (const std::exception &) {
+        return false;
+    }
+    record.houseId = nameId(stream.houseNames, house);
+    record.algoId = nameId(stream.algoNames, fields[n - 1]);
+    return true;
+}
+
+/* the value of "key" in a JSON line of formatLine(): a string (unescaped) or a number / null as written */
+bool jsonField(const std::string &line, const std::string &key, std::string &value) {
+    std::size_t pos = line.find("\"" + key + "\":");
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos += key.size() + 3;
+    value.clear();
+    if (pos < line.size() && line[pos] == '"') {
+        for (pos++; pos < line.size() && line[pos] != '"'; pos++) {
+            if (line[pos] != '\\') {
+                value += line[pos];
+            } else if (pos + 1 < line.size() && line[pos + 1] == 'u') {
+                if (pos + 6 > line.size()) {
+                    return false;
+                }
+                value += char(std::stoi(line.substr(pos + 2, 4), nullptr, 16));
+                pos += 5;
+            } else if (++pos < line.size()) {
+                value += line[pos];
+            }
+        }
+        return pos < line.size();
+    }
+    std::size_t end = line.find_first_of(",}", pos);
+    if (end == std::string::npos) {
+        return false;
+    }
+    value = line.substr(pos, end - pos);
+    return true;
+}
+
+bool parseJSONLine(const std::string &line, ResultsStream &stream, RunRecord &record) {
+    std::string house, algo, seed, score, status, steps, dirtLeft, wallTime, peakBytes, allocations;
+    try {
+        if (!jsonField(line, "house", house) || !jsonField(line, "algorithm", algo) || !jsonField(line, "seed", seed) ||
+            !jsonField(line, "score", score) || !jsonField(line, "status", status) ||
+            !jsonField(line, "steps", steps) || !jsonField(line, "dirt_left", dirtLeft) ||
+            !jsonField(line, "wall_time_us", wallTime) || !jsonField(line, "peak_bytes", peakBytes) ||
+            !jsonField(line, "allocations", allocations)) {
+            return false;
+        }
+        record.seed = seed == "null" ? NO_SEED : std::stoull(seed);
+        record.score = std::stoll(score);
+        record.status = parseRunStatus(status);
+        record.steps = std::stoll(steps);
+        record.dirtLeft = std::stoll(dirtLeft);
+        record.wallTimeUs = std::stoull(wallTime);
+        record.peakBytes = std::stoull(peakBytes);
+        record.allocations = std::stoull(allocations);
+    } catch (const std::exception &) {
+        return false;
+    }
+    record.houseId = nameId(stream.houseNames, house);
+    record.algoId = nameId(stream.algoNames, algo);
+    return true;
+}
+
+/* the blocks of formatBlock() from 'offset', up to the first incomplete one */
+void readBlocks(const std::string &in, std::size_t offset, ResultsStream &stream) {
+    std::uint32_t count;
+    while (readRaw(in, offset, count)) {
+        constexpr std::size_t RECORD_BYTES = 4 + 4 + 8 + 8 + 1 + 8 + 8 + 8 + 8 + 8;
+        if ((in.size() - offset) / RECORD_BYTES < count) {
+            return; // cut by a crash
+        }
+        std::size_t first = stream.records.size();
+        stream.records.resize(first + count);
+        auto column = [&](auto member) {
+            for (std::size_t i = first; i < stream.records.size(); i++) {
+                readRaw(in, offset, stream.records[i].*member);
+            }
+        };
+        column(&RunRecord::houseId);
+        column(&RunRecord::algoId);
+        column(&RunRecord::seed);
+        column(&RunRecord::score);
+        column(&RunRecord::status);
+        column(&RunRecord::steps);
+        column(&RunRecord::dirtLeft);
+        column(&RunRecord::wallTimeUs);
+        column(&RunRecord::peakBytes);
+        column(&RunRecord::allocations);
+    }
+}
+
+}
+
+RunStatus parseRunStatus(const std::string &status) {
+    if (status == "FINISHED") return RunStatus::Finished;
+    if (status == "WORKING") return RunStatus::Working;
+    if (status == "DEAD") return RunStatus::Dead;
+    if (status == "TIMEOUT") return RunStatus::Timeout;
+    if (status == "ERROR") return RunStatus::Error;
+    return RunStatus::Unknown;
+}
+
+std::string getRunStatusName(RunStatus status) {
+    switch (status) {
+        case RunStatus::Finished: return "FINISHED";
+        case RunStatus::Working: return "WORKING";
+        case RunStatus::Dead: return "DEAD";
+        case RunStatus::Unknown: return "UNKNOWN";
+        case RunStatus::Timeout: return "TIMEOUT";
+        case RunStatus::Error: return "ERROR";
+    }
+    return "UNKNOWN";
+}
+
+ResultsFormat parseResultsFormat(const std::string &format) {
+    if (format == "csv") return ResultsFormat::CSV;
+    if (format == "jsonl") return ResultsFormat::JSONLines;
+    if (format == "bin") return ResultsFormat::Binary;
+    throw std::runtime_error("Invalid results format: " + format + " (expected csv / jsonl / bin)");
+}
+
+ResultsSink::ResultsSink(std::string fileName, ResultsFormat format, std::vector<std::string> houseNames,
+                         std::vector<std::string> algoNames)
+        : fileName(std::move(fileName)), format(format), houseNames(std::move(houseNames)),
+          algoNames(std::move(algoNames)) {
+    block.reserve(BINARY_BLOCK_RECORDS);
+    OutputWriter::getOutputWriter().write(this->fileName, formatHeader(), OutputWriter::Mode::Truncate);
+}
+
+ResultsSink::~ResultsSink() {
+    close();
+}
+
+void ResultsSink::append(const RunRecord &record) {
+    if (format != ResultsFormat::Binary) {
+        OutputWriter::getOutputWriter().write(fileName, formatLine(format, record, houseNames[record.houseId], algoNames[record.algoId]), OutputWriter::Mode::Append);
+        return;
+    }
+    std::vector<RunRecord> fullBlock;
+    {
+        std::lock_guard<std::mutex> lock(blockMutex);
+        block.push_back(record);
+        if (block.size() < BINARY_BLOCK_RECORDS) {
+            return;
+        }
+        fullBlock.swap(block);
+        block.reserve(BINARY_BLOCK_RECORDS);
+    }
+    OutputWriter::getOutputWriter().write(fileName, formatBlock(fullBlock), OutputWriter::Mode::Append);
+}
+
+void ResultsSink::close() {
+    std::lock_guard<std::mutex> lock(blockMutex);
+    if (closed) {
+        return;
+    }
+    closed = true;
+    if (!block.empty()) {
+        OutputWriter::getOutputWriter().write(fileName, formatBlock(block), OutputWriter::Mode::Append);
+        block.clear();
+    }
+}
+
+std::string ResultsSink::formatHeader() const {
+    std::string header;
+    switch (format) {
+        case ResultsFormat::CSV:
+            header = "house,algorithm,seed,score,status,steps,dirt_left,wall_time_us,peak_bytes,allocations\n";
+            break;
+        case ResultsFormat::JSONLines:
+            break;
+        case ResultsFormat::Binary:
+            header = "MRRS";
+            appendRaw(header, BINARY_VERSION);
+            appendRaw(header, std::uint32_t(houseNames.size()));
+            for (const auto &name: houseNames) {
+                appendName(header, name);
+            }
+            appendRaw(header, std::uint32_t(algoNames.size()));
+            for (const auto &name: algoNames) {
+                appendName(header, name);
+            }
+            break;
+    }
+    return header;
+}
+
+std::string ResultsSink::formatLine(ResultsFormat format, const RunRecord &record, const std::string &house,
+                                    const std::string &algo) {
+    std::ostringstream line;
+    if (format == ResultsFormat::CSV) {
+        line << house << ',' << algo << ',';
+        if (record.seed != NO_SEED) {
+            line << record.seed;
+        }
+        line << ',' << record.score << ',' << getRunStatusName(record.status) << ','
+             << record.steps << ',' << record.dirtLeft << ',' << record.wallTimeUs << ',' << record.peakBytes << ','
+             << record.allocations << '\n';
+    } else {
+        line << "{\"house\":\"" << jsonEscape(house) << "\",\"algorithm\":\"" << jsonEscape(algo) << "\",\"seed\":";
+        if (record.seed != NO_SEED) {
+            line << record.seed;
+        } else {
+            line << "null";
+        }
+        line << ",\"score\":" << record.score << ",\"status\":\"" << getRunStatusName(record.status)
+             << "\",\"steps\":" << record.steps << ",\"dirt_left\":" << record.dirtLeft
+             << ",\"wall_time_us\":" << record.wallTimeUs << ",\"peak_bytes\":" << record.peakBytes
+             << ",\"allocations\":" << record.allocations << "}\n";
+    }
+    return line.str();
+}
+
+std::string ResultsSink::formatBlock(const std::vector<RunRecord> &records) {
+    std::string out;
+    appendRaw(out, std::uint32_t(records.size()));
+    for (const auto &r: records) appendRaw(out, r.houseId);
+    for (const auto &r: records) appendRaw(out, r.algoId);
+    for (const auto &r: records) appendRaw(out, r.seed);
+    for (const auto &r: records) appendRaw(out, r.score);
+    for (const auto &r: records) appendRaw(out, std::uint8_t(r.status));
+    for (const auto &r: records) appendRaw(out, r.steps);
+    for (const auto &r: records) appendRaw(out, r.dirtLeft);
+    for (const auto &r: records) appendRaw(out, r.wallTimeUs);
+    for (const auto &r: records) appendRaw(out, r.peakBytes);
+    for (const auto &r: records) appendRaw(out, r.allocations);
+    return out;
+}
+
+ResultsStream readResultsStream(const std::string &fileName, ResultsFormat format) {
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + fileName);
+    }
+    ResultsStream stream;
+    if (format == ResultsFormat::Binary) {
+        std::ostringstream content;
+        content << file.rdbuf();
+        const std::string in = content.str();
+        std::size_t offset = 4;
+        std::uint32_t version, numOfNames;
+        if (in.size() < 4 || in.compare(0, 4, "MRRS") != 0 || !readRaw(in, offset, version)) {
+            throw std::runtime_error(fileName + " is not a binary results stream");
+        }
+        if (version != ResultsSink::BINARY_VERSION) {
+            throw std::runtime_error("Unsupported results stream version " + std::to_string(version));
+        }
+        for (auto *names: {&stream.houseNames, &stream.algoNames}) {
+            if (!readRaw(in, offset, numOfNames)) {
+                throw std::runtime_error(fileName + ": truncated header");
+            }
+            names->resize(numOfNames);
+            for (std::string &name: *names) {
+                if (!readName(in, offset, name)) {
+                    throw std::runtime_error(fileName + ": truncated header");
+                }
+            }
+        }
+        readBlocks(in, offset, stream);
+        for (const RunRecord &record: stream.records) {
+            if (record.houseId >= stream.houseNames.size() || record.algoId >= stream.algoNames.size()) {
+                throw std::runtime_error(fileName + ": record of an unknown house or algorithm");
+            }
+        }
+        return stream;
+    }
+    std::string line;
+    if (format == ResultsFormat::CSV) {
+        std::getline(file, line); // the header
+    }
+    while (std::getline(file, line)) {
+        if (file.eof()) {
+            break; // no '\n': the last line was cut by a crash
+        }
+        RunRecord record;
+        if (format == ResultsFormat::CSV ? parseCSVLine(line, stream, record)
+                                         : parseJSONLine(line, stream, record)) {
+            stream.records.push_back(record);
+        }
+    }
+    return stream;
+}
@@ -0,0 +1,101 @@
+#ifndef ASSIGNMENT3_RESULTSSINK_H
+#define ASSIGNMENT3_RESULTSSINK_H
+
+#include <cstdint>
+#include <climits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class RunStatus : std::uint8_t { Finished, Working, Dead, Unknown, Timeout, Error };
+
+enum class ResultsFormat { CSV, JSONLines, Binary };
+
+RunStatus parseRunStatus(const std::string &status);
+
+std::string getRunStatusName(RunStatus status);
+
+ResultsFormat parseResultsFormat(const std::string &format);
+
+// seed of the runs of algorithms that were not seeded
+constexpr std::uint64_t NO_SEED = UINT64_MAX;
+
+/* The result of one simulation (one house x algorithm task, or one seed of it with -seeds) */
+struct RunRecord {
+    std::uint32_t houseId = 0;
+    std::uint32_t algoId = 0;
+    std::uint64_t seed = NO_SEED;
+    std::int64_t score = 0;
+    RunStatus status = RunStatus::Unknown;
+    std::int64_t steps = 0;
+    std::int64_t dirtLeft = 0;
+    std::uint64_t wallTimeUs = 0;
+    std::uint64_t peakBytes = 0; // heap peak of the algorithm (0 unless -track_memory)
+    std::uint64_t allocations = 0; // number of allocations of the algorithm (0 unless -track_memory)
+};
+
+/* Streams every RunRecord to a file as soon as its task completes, so a run that dies midway keeps the
+ * results of the tasks that finished (tools/results_summary rebuilds summary.csv from them). The file is appended
+ * through the OutputWriter thread.
+ * Formats:
+ * - CSV: header line, then house,algorithm,seed,score,status,steps,dirt_left,wall_time_us,peak_bytes,allocations
+ *   (seed is empty if unseeded)
+ * - JSONLines: one JSON object per record (seed is null if unseeded)
+ * - Binary (columnar): "MRRS" magic, u32 version, u32 house count + names, u32 algorithm count + names
+ *   (u32 length + bytes each), then blocks of up to BINARY_BLOCK_RECORDS records:
+ *   u32 count, u32 houseId[count], u32 algoId[count], u64 seed[count], i64 score[count], u8 status[count],
+ *   i64 steps[count], i64 dirtLeft[count], u64 wallTimeUs[count], u64 peakBytes[count], u64 allocations[count].
+ *   All little endian, NO_SEED if unseeded.
+ *   The records are written a block at a time, so a run that dies midway loses the (up to BINARY_BLOCK_RECORDS - 1)
+ *   records of its last block: use CSV or JSONLines when every finished task must be kept. */
+class ResultsSink {
+public:
+    static constexpr std::uint32_t BINARY_VERSION = 4;
+    static constexpr std::size_t BINARY_BLOCK_RECORDS = 64;
+
+    ResultsSink(std::string fileName, ResultsFormat format, std::vector<std::string> houseNames,
+                std::vector<std::string> algoNames);
+
+    ~ResultsSink();
+
+    ResultsSink(const ResultsSink &) = delete;
+
+    ResultsSink &operator=(const ResultsSink &) = delete;
+
+    /* thread safe */
+    void append(const RunRecord &record);
+
+    /* write the last (partial) binary block */
+    void close();
+
+    /* one CSV or JSONLines line (with its '\n') */
+    static std::string formatLine(ResultsFormat format, const RunRecord &record, const std::string &houseName,
+                                  const std::string &algoName);
+
+private:
+    std::string fileName;
+    ResultsFormat format;
+    std::vector<std::string> houseNames;
+    std::vector<std::string> algoNames;
+    std::mutex blockMutex;
+    std::vector<RunRecord> block; // binary format only
+    bool closed = false;
+
+    std::string formatHeader() const;
+
+    static std::string formatBlock(const std::vector<RunRecord> &records);
+};
+
+/* The records of a results stream, their houseId / algoId index the names */
+struct ResultsStream {
+    std::vector<std::string> houseNames;
+    std::vector<std::string> algoNames;
+    std::vector<RunRecord> records;
+};
+
+/* Reads a results stream written by ResultsSink in 'format'. The binary format gives the names of its header, the
+ * text formats the names of their records, in the order they first appear. A line or block cut by a crash is
+ * ignored. Throws std::runtime_error if the file cannot be read or is not a binary stream of this version */
+ResultsStream readResultsStream(const std::string &fileName, ResultsFormat format);
+
+#endif //ASSIGNMENT3_RESULTSSINK_H
@@ -0,0 +1,241 @@
+#include "RunTrace.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little, "the run trace format is little endian");
+
+namespace {
+
+constexpr char MAGIC[] = "MRRT";
+
+template<typename T>
+void appendRaw(std::string &out, const T &value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void appendName(std::string &out, const std::string &name) {
+    appendRaw(out, std::uint32_t(name.size()));
+    out += name;
+}
+
+/* reads the fields of a trace in order, throws on a truncated trace */
+class Reader {
+public:
+    explicit Reader(const std::string &in) : in(in) {}
+
+    template<typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string readName() {
+        auto size = read<std::uint32_t>();
+        return std::string(take(size), size);
+    }
+
+    const char *take(std::size_t size) {
+        if (size > in.size() - position) {
+            throw std::runtime_error("Truncated run trace");
+        }
+        const char *data = in.data() + position;
+        position += size;
+        return data;
+    }
+
+private:
+    const std::string &in;
+    std::size_t position = 0;
+};
+
+}
+
+RunTraceRecorder::RunTraceRecorder(RunTraceHeader header, const Grid<char> &layout, const DirtIndex &dirt)
+        : header(std::move(header)) {
+    this->header.rows = layout.getRows();
+    this->header.cols = layout.getCols();
+    this->header.keyframeInterval = std::max<std::uint32_t>(MIN_KEYFRAME_INTERVAL,
+                                                            std::uint32_t(dirt.getDirtyCells()));
+    cells.reserve(std::size_t(this->header.rows) * this->header.cols);
+    for (int r = 0; r < this->header.rows; r++) {
+        for (int c = 0; c < this->header.cols; c++) {
+            cells += layout.at(r, c);
+        }
+    }
+}
+
+void RunTraceRecorder::recordStep(Step step, const RunTraceState &state, const Grid<char> &layout,
+                                  const DirtIndex &dirt) {
+    if (numOfSteps % 2 == 0) {
+        steps.push_back(std::uint8_t(step));
+    } else {
+        steps.back() |= std::uint8_t(std::uint8_t(step) << 4);
+    }
+    numOfSteps++;
+    if (numOfSteps % header.keyframeInterval != 0) {
+        return;
+    }
+    appendRaw(keyframes, std::int32_t(state.row));
+    appendRaw(keyframes, std::int32_t(state.col));
+    appendRaw(keyframes, state.batteryLevel);
+    appendRaw(keyframes, std::int64_t(state.dirtLeft));
+    appendRaw(keyframes, std::uint32_t(dirt.getDirtyCells()));
+    dirt.forEachDirtyCell([&](int row, int col) {
+        appendRaw(keyframes, std::uint32_t(std::size_t(row) * header.cols + col));
+        appendRaw(keyframes, std::uint8_t(layout.at(row, col) - '0'));
+    });
+    numOfKeyframes++;
+}
+
+std::string RunTraceRecorder::finish() const {
+    std::string out;
+    out.reserve(64 + cells.size() + steps.size() + keyframes.size());
+    out.append(MAGIC, 4);
+    appendRaw(out, RunTraceHeader::VERSION);
+    appendName(out, header.houseName);
+    appendName(out, header.algoName);
+    appendRaw(out, header.seed);
+    appendRaw(out, header.maxSteps);
+    appendRaw(out, header.maxBattery);
+    appendRaw(out, header.rows);
+    appendRaw(out, header.cols);
+    appendRaw(out, header.dockRow);
+    appendRaw(out, header.dockCol);
+    appendRaw(out, header.keyframeInterval);
+    out += cells;
+    appendRaw(out, numOfSteps);
+    out.append(reinterpret_cast<const char *>(steps.data()), steps.size());
+    appendRaw(out, numOfKeyframes);
+    out += keyframes;
+    return out;
+}
+
+RunTracePlayer::RunTracePlayer(const std::string &content) {
+    Reader reader(content);
+    if (std::memcmp(reader.take(4), MAGIC, 4) != 0) {
+        throw std::runtime_error("Not a run trace");
+    }
+    auto version = reader.read<std::uint32_t>();
+    if (version != RunTraceHeader::VERSION) {
+        throw std::runtime_error("Unsupported run trace version " + std::to_string(version));
+    }
+    header.houseName = reader.readName();
+    header.algoName = reader.readName();
+    header.seed = reader.read<std::uint64_t>();
+    header.maxSteps = reader.read<std::int64_t>();
+    header.maxBattery = reader.read<std::int32_t>();
+    header.rows = reader.read<std::int32_t>();
+    header.cols = reader.read<std::int32_t>();
+    header.dockRow = reader.read<std::int32_t>();
+    header.dockCol = reader.read<std::int32_t>();
+    header.keyframeInterval = reader.read<std::uint32_t>();
+    if (header.rows < 0 || header.cols < 0 || header.keyframeInterval == 0) {
+        throw std::runtime_error("Invalid run trace header");
+    }
+    std::size_t numOfCells = std::size_t(header.rows) * std::size_t(header.cols);
+    initialCells.assign(reader.take(numOfCells), numOfCells);
+    for (std::size_t i = 0; i < numOfCells; i++) {
+        if (initialCells[i] >= '1' && initialCells[i] <= '9') {
+            initiallyDirty.push_back(std::uint32_t(i));
+        }
+    }
+
+    numOfSteps = reader.read<std::uint64_t>();
+    const char *packed = reader.take((numOfSteps + 1) / 2);
+    steps.assign(packed, packed + (numOfSteps + 1) / 2);
+
+    auto numOfKeyframes = reader.read<std::uint32_t>();
+    keyframes.resize(numOfKeyframes);
+    for (std::uint32_t k = 0; k < numOfKeyframes; k++) {
+        Keyframe &keyframe = keyframes[k];
+        keyframe.state.step = std::uint64_t(k + 1) * header.keyframeInterval;
+        keyframe.state.row = reader.read<std::int32_t>();
+        keyframe.state.col = reader.read<std::int32_t>();
+        keyframe.state.batteryLevel = reader.read<float>();
+        keyframe.state.dirtLeft = reader.read<std::int64_t>();
+        keyframe.dirtyCells.resize(reader.read<std::uint32_t>());
+        for (auto &[cell, level]: keyframe.dirtyCells) {
+            cell = reader.read<std::uint32_t>();
+            level = reader.read<std::uint8_t>();
+            if (cell >= numOfCells) {
+                throw std::runtime_error("Invalid run trace keyframe");
+            }
+        }
+    }
+    seek(0);
+}
+
+void RunTracePlayer::seek(std::uint64_t step) {
+    step = std::min(step, numOfSteps);
+    std::uint64_t k = std::min<std::uint64_t>(step / header.keyframeInterval, keyframes.size());
+    if (k == 0) {
+        cells = initialCells;
+        state = RunTraceState{0, header.dockRow, header.dockCol, float(header.maxBattery), 0};
+        for (std::uint32_t cell: initiallyDirty) {
+            state.dirtLeft += cells[cell] - '0';
+        }
+    } else {
+        // only the initially dirty cells differ between two keyframes
+        if (cells.size() != initialCells.size()) {
+            cells = initialCells;
+        }
+        for (std::uint32_t cell: initiallyDirty) {
+            cells[cell] = '0';
+        }
+        const Keyframe &keyframe = keyframes[k - 1];
+        for (const auto &[cell, level]: keyframe.dirtyCells) {
+            cells[cell] = char('0' + level);
+        }
+        state = keyframe.state;
+    }
+    while (state.step < step) {
+        stepForward();
+    }
+}
+
+/* the same rules as Simulator::run() */
+bool RunTracePlayer::stepForward() {
+    if (state.step >= numOfSteps) {
+        return false;
+    }
+    const float maxBattery = float(header.maxBattery);
+    switch (getStep(state.step)) {
+        case Step::North:
+            state.row--;
+            state.batteryLevel -= 1;
+            break;
+        case Step::East:
+            state.col++;
+            state.batteryLevel -= 1;
+            break;
+        case Step::South:
+            state.row++;
+            state.batteryLevel -= 1;
+            break;
+        case Step::West:
+            state.col--;
+            state.batteryLevel -= 1;
+            break;
+        case Step::Stay:
+            if (state.row == header.dockRow && state.col == header.dockCol) {
+                state.batteryLevel = std::min(state.batteryLevel + maxBattery / 20, maxBattery);
+            } else {
+                state.batteryLevel -= 1;
+                char &cell = cells[std::size_t(state.row) * header.cols + state.col];
+                if (cell >= '1' && cell <= '9') {
+                    cell--;
+                    state.dirtLeft--;
+                }
+            }
+            break;
+        case Step::Finish:
+            break;
+    }
+    state.step++;
+    return true;
+}
@@ -0,0 +1,113 @@
+#ifndef ASSIGNMENT3_RUNTRACE_H
+#define ASSIGNMENT3_RUNTRACE_H
+
+#include "Grid.h"
+#include "DirtIndex.h"
+#include "enums.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Run traces: a whole run (house, steps and periodic keyframes of its state) in a compact file, so it can be played
+ * back from any step, at any speed, without the algorithm (tools/run_player.cpp).
+ * - the steps are packed two per byte (the Step value in a nibble), a 2M step run is 1MB of steps
+ * - a keyframe every 'keyframeInterval' steps holds the position, the battery, the dirt left and the level of every
+ *   cell that is still dirty. The interval is at least the number of dirty cells of the house, so the keyframes
+ *   never take more room than the steps (times the few bytes of a cell entry)
+ * Seeking to step n loads keyframe n / interval and replays at most interval - 1 steps from it, whatever the length
+ * of the run. File layout (little endian): "MRRT", u32 version, the header fields (names as u32 length + bytes),
+ * the house cells (rows x cols chars, row major), u64 number of steps, the packed steps, u32 number of keyframes,
+ * then every keyframe: i32 row, i32 col, f32 battery, i64 dirt left, u32 dirty cells, (u32 cell index, u8 level)* */
+struct RunTraceHeader {
+    static constexpr std::uint32_t VERSION = 2;
+
+    std::string houseName;
+    std::string algoName;
+    std::uint64_t seed = 0;
+    std::int64_t maxSteps = 0;
+    std::int32_t maxBattery = 0;
+    std::int32_t rows = 0;
+    std::int32_t cols = 0;
+    std::int32_t dockRow = 0;
+    std::int32_t dockCol = 0;
+    std::uint32_t keyframeInterval = 0;
+};
+
+/* The state of the run after a number of steps */
+struct RunTraceState {
+    std::uint64_t step = 0; // number of steps played (Finish included)
+    int row = 0;
+    int col = 0;
+    float batteryLevel = 0;
+    long long dirtLeft = 0;
+};
+
+/* Records the run of a Simulator, fed after every step */
+class RunTraceRecorder {
+public:
+    // keyframes are never closer than this, so small houses don't pay for a keyframe every few steps
+    static constexpr std::uint32_t MIN_KEYFRAME_INTERVAL = 4096;
+
+    /* 'layout' is the house grid at the start of the run (the houseName / algoName / seed / limits of 'header' are
+     * set by the caller, the dimensions, dock and interval are filled in) */
+    RunTraceRecorder(RunTraceHeader header, const Grid<char> &layout, const DirtIndex &dirt);
+
+    /* 'state' is the state after 'step', 'layout' / 'dirt' the house then */
+    void recordStep(Step step, const RunTraceState &state, const Grid<char> &layout, const DirtIndex &dirt);
+
+    /* the trace file content */
+    std::string finish() const;
+
+private:
+    RunTraceHeader header;
+    std::string cells; // row major
+    std::vector<std::uint8_t> steps; // two per byte
+    std::uint64_t numOfSteps = 0;
+    std::string keyframes; // serialized
+    std::uint32_t numOfKeyframes = 0;
+};
+
+/* Plays a run trace: seek() to any step, then stepForward() */
+class RunTracePlayer {
+public:
+    /* throws std::runtime_error if 'content' is not a valid run trace */
+    explicit RunTracePlayer(const std::string &content);
+
+    const RunTraceHeader &getHeader() const { return header; }
+
+    std::uint64_t getNumOfSteps() const { return numOfSteps; }
+
+    std::size_t getNumOfKeyframes() const { return keyframes.size(); }
+
+    Step getStep(std::uint64_t index) const {
+        return Step((steps[index >> 1] >> ((index & 1) * 4)) & 0xF);
+    }
+
+    /* the state after 'step' steps (clamped to the run), from the closest keyframe before it */
+    void seek(std::uint64_t step);
+
+    /* plays the next step, false at the end of the run */
+    bool stepForward();
+
+    const RunTraceState &getState() const { return state; }
+
+    /* the house cell (wall, dock or current dirt level), row major */
+    char getCell(int row, int col) const { return cells[std::size_t(row) * header.cols + col]; }
+
+private:
+    struct Keyframe {
+        RunTraceState state;
+        std::vector<std::pair<std::uint32_t, std::uint8_t>> dirtyCells;
+    };
+
+    RunTraceHeader header;
+    std::string initialCells;
+    std::vector<std::uint32_t> initiallyDirty; // the cells dirty at step 0, reset on every seek
+    std::vector<std::uint8_t> steps;
+    std::uint64_t numOfSteps = 0;
+    std::vector<Keyframe> keyframes; // keyframes[k] is the state after (k + 1) * keyframeInterval steps
+    std::string cells;
+    RunTraceState state;
+};
+
+#endif //ASSIGNMENT3_RUNTRACE_H
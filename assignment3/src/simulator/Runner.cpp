@@ -0,0 +1,632 @@
+#include "Runner.h"
+#include "Simulator.h"
+#include "TaskScheduler.h"
+#include "Tracer.h"
+#include <random>
+
+/* What a worker and the simulation thread it starts share. Owned by both: a thread that does not end after its
+ * cancellation outlives the task, see Runner::abandonRun() */
+struct SimulationState {
+    std::mutex m;
+    std::condition_variable cv;
+    bool finished = false; // run() returned, 'score' is set
+    bool ended = false; // the thread is out of the simulator: finished or unwound by its cancellation
+    std::int64_t score = -1;
+    // the nextStep() latencies of this run, merged into the worker's metrics once the thread is joined. An
+    // abandoned thread keeps recording into it, never into the metrics
+    LatencyHistogram stepLatency;
+};
+
+namespace {
+
+// how long a worker waits for a cancelled simulation thread to unwind before abandoning it
+constexpr std::chrono::milliseconds CANCEL_WAIT(1000);
+
+template<typename Policy>
+void runSim(Simulator *simulator, std::shared_ptr<SimulationState> state) {
+    // set when the thread leaves the simulator, also while it unwinds from a cancellation
+    struct EndGuard {
+        SimulationState &state;
+
+        ~EndGuard() {
+            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, nullptr);
+            std::lock_guard<std::mutex> lock(state.m);
+            state.ended = true;
+            state.cv.notify_all();
+        }
+    } endGuard{*state};
+
+    // Making the thread cancelable
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, nullptr);
+    pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, nullptr);
+
+    // Run the simulation and save the score
+    std::int64_t score = simulator->run<Policy>();
+
+    // Not cancelled while it holds the lock the worker waits on
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, nullptr);
+    std::lock_guard<std::mutex> lock(state->m);
+    state->score = score;
+    state->finished = true;
+    state->cv.notify_all();
+}
+
+/* a random seed, never NO_SEED */
+std::uint64_t drawSeed() {
+    std::random_device device;
+    std::uint64_t seed = (std::uint64_t(device()) << 32) | device();
+    return seed == NO_SEED ? 0 : seed;
+}
+
+/* writes the snapshots of a run to 'path', called from the simulation thread. The snapshot is written to
+ * <path>.tmp and renamed over 'path', so a crash or a kill in the middle of the write leaves the last complete
+ * checkpoint. It is written here rather than by the OutputWriter, so the checkpoint is on disk once this returns */
+void writeCheckpoint(const std::string &path, const std::string &snapshot) {
+    // a timeout must not cancel the thread in the middle of the write
+    int cancelState;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+    std::string tmpPath = path + ".tmp";
+    bool written;
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        written = file.write(snapshot.data(), std::streamsize(snapshot.size())) && file.flush();
+    }
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(tmpPath, path, error);
+    }
+    if (!written || error) {
+        std::cerr << "Failed to write the checkpoint " << path << std::endl;
+        std::filesystem::remove(tmpPath, error);
+    }
+    pthread_setcancelstate(cancelState, nullptr);
+}
+
+std::string readCheckpoint(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/* true if 'fileName' is the complete output file of a run that ended with 'record' (see Simulator::writeOutputFile):
+ * same NumSteps, DirtLeft, Status and Score, and all the steps, with or without the final 'F' */
+bool isOutputOf(const std::string &fileName, const RunRecord &record) {
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string numSteps, dirtLeft, status, inDock, score;
+    if (!std::getline(file, numSteps) || !std::getline(file, dirtLeft) || !std::getline(file, status) ||
+        !std::getline(file, inDock) || !std::getline(file, score)) {
+        return false;
+    }
+    if (numSteps != "NumSteps = " + std::to_string(record.steps) ||
+        dirtLeft != "DirtLeft = " + std::to_string(record.dirtLeft) ||
+        status != "Status = " + getRunStatusName(record.status) ||
+        score != "Score = " + std::to_string(record.score)) {
+        return false;
+    }
+    // "Steps: " + the steps + '\n', cut if the process died while the file was written
+    std::error_code error;
+    auto size = std::filesystem::file_size(fileName, error);
+    auto stepsStart = std::uint64_t(file.tellg()) + 7;
+    if (error || size < stepsStart + 1) {
+        return false;
+    }
+    auto steps = size - stepsStart - 1;
+    return steps == std::uint64_t(record.steps) || steps == std::uint64_t(record.steps) + 1;
+}
+
+/* the heap use of the algorithm in the last run of 'simulator', if it is tracked */
+void readMemoryUse(const Simulator &simulator, RunRecord &record) {
+    if (const MemoryTracker *tracker = simulator.getMemoryTracker()) {
+        record.peakBytes = tracker->getPeakBytes();
+        record.allocations = tracker->getAllocations();
+    }
+}
+
+}
+
+Runner::Runner(RunnerOptions options) : options(std::move(options)), topology(CpuTopology::detect()) {
+    // A worker and the simulation thread it waits for take one core together
+    if (this->options.numOfThreads <= 0) {
+        this->options.numOfThreads = int(topology.getNumOfCores());
+    }
+    if (!this->options.cachePath.empty()) {
+        cache = std::make_unique<ResultCache>(this->options.cachePath);
+    }
+    if (!this->options.sensorTraceDir.empty()) {
+        std::filesystem::create_directories(this->options.sensorTraceDir);
+    }
+    if (!this->options.runTraceDir.empty()) {
+        std::filesystem::create_directories(this->options.runTraceDir);
+    }
+    if (!this->options.coverageDir.empty()) {
+        std::filesystem::create_directories(this->options.coverageDir);
+    }
+    if (!this->options.checkpointDir.empty()) {
+        std::filesystem::create_directories(this->options.checkpointDir);
+    }
+}
+
+/* The abandoned simulations are joined and destroyed now if they ended, otherwise left to the process exit: their
+ * thread still uses them */
+Runner::~Runner() {
+    std::lock_guard<std::mutex> lock(abandonedMutex);
+    for (AbandonedRun &run: abandonedRuns) {
+        std::unique_lock<std::mutex> stateLock(run.state->m);
+        if (run.state->cv.wait_for(stateLock, CANCEL_WAIT, [&run]() { return run.state->ended; })) {
+            stateLock.unlock();
+            run.thread.join();
+        } else {
+            stateLock.unlock();
+            leaveRunning(run);
+        }
+    }
+    abandonedRuns.clear();
+}
+
+void Runner::loadAlgorithms() {
+    algorithms.loadDirectory(options.algoDirPath, cache != nullptr);
+}
+
+std::size_t Runner::reloadAlgorithms() {
+    return algorithms.reloadChangedLibraries(cache != nullptr);
+}
+
+void Runner::discoverHouses() {
+    auto addIfHouseFile = [this](const std::filesystem::directory_entry &entry) {
+        if (entry.is_regular_file() && entry.path().extension() == ".house") {
+            housePaths.push_back(entry.path());
+        }
+    };
+    if (options.recursiveScan) {
+        for (const auto &entry: std::filesystem::recursive_directory_iterator(
+                options.houseDirPath, std::filesystem::directory_options::skip_permission_denied)) {
+            addIfHouseFile(entry);
+        }
+    } else {
+        for (const auto &entry: std::filesystem::directory_iterator(options.houseDirPath)) {
+            addIfHouseFile(entry);
+        }
+    }
+
+    if (housePaths.empty()) {
+        throw std::runtime_error("Cannot find .house files in " + std::filesystem::current_path().string());
+    }
+    houses.resize(housePaths.size());
+    houseStates.assign(housePaths.size(), HouseState::Unchecked);
+}
+
+void Runner::preloadHouses() {
+    Job job;
+    for (std::size_t houseId = 0; houseId < housePaths.size(); houseId++) {
+        job.houseIds.push_back(houseId);
+    }
+    run(job, nullptr);
+}
+
+Job Runner::makeFullJob() const {
+    Job job;
+    for (std::size_t houseId = 0; houseId < housePaths.size(); houseId++) {
+        job.houseIds.push_back(houseId);
+    }
+    for (std::size_t algoId = 0; algoId < algorithms.count(); algoId++) {
+        job.algoIds.push_back(algoId);
+    }
+    job.numOfSeeds = options.numOfSeeds;
+    job.summaryOnly = options.summaryOnly;
+    return job;
+}
+
+void Runner::pinWorkerThread(std::size_t workerIndex) const {
+    if (options.pinThreads && !CpuTopology::pinCurrentThread(topology.getWorkerCpu(workerIndex))) {
+        std::cerr << "Failed to pin worker " << workerIndex << " to CPU " << topology.getWorkerCpu(workerIndex)
+                  << std::endl;
+    }
+}
+
+std::string Runner::getHouseName(std::size_t houseId) const {
+    const std::filesystem::path &path = housePaths[houseId];
+    if (!options.recursiveScan) {
+        return path.filename().string();
+    }
+    std::string name = std::filesystem::relative(path, options.houseDirPath).string();
+    std::replace(name.begin(), name.end(), '/', '_');
+    return name;
+}
+
+std::vector<std::string> Runner::getHouseNames() const {
+    std::vector<std::string> names;
+    for (std::size_t houseId = 0; houseId < housePaths.size(); houseId++) {
+        names.push_back(getHouseName(houseId));
+    }
+    return names;
+}
+
+std::vector<std::string> Runner::getAlgorithmNames() const {
+    return algorithms.getNames();
+}
+
+JobResults Runner::run(const Job &job, const RecordCallback &onRecord) {
+    JobResults jobResults;
+    const std::size_t numOfRuns = std::max(job.numOfSeeds, 1);
+    // One preallocated results cell per house x algorithm x run, the houses get their cells before they are validated
+    jobResults.results.reset(job.houseIds.size(), job.algoIds.size(), numOfRuns);
+    TaskScheduler scheduler(job.houseIds.size(), job.algoIds.size() * numOfRuns);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.numOfThreads; ++i) {
+        threads.emplace_back(&Runner::worker, this, std::size_t(i), std::cref(job), std::ref(scheduler), std::ref(jobResults.results),
+                             std::cref(onRecord));
+    }
+
+    // Join the threads
+    for (auto &t: threads) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+
+    // The results of this job are looked up by the next ones
+    if (cache) {
+        cache->commit();
+    }
+    for (std::size_t i = 0; i < job.houseIds.size(); i++) {
+        jobResults.validHouses.push_back(scheduler.isValid(i));
+    }
+    return jobResults;
+}
+
+/* returns FALSE (and writes the .error file) if the house file cannot be opened or is invalid.
+ * Otherwise houses[houseId] holds the parsed house, kept for the simulations of this job and the next ones */
+bool Runner::validateHouse(std::size_t houseId) {
+    const std::filesystem::path &path = housePaths[houseId];
+    House &house = houses[houseId];
+    std::string errorFileName = path.stem().string() + ".error";
+    // Try to open the .house file
+    std::ifstream currHouseFile(path);
+    if (!currHouseFile.is_open()) {
+        writeError(errorFileName, "Failed to open house file: " + path.string());
+        return false;
+    }
+    currHouseFile.close();
+    // Test if the house file is valid, and keep it parsed for the simulations
+    if (!readHouse(path, options.gridLayout, house)) {
+        writeError(errorFileName, "Invalid house file: " + path.string());
+        return false;
+    }
+    house.fileName = getHouseName(houseId);
+    if (cache) {
+        house.contentHash = ResultCache::hashFile(path);
+    }
+    return true;
+}
+
+/* Every worker first validates houses, then runs simulations, both handed out by the scheduler (which works with
+ * positions in job.houseIds). Task k of a house runs seed (k % R) of algorithm (k / R), R being the runs per pair
+ * (1 without seeds). Workers publish the score into their own cell of the results matrix, without any lock.
+ * Seeds interleave, so the runs of a pair spread over all the workers */
+void Runner::worker(std::size_t workerIndex, const Job &job, TaskScheduler &scheduler, ResultsMatrix &results,
+                    const RecordCallback &onRecord) {
+    // Pinned before anything is allocated, so the worker's simulator is placed on its NUMA node (first touch),
+    // and its simulation threads start on its CPU
+    pinWorkerThread(workerIndex);
+    Tracer::getTracer().setThreadName("worker " + std::to_string(workerIndex));
+
+    // Validate houses first: every valid house unlocks its simulations for all the workers.
+    // Houses validated by an earlier job are published at once
+    std::size_t houseIndex;
+    while (scheduler.claimHouse(houseIndex)) {
+        std::size_t houseId = job.houseIds[houseIndex];
+        if (houseStates[houseId] == HouseState::Unchecked) {
+            TraceSpan span("validate house");
+            if (span.isActive()) {
+                span.setArgs(Tracer::args({{"house", housePaths[houseId].string()}}));
+            }
+            houseStates[houseId] = validateHouse(houseId) ? HouseState::Valid : HouseState::Invalid;
+        }
+        const bool valid = houseStates[houseId] == HouseState::Valid;
+        // only a valid house has tasks, queued before they can be claimed
+        if (metrics && valid) {
+            metrics->tasksQueued(job.algoIds.size() * results.getRuns());
+        }
+        scheduler.houseValidated(houseIndex, valid);
+    }
+
+    // Each worker keeps one simulator for all its tasks, so its buffers are allocated once (by this thread)
+    auto simulator = std::make_unique<Simulator>();
+    const std::size_t numOfRuns = results.getRuns();
+    std::size_t taskInHouse;
+    const bool tracing = Tracer::getTracer().isEnabled();
+    auto waitStart = std::chrono::steady_clock::now();
+    while (scheduler.nextTask(houseIndex, taskInHouse)) {
+        if (metrics || tracing) {
+            auto now = std::chrono::steady_clock::now();
+            if (metrics) {
+                metrics->taskClaimed(workerIndex, std::chrono::duration_cast<std::chrono::microseconds>(
+                        now - waitStart).count());
+            }
+            Tracer::getTracer().complete("queue wait", waitStart, now);
+            waitStart = now;
+        }
+        std::size_t run = taskInHouse % numOfRuns;
+        std::size_t algoIndex = taskInHouse / numOfRuns;
+        std::size_t houseId = job.houseIds[houseIndex];
+        std::size_t algoId = job.algoIds[algoIndex];
+        const bool seeded = job.numOfSeeds > 0 && isAlgorithmSeedable(algoId);
+        if (run > 0 && !seeded) {
+            continue; // an algorithm that cannot be seeded gives the same run for every seed, run it once
+        }
+        // only the first seed of a pair writes the output file, the others would overwrite it
+        RunRecord record = runOne(workerIndex, houseId, algoId, seeded ? run : NO_SEED,
+                                  !job.summaryOnly && run == 0, simulator);
+        // the summary is built from the same records that are streamed
+        results.setScore(houseIndex, algoIndex, record.score, run);
+        if (onRecord) {
+            onRecord(record);
+        }
+        waitStart = std::chrono::steady_clock::now();
+    }
+}
+
+RunRecord Runner::runOne(std::size_t worker, std::size_t houseId, std::size_t algoId, std::uint64_t seed,
+                         bool writeOutput, std::unique_ptr<Simulator> &simulator) {
+    // The run keeps this version of the algorithm (and its library) even if a new build is loaded meanwhile
+    std::shared_ptr<const AlgorithmVersion> algorithm = algorithms.get(algoId);
+
+    // Pairs whose house, algorithm library and simulator are unchanged since a cached run are not simulated, if
+    // their output file (when they write one) is still the one of the cached result.
+    // An unseeded run of a seedable algorithm seeds itself at random, so its result is not a function of the key.
+    RunRecord record;
+    std::uint64_t cacheKey = 0;
+    bool useCache = cache && !(seed == NO_SEED && algorithm->seedable);
+    bool cached = false;
+    if (useCache) {
+        cacheKey = ResultCache::makeKey(houses[houseId].contentHash, algorithm->contentHash, seed,
+                                        options.memoryCapBytes);
+        cached = cache->lookup(cacheKey, record) &&
+                 (!writeOutput || isOutputOf(houses[houseId].fileName + "-" + algorithm->name, record));
+    }
+    if (!cached) {
+        TraceSpan span("simulate");
+        if (span.isActive()) {
+            span.setArgs(Tracer::args({{"house", houses[houseId].fileName}, {"algorithm", algorithm->name},
+                                       {"seed", seed == NO_SEED ? "-" : std::to_string(seed)}}));
+        }
+        record = runTask(houses[houseId], algorithm, simulator, seed, writeOutput,
+                         metrics ? metrics->getStepLatency(worker, algoId) : nullptr);
+        if (useCache) {
+            cache->store(cacheKey, record);
+        }
+    }
+    record.houseId = std::uint32_t(houseId);
+    record.algoId = std::uint32_t(algoId);
+    record.seed = seed;
+    if (cached && Tracer::getTracer().isEnabled()) {
+        Tracer::getTracer().instant("cached", Tracer::args({{"house", houses[houseId].fileName},
+                                                            {"algorithm", algorithm->name}}));
+    }
+    if (metrics) {
+        if (cached) {
+            metrics->taskCached(worker);
+        } else {
+            metrics->taskDone(worker, record);
+        }
+    }
+    return record;
+}
+
+void Runner::leaveRunning(AbandonedRun &run) {
+    run.thread.detach();
+    run.simulator.release();
+    run.algorithm->library->keepMapped();
+}
+
+void Runner::abandonRun(AbandonedRun run) {
+    std::lock_guard<std::mutex> lock(abandonedMutex);
+    abandonedRuns.push_back(std::move(run));
+    // The runs whose thread ended since they were abandoned are destroyed. A thread that never ends (it disabled
+    // its cancellation) cannot give its simulator back: beyond MAX_ABANDONED_RUNS the oldest are left to the
+    // process exit, like the thread itself, instead of being owned here
+    std::vector<AbandonedRun> running;
+    for (AbandonedRun &run: abandonedRuns) {
+        std::unique_lock<std::mutex> stateLock(run.state->m);
+        bool ended = run.state->ended;
+        stateLock.unlock();
+        if (ended) {
+            run.thread.join();
+            run.simulator.reset();
+        } else {
+            running.push_back(std::move(run));
+        }
+    }
+    for (std::size_t i = 0; i + MAX_ABANDONED_RUNS < running.size(); i++) {
+        std::cerr << "A simulation thread did not end after its timeout, it is left running" << std::endl;
+        leaveRunning(running[i]);
+    }
+    if (running.size() > MAX_ABANDONED_RUNS) {
+        running.erase(running.begin(), running.end() - MAX_ABANDONED_RUNS);
+    }
+    abandonedRuns = std::move(running);
+}
+
+/* 'simulator' is the calling worker's simulator, reset for this house. It is replaced by a new one if the run times out.
+ * The algorithm is seeded with 'seed' unless it is NO_SEED, and no output file is written if 'writeOutput' is false.
+ * Returns the score, status, steps and dirt left of the run (houseId / algoId are left to the caller) */
+RunRecord Runner::runTask(const House &house, const std::shared_ptr<const AlgorithmVersion> &algorithm,
+                          std::unique_ptr<Simulator> &simulator, std::uint64_t seed, bool writeOutput,
+                          LatencyHistogram *stepLatency) {
+    const std::string &houseFilePath = house.filePath;
+    const std::string &algo_name = algorithm->name;
+    auto startTime = std::chrono::steady_clock::now();
+    RunRecord record;
+    record.seed = seed;
+
+    std::unique_ptr<AbstractAlgorithm> algo = algorithm->factory();
+    if (!algo) {
+        writeError(algo_name + ".error", "Algorithm Factory returned a nulptr for: " + algo_name);
+        record.score = ResultsMatrix::NO_SCORE;
+        record.status = RunStatus::Error;
+        return record;
+    }
+
+    simulator->setCoverageEnabled(!options.coverageDir.empty());
+    simulator->setMemoryTracking(options.trackMemory, options.memoryCapBytes);
+    simulator->reset(house);
+    simulator->setAlgorithm(std::move(algo), algo_name);
+    if (seed != NO_SEED) {
+        simulator->setSeed(seed);
+    }
+    // An unseeded run of a seedable algorithm is seeded at random by the algorithm: a recorded one draws its seed
+    // here instead, so its traces hold it and can be replayed
+    std::uint64_t traceSeed = seed;
+    bool recordTraces = !options.sensorTraceDir.empty() || !options.runTraceDir.empty();
+    if (recordTraces && seed == NO_SEED && algorithm->seedable) {
+        traceSeed = drawSeed();
+        simulator->setSeed(traceSeed);
+    }
+    if (!options.sensorTraceDir.empty()) {
+        simulator->recordSensors({house.fileName, algo_name, traceSeed, std::uint64_t(simulator->getMaxSteps())});
+    }
+    if (!options.runTraceDir.empty()) {
+        simulator->recordRun(traceSeed);
+    }
+
+    // The traces, coverage and checkpoint of the run are named after the pair (and the seed)
+    std::string traceFileName = house.fileName + "-" + algo_name;
+    if (seed != NO_SEED) {
+        traceFileName += "-" + std::to_string(seed);
+    }
+    // A run stopped by a timeout (or a killed process) continues from its last checkpoint. The recorded runs start
+    // over, the traces and the coverage are not in the checkpoints
+    std::string checkpointPath;
+    if (!options.checkpointDir.empty()) {
+        checkpointPath = (std::filesystem::path(options.checkpointDir) / (traceFileName + ".ckpt")).string();
+        bool recorded = !options.sensorTraceDir.empty() || !options.runTraceDir.empty() || !options.coverageDir.empty();
+        if (!recorded && std::filesystem::exists(checkpointPath)) {
+            try {
+                simulator->restoreSnapshot(readCheckpoint(checkpointPath));
+            } catch (const std::exception &e) {
+                std::cerr << checkpointPath << ": " << e.what() << ", the run starts over" << std::endl;
+                algo = algorithm->factory();
+                if (!algo) {
+                    writeError(algo_name + ".error", "Algorithm Factory returned a nulptr for: " + algo_name);
+                    record.score = ResultsMatrix::NO_SCORE;
+                    record.status = RunStatus::Error;
+                    return record;
+                }
+                simulator->reset(house);
+                simulator->setAlgorithm(std::move(algo), algo_name);
+                if (seed != NO_SEED) {
+                    simulator->setSeed(seed);
+                }
+            }
+        }
+        simulator->setCheckpointing(options.checkpointInterval, [checkpointPath](const std::string &snapshot) {
+            writeCheckpoint(checkpointPath, snapshot);
+        });
+    } else {
+        simulator->setCheckpointing(0, nullptr);
+    }
+
+    std::int64_t maxSteps = simulator->getMaxSteps();
+    std::int64_t initialDirt = simulator->getInitialDirt();
+
+    // Create the simulation thread
+    // The simulation policy is chosen by the caller (output files or not)
+    auto state = std::make_shared<SimulationState>();
+    simulator->setStepLatencyHistogram(stepLatency ? &state->stepLatency : nullptr);
+    auto runSimWithPolicy = writeOutput ? &runSim<FullOutputPolicy> : &runSim<SummaryOnlyPolicy>;
+    std::thread simThread(runSimWithPolicy, simulator.get(), state);
+
+    // Wait until the run finishes or the timeout has passed
+    std::unique_lock<std::mutex> lock(state->m);
+    if (!state->cv.wait_for(lock, std::chrono::milliseconds(maxSteps), [&state]() { return state->finished; })) {
+        // Thread running the simulation has reached its timeout
+        pthread_cancel(simThread.native_handle()); // Cancel the simulation thread
+        // It unwinds at once, unless it is stuck (e.g. on a lock held by another cancelled thread)
+        bool ended = state->cv.wait_for(lock, CANCEL_WAIT, [&state]() { return state->ended; });
+        lock.unlock();
+
+        if (Tracer::getTracer().isEnabled()) {
+            Tracer::getTracer().instant("timeout", Tracer::args({{"house", house.fileName}, {"algorithm", algo_name}}));
+        }
+
+        // Calculate the timeout score
+        std::int64_t timeoutScore = calcTimeoutScore(maxSteps, initialDirt);
+
+        // Create an error file which notifies about the timeout
+        std::string errorFileName = algo_name + ".error";
+        writeError(errorFileName, "Timout has occurred running " + algo_name + " on " + houseFilePath);
+        record.score = timeoutScore;
+        record.status = RunStatus::Timeout;
+
+        if (ended) {
+            // The simulator is only read once its thread is gone. It is reused for the next task (reset() sets
+            // every field), the algorithm is destroyed while its library is surely loaded
+            simThread.join();
+            if (stepLatency) {
+                stepLatency->merge(state->stepLatency);
+            }
+            if (writeOutput) {
+                simulator->createTimeoutOutputFile(timeoutScore);
+            }
+            record.steps = simulator->getTotalSteps();
+            record.dirtLeft = simulator->getTotalDirt();
+            readMemoryUse(*simulator, record);
+            simulator->clearAlgorithm();
+        } else {
+            // The thread may still use the simulator (and the algorithm it owns): what it did is unknown, the run
+            // is reported as the timeout score counts it (every step taken, no dirt cleaned) with no output file.
+            // The worker continues with a new simulator
+            record.steps = maxSteps;
+            record.dirtLeft = initialDirt;
+            algorithms.pinAfterTimeout(algorithm);
+            abandonRun({std::move(simThread), std::move(simulator), std::move(state), algorithm});
+            simulator = std::make_unique<Simulator>();
+        }
+    } else {
+        // (Received cv notification) or (timeout has not passed and finished == true)
+        lock.unlock();
+        simThread.join();
+        if (stepLatency) {
+            stepLatency->merge(state->stepLatency);
+        }
+        std::int64_t score = state->score;
+        record.score = score;  // The score obtained from the simulation
+        record.status = score == -1 ? RunStatus::Error : parseRunStatus(simulator->calcStatus());
+        record.steps = simulator->getTotalSteps();
+        record.dirtLeft = simulator->getTotalDirt();
+        readMemoryUse(*simulator, record);
+        // A timed out run has no traces or coverage: its last steps were cut at an arbitrary point
+        if (!options.sensorTraceDir.empty()) {
+            OutputWriter::getOutputWriter().write(
+                    (std::filesystem::path(options.sensorTraceDir) / (traceFileName + ".trace")).string(),
+                    simulator->finishSensorTrace(), OutputWriter::Mode::Truncate);
+        }
+        if (!options.runTraceDir.empty()) {
+            OutputWriter::getOutputWriter().write(
+                    (std::filesystem::path(options.runTraceDir) / (traceFileName + ".run")).string(),
+                    simulator->finishRunTrace(), OutputWriter::Mode::Truncate);
+        }
+        if (const CoverageMap *coverage = simulator->getCoverage()) {
+            std::filesystem::path coveragePath = std::filesystem::path(options.coverageDir) / traceFileName;
+            OutputWriter::getOutputWriter().write(coveragePath.string() + ".ppm", coverage->formatImage(),
+                                                  OutputWriter::Mode::Truncate);
+            OutputWriter::getOutputWriter().write(coveragePath.string() + ".csv", coverage->formatCurve(),
+                                                  OutputWriter::Mode::Truncate);
+        }
+        // A finished run is not resumed, its last checkpoint is removed (written synchronously, see writeCheckpoint)
+        if (!checkpointPath.empty()) {
+            std::error_code error;
+            std::filesystem::remove(checkpointPath, error);
+        }
+        // Destroy the algorithm now, while its library is surely loaded
+        simulator->clearAlgorithm();
+    }
+    record.wallTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+    return record;
+}
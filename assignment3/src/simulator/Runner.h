@@ -0,0 +1,165 @@
+#ifndef ASSIGNMENT3_RUNNER_H
+#define ASSIGNMENT3_RUNNER_H
+
+#include "utils.h"
+#include "Grid.h"
+#include "House.h"
+#include "ResultsMatrix.h"
+#include "ResultsSink.h"
+#include "ResultCache.h"
+#include "AlgorithmRegistry.h"
+#include "Topology.h"
+#include "Metrics.h"
+#include <functional>
+
+class Simulator;
+class TaskScheduler;
+struct SimulationState;
+
+/* The command line options the runner works with (see main.cpp) */
+struct RunnerOptions {
+    std::string houseDirPath;
+    std::string algoDirPath;
+    int numOfThreads = 0; // 0: one per physical core of the detected topology
+    bool pinThreads = false; // bind every worker (and the simulation threads it starts) to its own CPU
+    bool summaryOnly = false;
+    bool recursiveScan = false; // also look for .house files in the subdirectories of houseDirPath
+    GridLayout gridLayout = GridLayout::RowMajor; // memory layout of the house grids
+    int numOfSeeds = 0; // N seeded runs per pair of a seedable algorithm (0: a single unseeded run)
+    std::string cachePath; // result cache file, only the pairs missing from it are simulated (off if empty)
+    std::string sensorTraceDir; // write the sensor trace of every simulated run to this directory (off if empty)
+    std::string runTraceDir; // write the run trace of every simulated run to this directory (off if empty)
+    std::string coverageDir; // write the coverage heatmap and curve of every simulated run here (off if empty)
+    bool trackMemory = false; // count the heap use of the algorithms (peak bytes and allocations of every run)
+    std::uint64_t memoryCapBytes = 0; // fail the runs whose algorithm goes over this many bytes (0: no cap)
+    std::string checkpointDir; // checkpoint the runs to this directory and resume them from it (off if empty)
+    std::uint64_t checkpointInterval = 1000000; // steps between two checkpoints of a run
+};
+
+/* A tournament: every selected house x every selected algorithm (runner ids) */
+struct Job {
+    std::vector<std::size_t> houseIds;
+    std::vector<std::size_t> algoIds;
+    int numOfSeeds = 0;
+    bool summaryOnly = false;
+};
+
+/* 'results' is indexed by the positions in job.houseIds / job.algoIds (not by runner ids) */
+struct JobResults {
+    ResultsMatrix results;
+    std::vector<bool> validHouses; // by position in job.houseIds
+};
+
+/* Owns what outlives a single tournament: the loaded algorithm libraries, the discovered (and, once validated,
+ * parsed) houses and the result cache. A command line run executes one job over everything, the daemon keeps the
+ * runner and executes a job per request, so the libraries are loaded and every house is parsed only once.
+ * Libraries can be reloaded while a job runs, see AlgorithmRegistry. */
+class Runner {
+public:
+    // called from the worker threads for every finished run (cached or not), with runner ids
+    using RecordCallback = std::function<void(const RunRecord &)>;
+
+    explicit Runner(RunnerOptions options);
+
+    ~Runner();
+
+    Runner(const Runner &) = delete;
+
+    Runner &operator=(const Runner &) = delete;
+
+    /* dlopen every library of algoDirPath and intern the algorithms it registers */
+    void loadAlgorithms();
+
+    /* reload the libraries of algoDirPath that changed since they were loaded (thread safe, also during a job).
+     * Returns the number of reloaded libraries */
+    std::size_t reloadAlgorithms();
+
+    /* list the .house files, they are parsed and validated by the workers of the first job that uses them */
+    void discoverHouses();
+
+    /* parse and validate every house now (a job without algorithms) */
+    void preloadHouses();
+
+    /* runs the job on numOfThreads workers and returns once every run is done */
+    JobResults run(const Job &job, const RecordCallback &onRecord);
+
+    /* a job over every house and algorithm, with the runner options */
+    Job makeFullJob() const;
+
+    /* one run of a house validated by an earlier job (looked up in the result cache first, and stored in it).
+     * 'simulator' is the caller's simulator, replaced by a new one if the run times out. 'worker' is the index of
+     * the calling thread (in the metrics). Thread safe */
+    RunRecord runOne(std::size_t worker, std::size_t houseId, std::size_t algoId, std::uint64_t seed,
+                     bool writeOutput, std::unique_ptr<Simulator> &simulator);
+
+    /* record the runs into 'metrics' (one worker slot per thread), nullptr: no metrics */
+    void setMetrics(Metrics *metrics) { this->metrics = metrics; }
+
+    /* false for the houses that were not validated yet */
+    bool isHouseValid(std::size_t houseId) const { return houseStates[houseId] == HouseState::Valid; }
+
+    /* the parsed house, only once isHouseValid(houseId) */
+    const House &getHouse(std::size_t houseId) const { return houses[houseId]; }
+
+    bool isAlgorithmSeedable(std::size_t algoId) const { return algorithms.get(algoId)->seedable; }
+
+    const RunnerOptions &getOptions() const { return options; }
+
+    const CpuTopology &getTopology() const { return topology; }
+
+    /* with pinThreads, binds the calling thread to the CPU of the i-th worker (see CpuTopology::getWorkerCpu) */
+    void pinWorkerThread(std::size_t workerIndex) const;
+
+    std::size_t getNumOfAlgorithms() const { return algorithms.count(); }
+
+    std::size_t getNumOfHouses() const { return housePaths.size(); }
+
+    /* the name of a house in the output files and the summary: its file name, or with -recursive its path relative
+     * to houseDirPath with the directory separators replaced by '_' (houses of different directories may share a name) */
+    std::string getHouseName(std::size_t houseId) const;
+
+    std::vector<std::string> getHouseNames() const;
+
+    std::vector<std::string> getAlgorithmNames() const;
+
+private:
+    enum class HouseState : std::uint8_t { Unchecked, Valid, Invalid };
+
+    RunnerOptions options;
+    CpuTopology topology;
+    AlgorithmRegistry algorithms;
+    std::vector<std::filesystem::path> housePaths;
+    std::vector<House> houses; // by house id, parsed once the house is validated
+    std::vector<HouseState> houseStates;
+    std::unique_ptr<ResultCache> cache;
+    Metrics *metrics = nullptr;
+
+    // A simulation whose thread did not end after its cancellation (timeout): owned here until it ends
+    struct AbandonedRun {
+        std::thread thread;
+        std::unique_ptr<Simulator> simulator;
+        std::shared_ptr<SimulationState> state;
+        std::shared_ptr<const AlgorithmVersion> algorithm;
+    };
+
+    /* gives up a run whose thread does not end: it keeps its simulator, and the code of its algorithm */
+    static void leaveRunning(AbandonedRun &run);
+
+    static constexpr std::size_t MAX_ABANDONED_RUNS = 16;
+    std::mutex abandonedMutex; // guards 'abandonedRuns'
+    std::vector<AbandonedRun> abandonedRuns;
+
+    /* keeps the simulation of a timed out run until its thread ended, and destroys those that did */
+    void abandonRun(AbandonedRun run);
+
+    bool validateHouse(std::size_t houseId);
+
+    void worker(std::size_t workerIndex, const Job &job, TaskScheduler &scheduler, ResultsMatrix &results,
+                const RecordCallback &onRecord);
+
+    RunRecord runTask(const House &house, const std::shared_ptr<const AlgorithmVersion> &algorithm,
+                      std::unique_ptr<Simulator> &simulator, std::uint64_t seed, bool writeOutput,
+                      LatencyHistogram *stepLatency);
+};
+
+#endif //ASSIGNMENT3_RUNNER_H
@@ -0,0 +1,41 @@
+#ifndef ASSIGNMENT3_SCORING_H
+#define ASSIGNMENT3_SCORING_H
+
+#include <cstdint>
+#include <string>
+
+/* The end of run status and score rules, shared by the simulator and the output validator
+ * (tools/output_validator.cpp), which re-simulates the output files and must score them exactly the same way.
+ * Steps, dirt and scores are 64 bit: MaxSteps * 2 of the timeout score overflows an int from MaxSteps ~ 1e9. */
+
+/* FINISHED / WORKING / DEAD / UNKNOWN, as written to the output file */
+inline std::string calcRunStatus(bool finished, bool inDock, float batteryLevel, std::int64_t steps,
+                                 std::int64_t maxSteps) {
+    if (finished) {
+        return inDock ? "FINISHED" : "DEAD";
+    } else if (batteryLevel == 0 && !inDock) {
+        return "DEAD";
+    } else if (steps == maxSteps && batteryLevel > 0) {
+        return "WORKING";
+    }
+    return "UNKNOWN";
+}
+
+inline std::int64_t calcRunScore(const std::string &status, bool inDock, std::int64_t steps, std::int64_t maxSteps,
+                                 std::int64_t dirtLeft) {
+    if (status == "DEAD") {
+        return maxSteps + dirtLeft * 300 + 2000;
+    } else if (status == "FINISHED" && !inDock) {
+        return maxSteps + dirtLeft * 300 + 3000;
+    } else if (inDock) {
+        return steps + dirtLeft * 300;
+    }
+    return steps + dirtLeft * 300 + 1000;
+}
+
+/* the score of a run stopped by the timeout, whatever it did until then */
+inline std::int64_t calcTimeoutScore(std::int64_t maxSteps, std::int64_t initialDirt) {
+    return maxSteps * 2 + initialDirt * 300 + 2000;
+}
+
+#endif //ASSIGNMENT3_SCORING_H
@@ -0,0 +1,216 @@
+#include "SensorTrace.h"
+#include "MemoryTracker.h"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little, "the sensor trace format is little endian");
+
+namespace {
+
+constexpr char MAGIC[] = "MRST";
+
+constexpr std::uint8_t WALL_EVENT = 0x00;
+constexpr std::uint8_t DIRT_EVENT = 0x10;
+constexpr std::uint8_t BATTERY_EVENT = 0x20;
+constexpr std::uint8_t STEP_EVENT = 0x30;
+constexpr std::uint8_t KIND_MASK = 0xF0;
+constexpr std::uint8_t LARGE_DIRT = 0x0F; // dirt level of 15 and above (or negative), followed by a varint
+
+template<typename T>
+void appendRaw(std::string &out, const T &value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void appendVarint(std::string &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out += char(std::uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+
+void appendName(std::string &out, const std::string &name) {
+    appendRaw(out, std::uint32_t(name.size()));
+    out += name;
+}
+
+template<typename T>
+T readRaw(const std::string &in, std::size_t &position) {
+    if (position + sizeof(T) > in.size()) {
+        throw std::runtime_error("Truncated sensor trace header");
+    }
+    T value;
+    std::memcpy(&value, in.data() + position, sizeof(T));
+    position += sizeof(T);
+    return value;
+}
+
+std::string readName(const std::string &in, std::size_t &position) {
+    auto size = readRaw<std::uint32_t>(in, position);
+    if (position + size > in.size()) {
+        throw std::runtime_error("Truncated sensor trace header");
+    }
+    std::string name = in.substr(position, size);
+    position += size;
+    return name;
+}
+
+const char *getDirectionName(Direction d) {
+    switch (d) {
+        case Direction::North: return "North";
+        case Direction::East: return "East";
+        case Direction::South: return "South";
+        case Direction::West: return "West";
+    }
+    return "?";
+}
+
+}
+
+SensorRecorder::SensorRecorder(const SensorTraceHeader &header, const WallsSensor &walls, const DirtSensor &dirt,
+                               const BatteryMeter &battery) : walls(walls), dirt(dirt), battery(battery) {
+    trace.append(MAGIC, 4);
+    appendRaw(trace, SensorTraceHeader::VERSION);
+    appendRaw(trace, header.seed);
+    appendRaw(trace, header.maxSteps);
+    appendName(trace, header.houseName);
+    appendName(trace, header.algoName);
+}
+
+/* The sensors are called from the algorithm's nextStep(), while its MemoryTracker is current: the growth of the
+ * trace is the simulator's, it is not counted (nor capped) */
+bool SensorRecorder::isWall(Direction d) const {
+    bool wall = walls.isWall(d);
+    MemoryTracker::Scope untracked(nullptr);
+    trace += char(WALL_EVENT | std::uint8_t(int(d) << 1) | std::uint8_t(wall));
+    return wall;
+}
+
+int SensorRecorder::dirtLevel() const {
+    int level = dirt.dirtLevel();
+    MemoryTracker::Scope untracked(nullptr);
+    if (level >= 0 && level < LARGE_DIRT) {
+        trace += char(DIRT_EVENT | std::uint8_t(level));
+    } else {
+        trace += char(DIRT_EVENT | LARGE_DIRT);
+        appendVarint(trace, std::uint64_t(std::uint32_t(level)));
+    }
+    return level;
+}
+
+std::size_t SensorRecorder::getBatteryState() const {
+    std::size_t state = battery.getBatteryState();
+    MemoryTracker::Scope untracked(nullptr);
+    trace += char(BATTERY_EVENT);
+    appendVarint(trace, state);
+    return state;
+}
+
+void SensorRecorder::recordStep(Step step) {
+    trace += char(STEP_EVENT | std::uint8_t(step));
+}
+
+SensorReplayer::SensorReplayer(std::string trace) : trace(std::move(trace)) {
+    const std::string &in = this->trace;
+    if (in.size() < 4 || in.compare(0, 4, MAGIC, 4) != 0) {
+        throw std::runtime_error("Not a sensor trace");
+    }
+    std::size_t offset = 4;
+    auto version = readRaw<std::uint32_t>(in, offset);
+    if (version != SensorTraceHeader::VERSION) {
+        throw std::runtime_error("Unsupported sensor trace version " + std::to_string(version));
+    }
+    header.seed = readRaw<std::uint64_t>(in, offset);
+    header.maxSteps = readRaw<std::uint64_t>(in, offset);
+    header.houseName = readName(in, offset);
+    header.algoName = readName(in, offset);
+    eventsStart = offset;
+    position = offset;
+}
+
+void SensorReplayer::rewind() {
+    position = eventsStart;
+    diverged = false;
+    error.clear();
+    numOfSteps = 0;
+}
+
+bool SensorReplayer::nextEvent(std::uint8_t kind, std::uint8_t &event, const char *call) const {
+    if (diverged) {
+        return false;
+    }
+    if (position >= trace.size()) {
+        diverged = true;
+        error = std::string(call) + " called after the end of the trace, at step " + std::to_string(numOfSteps);
+        return false;
+    }
+    event = std::uint8_t(trace[position]);
+    if ((event & KIND_MASK) != kind) {
+        diverged = true;
+        error = std::string(call) + " called where the recorded run made another call, at step " +
+                std::to_string(numOfSteps);
+        return false;
+    }
+    position++;
+    return true;
+}
+
+std::uint64_t SensorReplayer::readVarint() const {
+    std::uint64_t value = 0;
+    for (int shift = 0; position < trace.size() && shift < 64; shift += 7) {
+        auto byte = std::uint8_t(trace[position++]);
+        value |= std::uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+bool SensorReplayer::isWall(Direction d) const {
+    std::uint8_t event;
+    if (!nextEvent(WALL_EVENT, event, "isWall")) {
+        return true;
+    }
+    if (Direction((event >> 1) & 3) != d) {
+        diverged = true;
+        error = std::string("isWall(") + getDirectionName(d) + ") called where the recorded run called isWall(" +
+                getDirectionName(Direction((event >> 1) & 3)) + "), at step " + std::to_string(numOfSteps);
+        return true;
+    }
+    return event & 1;
+}
+
+int SensorReplayer::dirtLevel() const {
+    std::uint8_t event;
+    if (!nextEvent(DIRT_EVENT, event, "dirtLevel")) {
+        return 0;
+    }
+    std::uint8_t level = event & ~KIND_MASK;
+    return level == LARGE_DIRT ? int(std::uint32_t(readVarint())) : int(level);
+}
+
+std::size_t SensorReplayer::getBatteryState() const {
+    std::uint8_t event;
+    if (!nextEvent(BATTERY_EVENT, event, "getBatteryState")) {
+        return 0;
+    }
+    return std::size_t(readVarint());
+}
+
+bool SensorReplayer::checkStep(Step step) {
+    std::uint8_t event;
+    if (!nextEvent(STEP_EVENT, event, "nextStep")) {
+        return false;
+    }
+    if (Step(event & ~KIND_MASK) != step) {
+        diverged = true;
+        error = "step " + std::to_string(numOfSteps) + " differs from the recorded run";
+        return false;
+    }
+    numOfSteps++;
+    return true;
+}
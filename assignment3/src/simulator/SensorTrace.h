@@ -0,0 +1,97 @@
+#ifndef ASSIGNMENT3_SENSORTRACE_H
+#define ASSIGNMENT3_SENSORTRACE_H
+
+#include "WallSensor.h"
+#include "DirtSensor.h"
+#include "BatteryMeter.h"
+#include "enums.h"
+#include <cstdint>
+#include <string>
+
+/* Sensor traces: the exact sequence of sensor answers an algorithm got during a run, and the steps it returned,
+ * so the run can be replayed on a fresh instance of the algorithm without the simulator (tools/sensor_replay.cpp).
+ * File format: "MRST" magic, u32 version, u64 seed (NO_SEED if unseeded), u64 max steps, then the house and the
+ * algorithm names (u32 length + bytes each), all little endian, followed by one event per sensor call or step:
+ * - 0x00 | direction << 1 | wall        isWall(direction)
+ * - 0x10 | level                        dirtLevel() (0 to 14, 0x1F + varint for the others)
+ * - 0x20, varint                        getBatteryState()
+ * - 0x30 | step                         nextStep() returned 'step'
+ * (varints are unsigned LEB128), so a typical step costs a handful of bytes. */
+struct SensorTraceHeader {
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::string houseName;
+    std::string algoName;
+    std::uint64_t seed = 0;
+    std::uint64_t maxSteps = 0;
+};
+
+/* Sits between an algorithm and the simulator's sensors, and records every answer it forwards */
+class SensorRecorder : public WallsSensor, public DirtSensor, public BatteryMeter {
+public:
+    SensorRecorder(const SensorTraceHeader &header, const WallsSensor &walls, const DirtSensor &dirt,
+                   const BatteryMeter &battery);
+
+    bool isWall(Direction d) const override;
+
+    int dirtLevel() const override;
+
+    std::size_t getBatteryState() const override;
+
+    void recordStep(Step step);
+
+    /* the trace file content */
+    const std::string &getTrace() const { return trace; }
+
+private:
+    const WallsSensor &walls;
+    const DirtSensor &dirt;
+    const BatteryMeter &battery;
+    mutable std::string trace; // the sensors are const, recording is not
+};
+
+/* Answers the sensor calls of an algorithm from a trace, in order. A call that differs from the recorded one
+ * (another sensor, or another direction) marks the replay as diverged and is answered with a wall / 0 */
+class SensorReplayer : public WallsSensor, public DirtSensor, public BatteryMeter {
+public:
+    /* throws std::runtime_error if 'trace' is not a valid sensor trace */
+    explicit SensorReplayer(std::string trace);
+
+    const SensorTraceHeader &getHeader() const { return header; }
+
+    bool isWall(Direction d) const override;
+
+    int dirtLevel() const override;
+
+    std::size_t getBatteryState() const override;
+
+    /* checks the step the algorithm returned against the recorded one. Returns false (diverged) on a mismatch */
+    bool checkStep(Step step);
+
+    /* true once every recorded event was replayed */
+    bool done() const { return position == trace.size(); }
+
+    bool hasDiverged() const { return diverged; }
+
+    /* where the replay diverged (or stopped) */
+    const std::string &getError() const { return error; }
+
+    /* restart from the first event (to replay again on another algorithm instance) */
+    void rewind();
+
+private:
+    std::string trace;
+    SensorTraceHeader header;
+    std::size_t eventsStart = 0;
+    mutable std::size_t position = 0;
+    mutable bool diverged = false;
+    mutable std::string error;
+    std::size_t numOfSteps = 0;
+
+    /* the next event if it has 'kind' (the 4 high bits), otherwise marks the divergence and returns false */
+    bool nextEvent(std::uint8_t kind, std::uint8_t &event, const char *call) const;
+
+    std::uint64_t readVarint() const;
+};
+
+#endif //ASSIGNMENT3_SENSORTRACE_H
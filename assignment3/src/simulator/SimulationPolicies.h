@@ -0,0 +1,30 @@
+#ifndef ASSIGNMENT3_SIMULATIONPOLICIES_H
+#define ASSIGNMENT3_SIMULATIONPOLICIES_H
+
+/* Compile-time policies for Simulator::run<Policy>().
+ * A policy chooses the step recorder, the output writer and the debug rendering of a run. The run loop tests
+ * them with 'if constexpr', so a summary-only run carries no step logging branches or allocations at all.
+ * The policy is selected once per run (see runSim in simulator/Runner.cpp). */
+
+// regular run: record every step and write the <house>-<algorithm> output file
+struct FullOutputPolicy {
+    static constexpr bool recordSteps = true;
+    static constexpr bool writeOutputFile = true;
+    static constexpr bool renderSteps = false;
+};
+
+// -summary_only: only the score is needed
+struct SummaryOnlyPolicy {
+    static constexpr bool recordSteps = false;
+    static constexpr bool writeOutputFile = false;
+    static constexpr bool renderSteps = false;
+};
+
+// runWithSim(): full output, and the house is drawn after every step (see RenderOptions)
+struct VisualPolicy {
+    static constexpr bool recordSteps = true;
+    static constexpr bool writeOutputFile = true;
+    static constexpr bool renderSteps = true;
+};
+
+#endif //ASSIGNMENT3_SIMULATIONPOLICIES_H
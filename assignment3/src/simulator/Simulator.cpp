@@ -1,11 +1,64 @@
 #include "Simulator.h"
+#include <bit>
+#include <cstring>
 #include <typeinfo>
 
+static_assert(std::endian::native == std::endian::little, "the snapshot format is little endian");
 
-Simulator::Simulator() : summaryOnly(false), rows(-1), cols(-1), maxSteps(-1), maxBatterySteps(-1), totalDirt(0), simTotalSteps(0),
-                         batteryLevel(-1) {}
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[] = "MRCP";
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+
+template<typename T>
+void appendRaw(std::string &out, const T &value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void appendBytes(std::string &out, const std::string &bytes) {
+    appendRaw(out, std::uint32_t(bytes.size()));
+    out += bytes;
+}
+
+/* reads the fields of a snapshot in order, throws on a truncated snapshot */
+class Reader {
+public:
+    explicit Reader(const std::string &in) : in(in) {}
+
+    template<typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string readBytes() {
+        auto size = read<std::uint32_t>();
+        return std::string(take(size), size);
+    }
+
+    const char *take(std::size_t size) {
+        if (size > in.size() - position) {
+            throw std::runtime_error("Truncated snapshot");
+        }
+        const char *data = in.data() + position;
+        position += size;
+        return data;
+    }
+
+    bool done() const { return position == in.size(); }
 
-Simulator::Simulator(bool summaryOnly) : summaryOnly(summaryOnly), rows(-1), cols(-1), maxSteps(-1), maxBatterySteps(-1), totalDirt(0), simTotalSteps(0),
+private:
+    const std::string &in;
+    std::size_t position = 0;
+};
+
+}
+
+
+Simulator::Simulator() : rows(-1), cols(-1), maxSteps(-1), maxBatterySteps(-1), simTotalSteps(0),
                          batteryLevel(-1) {}
 
 // WallSensor implementation
@@ -27,10 +80,10 @@ bool Simulator::isWall(Direction d) const {
             break;
     }
     // if position is out of house layout bounds -> return true (it's a wall)
-    if (row < 0 || row > (int(houseLayout.size()) - 1) || col < 0 || col > (int(houseLayout[row].size()) - 1)) {
+    if (!houseLayout.inBounds(row, col)) {
         return true;
     } // check if there is a wall in houseLayout[row][col]
-    else if (houseLayout[row][col] == 'W') return true;
+    else if (houseLayout.at(row, col) == 'W') return true;
     else return false;
 }
 
@@ -38,7 +91,7 @@ bool Simulator::isWall(Direction d) const {
 int Simulator::dirtLevel() const {
     int row = simCurrPosition.first;
     int col = simCurrPosition.second;
-    char c = houseLayout[row][col];
+    char c = houseLayout.at(row, col);
     if (c >= '1' && c <= '9') {
         return c - '0';
     }
@@ -53,11 +106,20 @@ std::size_t Simulator::getBatteryState() const {
 
 /* change dirt level in simCurrPosition by num */
 void Simulator::updateDirtLevel(int num) {
-    houseLayout[simCurrPosition.first][simCurrPosition.second] += num;
+    int oldDirt = dirtLevel();
+    houseLayout.at(simCurrPosition.first, simCurrPosition.second) += num;
+    dirtIndex.updateDirt(simCurrPosition.first, simCurrPosition.second, oldDirt, dirtLevel());
+    if (coverage) {
+        coverage->clean(simCurrPosition.first, simCurrPosition.second);
+    }
 }
 
-int Simulator::getTotalDirt() const {
-    return totalDirt;
+std::int64_t Simulator::getTotalDirt() const {
+    return dirtIndex.getTotalDirt();
+}
+
+bool Simulator::isHouseCleanAndDocked() const {
+    return dirtIndex.isClean() && simCurrPosition == simDockingStationPosition;
 }
 
 void Simulator::updateBatteryLevel(float num) {
@@ -70,100 +132,51 @@ void Simulator::setBatteryLevel(float num) {
 
 void Simulator::updateCurrentPosition(Step step) {
     simCurrPosition = moveInDirection(simCurrPosition, getMatchingDirection(step));
+    if (coverage) {
+        coverage->visit(simCurrPosition.first, simCurrPosition.second);
+    }
 }
 /* returns FALSE if house file cannot be open or is invalid, and TRUE if house file is valid */
-bool Simulator::readHouseFile(const std::string &filePath) {
-    houseFileName = filePath;
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cout << "Simulator::readHouseFile ERROR: Failed to open file" << std::endl;
-        std::cout << "Invalid file name: " << input_file_name << std::endl;
+bool Simulator::readHouseFile(const std::string &filePath, GridLayout layout) {
+    House house;
+    if (!readHouse(filePath, layout, house)) {
         return false;
     }
+    reset(house);
+    return true;
+}
 
-    /* extract the house_files file name from the path, to be used in the output file name */
-    std::filesystem::path inputPath(filePath);
-    input_file_name = inputPath.filename().string();
-
-    /* initialize houseLayoutName, MaxSteps, MaxBattery, Rows, Cols */
-    std::string line;
-    for (int i = 0; i < 5; i++) {
-        if (!getline(file, line)) {
-            std::cout << "Simulator::readHouseFile ERROR: File missing information" << std::endl;
-            std::cout << "Invalid file name: " << input_file_name << std::endl;
-            file.close();
-            return false;
-        }
-        std::istringstream ss(line);
-        std::string key;
-        int value;
-        getline(ss, key, '=');
-        key.erase(key.find_last_not_of(" \t\n\r\f\v") + 1); // Trim trailing spaces from key
-        ss >> value;
-        if (key == "MaxSteps") maxSteps = value;
-        else if (key == "MaxBattery") {
-            maxBatterySteps = float(value);
-            batteryLevel = float(value);
-        } else if (key == "Rows") rows = value;
-        else if (key == "Cols") cols = value;
-    }
-    // sanity check for: maxSteps, maxBatterySteps, rows, cols
-    if (maxSteps < 0 || maxBatterySteps < 0 || rows < 0 || cols < 0) {
-        std::cout << "Simulator::readHouseFile ERROR: Invalid house file parameter (maxSteps / MaxBatterySteps / house rows / house cols" << std::endl;
-        std::cout << "Invalid file: " << input_file_name << std::endl;
-        file.close();
-        return false;
-    }
-    int houseLayoutRowsNum = 0;
-    /* get house layout */
-    // if the number of rows in the given layout is greater than 'Rows' -> ignore the rest of the rows
-    while (getline(file, line) && houseLayoutRowsNum < rows) {
-        houseLayoutRowsNum++;
-        std::vector<char> currRow(line.begin(), line.end());
-        // if the number of cols in the layout is smaller than 'Cols' -> pad the row with ' '
-        if (int(currRow.size()) < cols) {
-            currRow.resize(cols, ' ');
-        }
-        // if the number of cols in the given layout is greater than 'Cols' -> shorten the row by deleting the last elements
-        else if (int(currRow.size()) > cols) {
-            currRow.resize(cols);
-        }
-        // append the currRow to the house layout
-        houseLayout.push_back(currRow);
-
-        // Check if the currRow contains the docking station 'D'
-        auto it = std::find(currRow.begin(), currRow.end(), 'D');
-        if (it != currRow.end()) {
-            if (!dockingStationFound) {
-                dockingStationFound = true;
-                int index = std::distance(currRow.begin(), it);
-                simDockingStationPosition = std::make_pair(houseLayout.size() - 1, index);
-            } else {
-                std::cout << "Simulator::readHouseFile ERROR: More than 1 docking station defined in layout" << std::endl;
-                std::cout << "Invalid file name: " << input_file_name << std::endl;
-                file.close();
-                return false;
-            }
-        }
-        // update the total dirt count in the house
-        for (char c: currRow) {
-            if (c >= '1' && c <= '9') {
-                int currRowDirtLevel = c - '0';
-                totalDirt += currRowDirtLevel;
-            }
-        }
+/* prepare the simulator for a new run on 'house'.
+ * The grid, dirt index and step log buffers are reused, so a simulator that already ran on a house of a
+ * similar size does not allocate. */
+void Simulator::reset(const House &house) {
+    houseLayoutName = house.name;
+    houseFileName = house.filePath;
+    input_file_name = house.fileName;
+    maxSteps = house.maxSteps;
+    maxBatterySteps = float(house.maxBattery);
+    batteryLevel = float(house.maxBattery);
+    rows = house.rows;
+    cols = house.cols;
+    houseLayout = house.layout;
+    dirtIndex = house.dirt;
+    dockingStationFound = true;
+    simDockingStationPosition = house.dockingStation;
+    simCurrPosition = simDockingStationPosition;
+    initDirt = getTotalDirt();
+    simTotalSteps = 0;
+    simTotalStepsLog.clear();
+    lastStep = Step::Stay;
+    algo.reset();
+    algoName.clear();
+    sensorRecorder.reset();
+    runRecorder.reset();
+    if (coverage) {
+        coverage->reset(houseLayout, simDockingStationPosition, maxSteps, initDirt);
     }
-    if (!dockingStationFound) {
-        std::cout << "Simulator::readHouseFile ERROR: No docking station defined in layout" << std::endl;
-        std::cout << "Invalid file name: " << input_file_name << std::endl;
-        file.close();
-        return false;
+    if (memoryTracker) {
+        memoryTracker->reset(memoryCapBytes);
     }
-    initDirt = totalDirt;
-    simCurrPosition = simDockingStationPosition;
-    file.close();
-    // If house file is valid, return TRUE
-    return true;
 }
 
 void Simulator::printHouseLayout() const {
@@ -172,22 +185,18 @@ void Simulator::printHouseLayout() const {
     std::cout << "MaxBattery = " << maxBatterySteps << std::endl;
     std::cout << "Rows = " << rows << std::endl;
     std::cout << "Cols = " << cols << std::endl;
-    std::cout << "TotalDirtLevel = " << totalDirt << '\n' << std::endl;
+    std::cout << "TotalDirtLevel = " << getTotalDirt() << '\n' << std::endl;
 
     std::string wall;
-    for (int i = 0; i < int(houseLayout[0].size()) + 2; i++) {
+    for (int i = 0; i < houseLayout.getCols() + 2; i++) {
         wall += 'W';
     }
     // print North wall
     std::cout << wall << std::endl;
-    for (const auto &currRow: houseLayout) {
-        bool newRow = true;
-        for (const auto &cell: currRow) {
-            if (newRow) {
-                newRow = false;
-                std::cout << 'W';
-            }
-            std::cout << cell;
+    for (int r = 0; r < houseLayout.getRows(); r++) {
+        std::cout << 'W';
+        for (int c = 0; c < houseLayout.getCols(); c++) {
+            std::cout << houseLayout.at(r, c);
         }
         std::cout << 'W' << std::endl;
     }
@@ -195,17 +204,206 @@ void Simulator::printHouseLayout() const {
     std::cout << wall << std::endl;
 }
 
-void Simulator::setAlgorithm(std::unique_ptr<AbstractAlgorithm> algorithm) {
+void Simulator::setAlgorithm(std::unique_ptr<AbstractAlgorithm> algorithm, const std::string &name) {
     if (algorithm == nullptr) {
         std::string errorFileName = getAlgorithmName(algo) + ".error";
         writeError(errorFileName, "Simulator::setAlgorithm ERROR: Algorithm pointer is nulptr: " + getAlgorithmName(algo));
     }
     this->algo = std::move(algorithm);
-    this->algoName = getAlgorithmName(algo);
+    this->algoName = name.empty() ? getAlgorithmName(algo) : name;
     this->algo->setMaxSteps(maxSteps);
     this->algo->setWallsSensor(*this);
     this->algo->setDirtSensor(*this);
     this->algo->setBatteryMeter(*this);
+    // let the algorithm store its explored map with the same layout as the house grid
+    if (auto *layoutAware = dynamic_cast<GridLayoutAwareAlgorithm *>(this->algo.get())) {
+        layoutAware->setGridLayout(houseLayout.getLayout());
+    }
+}
+
+bool Simulator::setSeed(std::uint64_t seed) {
+    auto *seedable = dynamic_cast<SeedableAlgorithm *>(algo.get());
+    if (!seedable) {
+        return false;
+    }
+    seedable->setSeed(seed);
+    return true;
+}
+
+void Simulator::recordSensors(const SensorTraceHeader &header) {
+    sensorRecorder = std::make_unique<SensorRecorder>(header, *this, *this, *this);
+    this->algo->setWallsSensor(*sensorRecorder);
+    this->algo->setDirtSensor(*sensorRecorder);
+    this->algo->setBatteryMeter(*sensorRecorder);
+}
+
+std::string Simulator::finishSensorTrace() {
+    std::string trace = sensorRecorder ? sensorRecorder->getTrace() : std::string();
+    sensorRecorder.reset();
+    return trace;
+}
+
+void Simulator::setMemoryTracking(bool enabled, std::uint64_t capBytes) {
+    memoryCapBytes = capBytes;
+    if (!enabled) {
+        memoryTracker.reset();
+    } else if (!memoryTracker) {
+        memoryTracker = std::make_unique<MemoryTracker>();
+    }
+}
+
+void Simulator::setCheckpointing(std::uint64_t interval,
+                                 std::function<void(const std::string &)> checkpoint) {
+    checkpointInterval = checkpoint ? interval : 0;
+    this->checkpoint = std::move(checkpoint);
+}
+
+std::string Simulator::saveSnapshot() const {
+    std::string out;
+    out.append(SNAPSHOT_MAGIC, 4);
+    appendRaw(out, SNAPSHOT_VERSION);
+    appendBytes(out, input_file_name);
+    appendBytes(out, algoName);
+    appendRaw(out, maxSteps);
+    appendRaw(out, std::int32_t(rows));
+    appendRaw(out, std::int32_t(cols));
+    appendRaw(out, initDirt);
+
+    appendRaw(out, simTotalSteps);
+    appendRaw(out, std::int32_t(simCurrPosition.first));
+    appendRaw(out, std::int32_t(simCurrPosition.second));
+    appendRaw(out, batteryLevel);
+    appendRaw(out, std::uint8_t(lastStep));
+    appendRaw(out, std::uint32_t(dirtIndex.getDirtyCells()));
+    dirtIndex.forEachDirtyCell([this, &out](int row, int col) {
+        appendRaw(out, std::uint32_t(std::size_t(row) * cols + col));
+        appendRaw(out, std::uint8_t(houseLayout.at(row, col) - '0'));
+    });
+
+    appendRaw(out, simTotalStepsLog.size());
+    std::string steps = simTotalStepsLog.encode();
+    appendRaw(out, std::uint64_t(steps.size()));
+    out += steps;
+
+    auto *serializable = dynamic_cast<const SerializableAlgorithm *>(algo.get());
+    appendRaw(out, std::uint8_t(serializable != nullptr));
+    appendBytes(out, serializable ? serializable->saveState() : std::string());
+    return out;
+}
+
+void Simulator::restoreSnapshot(const std::string &snapshot) {
+    if (sensorRecorder || runRecorder || coverage) {
+        throw std::runtime_error("A recorded run cannot be restored from a snapshot");
+    }
+    auto *serializable = dynamic_cast<SerializableAlgorithm *>(algo.get());
+    if (!serializable) {
+        throw std::runtime_error(algoName + " cannot restore its state");
+    }
+    Reader reader(snapshot);
+    if (std::memcmp(reader.take(4), SNAPSHOT_MAGIC, 4) != 0) {
+        throw std::runtime_error("Not a snapshot");
+    }
+    auto version = reader.read<std::uint32_t>();
+    if (version != SNAPSHOT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(version));
+    }
+    if (reader.readBytes() != input_file_name || reader.readBytes() != algoName) {
+        throw std::runtime_error("Snapshot of another house or algorithm");
+    }
+    if (reader.read<std::int64_t>() != maxSteps || reader.read<std::int32_t>() != rows ||
+        reader.read<std::int32_t>() != cols || reader.read<std::int64_t>() != initDirt) {
+        throw std::runtime_error("Snapshot of another version of " + input_file_name);
+    }
+
+    auto steps = reader.read<std::int64_t>();
+    std::pair<int, int> position;
+    position.first = reader.read<std::int32_t>();
+    position.second = reader.read<std::int32_t>();
+    auto battery = reader.read<float>();
+    auto step = reader.read<std::uint8_t>();
+    if (steps < 0 || steps > maxSteps || !houseLayout.inBounds(position.first, position.second) ||
+        houseLayout.at(position.first, position.second) == 'W' || !(battery >= 0 && battery <= maxBatterySteps) ||
+        step > std::uint8_t(Step::Finish)) {
+        throw std::runtime_error("Invalid snapshot state");
+    }
+
+    // the dirt of the snapshot replaces the initial dirt, a cell cleaned since the start is at '0'
+    std::vector<std::pair<int, int>> initiallyDirty;
+    dirtIndex.forEachDirtyCell([&initiallyDirty](int row, int col) { initiallyDirty.emplace_back(row, col); });
+    for (const auto &[row, col]: initiallyDirty) {
+        dirtIndex.updateDirt(row, col, houseLayout.at(row, col) - '0', 0);
+        houseLayout.at(row, col) = '0';
+    }
+    auto numOfDirtyCells = reader.read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < numOfDirtyCells; i++) {
+        auto cell = reader.read<std::uint32_t>();
+        auto level = reader.read<std::uint8_t>();
+        if (cell >= std::size_t(rows) * cols) {
+            throw std::runtime_error("Invalid snapshot dirt");
+        }
+        int row = int(cell / std::uint32_t(cols));
+        int col = int(cell % std::uint32_t(cols));
+        // a dirt cell of the house ('0' to '9' at the start), not the docking station or a wall
+        if (level < 1 || level > 9 || houseLayout.at(row, col) != '0') {
+            throw std::runtime_error("Invalid snapshot dirt");
+        }
+        houseLayout.at(row, col) = char('0' + level);
+        dirtIndex.updateDirt(row, col, 0, level);
+    }
+
+    auto loggedSteps = reader.read<std::uint64_t>();
+    auto encodedSize = reader.read<std::uint64_t>();
+    if (encodedSize > snapshot.size()) {
+        throw std::runtime_error("Truncated snapshot");
+    }
+    simTotalStepsLog.decode(reader.take(std::size_t(encodedSize)), std::size_t(encodedSize));
+    if (simTotalStepsLog.size() != loggedSteps) {
+        throw std::runtime_error("Invalid snapshot step log");
+    }
+
+    bool hasAlgorithmState = reader.read<std::uint8_t>() != 0;
+    std::string algorithmState = reader.readBytes();
+    if (!hasAlgorithmState || !reader.done()) {
+        throw std::runtime_error("Invalid snapshot algorithm state");
+    }
+    serializable->loadState(algorithmState);
+
+    simTotalSteps = steps;
+    simCurrPosition = position;
+    batteryLevel = battery;
+    lastStep = Step(step);
+}
+
+void Simulator::setCoverageEnabled(bool enabled) {
+    if (!enabled) {
+        coverage.reset();
+    } else if (!coverage) {
+        coverage = std::make_unique<CoverageMap>();
+    }
+}
+
+void Simulator::recordRun(std::uint64_t seed) {
+    RunTraceHeader header;
+    header.houseName = input_file_name;
+    header.algoName = algoName;
+    header.seed = seed;
+    header.maxSteps = maxSteps;
+    header.maxBattery = int(maxBatterySteps);
+    header.dockRow = simDockingStationPosition.first;
+    header.dockCol = simDockingStationPosition.second;
+    runRecorder = std::make_unique<RunTraceRecorder>(std::move(header), houseLayout, dirtIndex);
+}
+
+std::string Simulator::finishRunTrace() {
+    std::string trace = runRecorder ? runRecorder->finish() : std::string();
+    runRecorder.reset();
+    return trace;
+}
+
+void Simulator::recordRunStep(Step step) {
+    RunTraceState state{std::uint64_t(simTotalSteps), simCurrPosition.first, simCurrPosition.second, batteryLevel,
+                        getTotalDirt()};
+    runRecorder->recordStep(step, state, houseLayout, dirtIndex);
 }
 
 std::pair<int, int> Simulator::getSimCurrPosition() {
@@ -216,8 +414,26 @@ std::pair<int, int> Simulator::getSimDockingStationPosition() {
     return simDockingStationPosition;
 }
 
+std::int64_t Simulator::run() {
+    return run<FullOutputPolicy>();
+}
+
 /* return -1 in case of an error, and score otherwise */
-int Simulator::run() {
+template<typename Policy>
+std::int64_t Simulator::run() {
+    if constexpr (Policy::recordSteps) {
+        // one char per step, reserved up front (capped, MaxSteps may be much larger than the actual run)
+        simTotalStepsLog.reserve(std::min(std::uint64_t(maxSteps) + 1, std::uint64_t(MAX_STEPS_LOG_RESERVE)));
+    }
+    // the run of an algorithm that cannot save its state could not be restored
+    std::uint64_t runCheckpointInterval =
+            dynamic_cast<SerializableAlgorithm *>(algo.get()) ? checkpointInterval : 0;
+    if constexpr (Policy::renderSteps) {
+        renderer = std::make_unique<TerminalRenderer>(renderOptions.viewCols, renderOptions.viewRows);
+        stepsSinceFrame = 0;
+        nextFrame = std::chrono::steady_clock::now();
+        renderFrame("Starting", true);
+    }
     try {
         while (true) {
             if (simTotalSteps > maxSteps) {
@@ -232,9 +448,34 @@ int Simulator::run() {
             }
 
             try {
-                Step simNextStep = this->algo->nextStep();
+                Step simNextStep;
+                {
+                    // the allocations of the algorithm are counted (and capped) while it chooses its step
+                    MemoryTracker::Scope trackAlgorithm(memoryTracker.get());
+                    if (stepLatency) {
+                        auto stepStart = std::chrono::steady_clock::now();
+                        simNextStep = this->algo->nextStep();
+                        stepLatency->record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - stepStart).count());
+                    } else {
+                        simNextStep = this->algo->nextStep();
+                    }
+                }
+                if (memoryTracker && memoryTracker->capExceeded()) {
+                    // the algorithm caught the exception of the refused allocation, the run fails all the same
+                    throw MemoryCapExceeded();
+                }
+                lastStep = simNextStep;
+                if (sensorRecorder) {
+                    sensorRecorder->recordStep(simNextStep);
+                }
                 if (simNextStep == Step::Finish) {
-                    updateSimTotalStepsLog(simNextStep);
+                    if constexpr (Policy::recordSteps) {
+                        updateSimTotalStepsLog(simNextStep);
+                    }
+                    if (runRecorder) {
+                        recordRunStep(simNextStep);
+                    }
                     break;
                 }
                 if (simNextStep == Step::Stay) {
@@ -245,16 +486,40 @@ int Simulator::run() {
                         }
                     } else {
                         updateBatteryLevel(-1);
-                        updateDirtLevel(-1);
-                        totalDirt--;
+                        // staying on a clean cell does not change the dirt
+                        if (dirtLevel() > 0) {
+                            updateDirtLevel(-1);
+                        }
                     }
                 } else {
                     updateCurrentPosition(simNextStep);
                     updateBatteryLevel(-1);
                 }
-                updateSimTotalStepsLog(simNextStep);
+                if constexpr (Policy::recordSteps) {
+                    updateSimTotalStepsLog(simNextStep);
+                }
                 simTotalSteps++;
+                if (coverage) {
+                    coverage->sample(simTotalSteps, getTotalDirt());
+                }
+                if (runRecorder) {
+                    recordRunStep(simNextStep);
+                }
+                if (runCheckpointInterval != 0 && std::uint64_t(simTotalSteps) % runCheckpointInterval == 0) {
+                    checkpoint(saveSnapshot());
+                    if (checkpointInterval == 0) {
+                        runCheckpointInterval = 0; // see stopCheckpointing()
+                    }
+                }
 
+                if constexpr (Policy::renderSteps) {
+                    renderFrame(getMatchingString(simNextStep));
+                }
+            } catch (const MemoryCapExceeded &) {
+                std::string errorFileName = this->algoName + ".error";
+                writeError(errorFileName, "Simulator::run() ERROR: " + this->algoName + " exceeded the memory cap on " +
+                                          houseFileName);
+                throw;
             } catch (const std::exception &e) {
                 // Create an error file which notifies about the error
                 std::string errorFileName = this->algoName + ".error";
@@ -262,19 +527,30 @@ int Simulator::run() {
             }
         }
     } catch (const std::exception &e) {
+        if constexpr (Policy::renderSteps) {
+            renderer.reset();
+        }
         std::cerr << e.what() << std::endl;
         return -1;
     }
+    if constexpr (Policy::renderSteps) {
+        renderFrame(getMatchingString(lastStep), true);
+        renderer.reset();
+    }
 
-    int score = calcScore();
-    if (!summaryOnly) {
+    std::int64_t score = calcScore();
+    if constexpr (Policy::writeOutputFile) {
         createOutputFile();
     }
     return score;
 }
 
+template std::int64_t Simulator::run<FullOutputPolicy>();
+template std::int64_t Simulator::run<SummaryOnlyPolicy>();
+template std::int64_t Simulator::run<VisualPolicy>();
+
 void Simulator::updateSimTotalStepsLog(Step step) {
-    std::string s;
+    char s = 'F';
     switch (step) {
         case Step::Stay:
             s = 's';
@@ -295,101 +571,45 @@ void Simulator::updateSimTotalStepsLog(Step step) {
             s = 'F';
             break;
     }
-    simTotalStepsLog.push_back(s);
+    simTotalStepsLog.push(s);
 }
 
-void Simulator::printHouseLayoutForSim(const std::string &action) const {
-    system("clear"); // Clear the screen. Use "CLS" for Windows.
-
-    std::cout << "Max steps allowed: " << maxSteps << std::endl;
-    std::cout << "Total Steps Taken: " << simTotalSteps << "\n" << std::endl;
-    std::cout << "Action: " << action << std::endl;
-    std::cout << "Battery Level: " << getBatteryState() << std::endl;
-    std::cout << "Max battery steps: " << maxBatterySteps << std::endl;
-    std::cout << "Total Dirt Left: " << totalDirt << "\n" << std::endl;
-
-    std::string wall(cols + 2, 'W');
-    std::cout << wall << std::endl;
-    for (int r = 0; r < rows; ++r) {
-        std::cout << 'W';
-        for (int c = 0; c < cols; ++c) {
-            if (std::make_pair(r, c) == simCurrPosition) {
-                std::cout << 'V'; // Represent the robot with 'V'
-            } else {
-                std::cout << houseLayout[r][c];
-            }
-        }
-        std::cout << 'W' << std::endl;
+void Simulator::renderFrame(const std::string &action, bool last) {
+    if (!last && ++stepsSinceFrame <= renderOptions.frameSkip) {
+        return;
     }
-    std::cout << wall << "\n" << std::endl;
-}
-
-void Simulator::runWithSim() {
-    if (simTotalSteps > maxSteps) {
-        throw std::runtime_error("Mission failed: Used maximum number of steps allowed.");
+    stepsSinceFrame = 0;
+    std::this_thread::sleep_until(nextFrame);
+    nextFrame = std::chrono::steady_clock::now();
+    if (renderOptions.fps > 0) {
+        nextFrame += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / renderOptions.fps));
     }
-    // Initial print
-    printHouseLayoutForSim("Starting");
 
-    // while mission not completed
-    while (true) {
-        Step simNextStep = this->algo->nextStep();
-
-        std::string action = getMatchingString(simNextStep);
-
-        // if the algorithm returns 'Finish' -> break the loop
-        if (simNextStep == Step::Finish) {
-            updateSimTotalStepsLog(simNextStep);
-            break;
-        } // if the battery is empty and not on docking station
-        if (batteryLevel == 0 && simCurrPosition != simDockingStationPosition) {
-            throw std::runtime_error("Run out of battery away from docking station");
-        }
-        if (simNextStep == Step::Stay) {
-            // if on docking station -> charge
-            if (simCurrPosition == simDockingStationPosition) {
-                updateBatteryLevel(maxBatterySteps / 20);
-                // prevent over charging the battery
-                if (batteryLevel > maxBatterySteps) {
-                    setBatteryLevel(maxBatterySteps);
+    std::vector<std::string> status = {
+            "Max steps allowed: " + std::to_string(maxSteps) + "   Total Steps Taken: " + std::to_string(simTotalSteps),
+            "Action: " + action,
+            "Battery Level: " + std::to_string(getBatteryState()) + " / " + std::to_string(int(maxBatterySteps)),
+            "Total Dirt Left: " + std::to_string(getTotalDirt()) + "   Dirty Cells Left: " +
+            std::to_string(dirtIndex.getDirtyCells()),
+            ""};
+    // the house with its surrounding walls, the robot as 'V'
+    renderer->draw(status, houseLayout.getRows() + 2, houseLayout.getCols() + 2, simCurrPosition.first + 1,
+                   simCurrPosition.second + 1, [this](int row, int col) {
+                if (row - 1 == simCurrPosition.first && col - 1 == simCurrPosition.second) {
+                    return 'V';
                 }
-            } else { // if not on docking station -> clean()
-                updateBatteryLevel(-1);
-                updateDirtLevel(-1);
-                totalDirt--;
-            }
-        } else { // simNextStep != 'Stay'
-            // update the current position according to the step
-            updateCurrentPosition(simNextStep);
-            updateBatteryLevel(-1);
-        }
-        updateSimTotalStepsLog(simNextStep);
-        simTotalSteps++;
+                return houseLayout.inBounds(row - 1, col - 1) ? houseLayout.at(row - 1, col - 1) : 'W';
+            });
+}
 
-        // Print the house layout after each action
-        printHouseLayoutForSim(action);
-        std::this_thread::sleep_for(std::chrono::milliseconds(350));
-    }
-    createOutputFile();
-    return;
+void Simulator::runWithSim() {
+    run<VisualPolicy>();
 }
 
 std::string Simulator::calcStatus() {
-    std::string status = "UNKNOWN"; // default value
-    std::string lastStep = simTotalStepsLog.back();
-    // determine the status
-    if (lastStep == "F") {
-        if (simCurrPosition == simDockingStationPosition) {
-            status = "FINISHED";
-        } else {
-            status = "DEAD";
-        }
-    } else if (batteryLevel == 0 && simCurrPosition != simDockingStationPosition) {
-        status = "DEAD";
-    } else if (simTotalSteps == maxSteps && batteryLevel > 0) {
-        status = "WORKING";
-    }
-    return status;
+    return calcRunStatus(lastStep == Step::Finish, simCurrPosition == simDockingStationPosition, batteryLevel,
+                         simTotalSteps, maxSteps);
 }
 
 std::string Simulator::calcInDock() {
@@ -397,82 +617,46 @@ std::string Simulator::calcInDock() {
     return inDock;
 }
 
-int Simulator::calcScore() {
-    int score;
-    std::string status = calcStatus();
-    std::string inDock = calcInDock();
-
-    if (status == "DEAD") {
-        score = maxSteps + totalDirt * 300 + 2000;
-    }
-    else if (status == "FINISHED" && inDock == "FALSE") {
-        score = maxSteps + totalDirt * 300 + 3000;
-    }
-    else if (inDock == "TRUE") {
-        score = simTotalSteps + totalDirt * 300;
-    }
-    else {
-        score = simTotalSteps + totalDirt * 300 + 1000;
-    }
-    return score;
+std::int64_t Simulator::calcScore() {
+    return calcRunScore(calcStatus(), simCurrPosition == simDockingStationPosition, simTotalSteps, maxSteps,
+                        getTotalDirt());
 }
 
-std::string Simulator::parseSimTotalStepsLog() {
-    std::string str;
-    for (const auto &s: simTotalStepsLog) {
-        str += s;
-    }
-    return str;
+std::string Simulator::formatOutputHeader(std::int64_t score) {
+    std::ostringstream output;
+    output << "NumSteps = " << simTotalSteps << '\n';
+    output << "DirtLeft = " << getTotalDirt() << '\n';
+    output << "Status = " << calcStatus() << '\n';
+    output << "InDock = " << calcInDock() << '\n';
+    output << "Score = " << score << '\n';
+    return output.str();
 }
 
-void Simulator::createOutputFile() {
-    // create outputFileName
+void Simulator::writeOutputFile(std::int64_t score) {
+    // create outputFileName, the file itself is written by the writer thread
     std::string outputFileName = input_file_name + "-" + algoName;
-    std::ofstream outputFile(outputFileName);
-    if (!outputFile) { // make sure the output file has been created
-        std::string err = "Simulator::createOutputFile() Error: Failed to create output file: " + outputFileName;
-        throw std::runtime_error(err);
+    OutputWriter &writer = OutputWriter::getOutputWriter();
+    if (!simTotalStepsLog.isSpilled()) {
+        writer.write(outputFileName, formatOutputHeader(score) + "Steps: " + simTotalStepsLog.getSteps() + '\n',
+                     OutputWriter::Mode::Truncate);
+        return;
     }
-    outputFile << "NumSteps = " << simTotalSteps << std::endl;
-
-    outputFile << "DirtLeft = " << totalDirt << std::endl;
-
-    std::string status = calcStatus();
-    outputFile << "Status = " << status << std::endl;
-
-    std::string inDock = calcInDock();
-    outputFile << "InDock = " << inDock << std::endl;
-
-    int score = calcScore();
-    outputFile << "Score = " << score << std::endl;
-
-    std::string steps_log = parseSimTotalStepsLog();
-    outputFile << "Steps: " << steps_log << std::endl;
+    // Every chunk is in the file before the next one is decoded, so a billion steps run never holds more than
+    // a chunk of its steps in memory
+    writer.write(outputFileName, formatOutputHeader(score) + "Steps: ", OutputWriter::Mode::Truncate);
+    simTotalStepsLog.forEachChunk([&writer, &outputFileName](const std::string &steps) {
+        writer.write(outputFileName, steps, OutputWriter::Mode::Append);
+        writer.flush();
+    });
+    writer.write(outputFileName, "\n", OutputWriter::Mode::Append);
 }
 
-void Simulator::createTimeoutOutputFile(int timeoutScore) {
-    // create outputFileName
-    std::string outputFileName = input_file_name + "-" + algoName;
-    std::ofstream outputFile(outputFileName);
-    if (!outputFile) { // make sure the output file has been created
-        std::string err = "Simulator::createTimeoutOutputFile() Error: Failed to create output file: " + outputFileName;
-        throw std::runtime_error(err);
-    }
-
-    outputFile << "NumSteps = " << simTotalSteps << std::endl;
-
-    outputFile << "DirtLeft = " << totalDirt << std::endl;
-
-    std::string status = calcStatus();
-    outputFile << "Status = " << status << std::endl;
-
-    std::string inDock = calcInDock();
-    outputFile << "InDock = " << inDock << std::endl;
-
-    outputFile << "Score = " << timeoutScore << std::endl;
+void Simulator::createOutputFile() {
+    writeOutputFile(calcScore());
+}
 
-    std::string steps_log = parseSimTotalStepsLog();
-    outputFile << "Steps: " << steps_log << std::endl;
+void Simulator::createTimeoutOutputFile(std::int64_t timeoutScore) {
+    writeOutputFile(timeoutScore);
 }
 
 std::string Simulator::getAlgorithmName(const std::unique_ptr<AbstractAlgorithm> &algorithm) {
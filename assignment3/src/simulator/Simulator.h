@@ -2,22 +2,104 @@
 #define SIMULATOR_H
 
 #include "utils.h"
+#include "Grid.h"
 #include "../Algorithm_206448649_314939398_A/Algorithm_206448649_314939398_A.h"
 #include "../Algorithm_206448649_314939398_B/Algorithm_206448649_314939398_B.h"
 #include "WallSensor.h"
 #include "DirtSensor.h"
 #include "BatteryMeter.h"
+#include "AlgorithmExtensions.h"
+#include "DirtIndex.h"
+#include "SimulationPolicies.h"
+#include "Scoring.h"
+#include "House.h"
+#include "Histogram.h"
+#include "SensorTrace.h"
+#include "RunTrace.h"
+#include "TerminalRenderer.h"
+#include "CoverageMap.h"
+#include "MemoryTracker.h"
+#include "StepLog.h"
 #include <condition_variable>
 #include <atomic>
+#include <functional>
 
 
+// the step log is reserved up front only up to this many steps, longer runs grow it on demand
+constexpr std::size_t MAX_STEPS_LOG_RESERVE = 1 << 20;
+
+// how runWithSim() draws the run
+struct RenderOptions {
+    double fps = 3; // frames per second at most, 0: as fast as the terminal takes them
+    int frameSkip = 0; // steps played between two frames without being drawn
+    int viewCols = 0; // the house view, 0: the terminal size
+    int viewRows = 0;
+};
+
 class Simulator : public WallsSensor, public DirtSensor, public BatteryMeter {
 public:
     Simulator();
 
-    explicit Simulator(bool summaryOnly);
+    // 'name' is the registered algorithm name, if empty it is taken from the algorithm's type
+    void setAlgorithm(std::unique_ptr<AbstractAlgorithm> algorithm, const std::string &name = "");
+
+    // seeds the current algorithm, returns false (and does nothing) if it is not a SeedableAlgorithm
+    bool setSeed(std::uint64_t seed);
+
+    // destroys the algorithm, e.g. before the library it comes from is closed
+    void clearAlgorithm() { algo.reset(); }
+
+    // the next runs record the latency of every nextStep() call into 'histogram' (ns), nullptr: not measured
+    void setStepLatencyHistogram(LatencyHistogram *histogram) { stepLatency = histogram; }
+
+    // records the sensor answers and the steps of the current algorithm's run (call after setAlgorithm / setSeed)
+    void recordSensors(const SensorTraceHeader &header);
+
+    // the sensor trace of the last run (see SensorTrace.h), empty if it was not recorded
+    std::string finishSensorTrace();
+
+    // records the steps and keyframes of the current algorithm's run (call after setAlgorithm), see RunTrace.h
+    void recordRun(std::uint64_t seed);
+
+    // the run trace of the last run, empty if it was not recorded
+    std::string finishRunTrace();
+
+    // keep the coverage (visits, cleanings, dirt left curve) of the runs after the next reset(), see CoverageMap
+    void setCoverageEnabled(bool enabled);
+
+    // the coverage of the last run, nullptr if it is not kept
+    const CoverageMap *getCoverage() const { return coverage.get(); }
+
+    // count the allocations of the algorithm's nextStep() calls in the runs after the next reset(), and fail a run
+    // whose algorithm goes over 'capBytes' (0: no cap), see MemoryTracker
+    void setMemoryTracking(bool enabled, std::uint64_t capBytes = 0);
+
+    // the allocations of the last run, nullptr if they are not tracked
+    const MemoryTracker *getMemoryTracker() const { return memoryTracker.get(); }
+
+    // calls 'checkpoint' with saveSnapshot() every 'interval' steps of the next runs (0: never), from the thread
+    // that runs the simulation. Only the runs of a SerializableAlgorithm are checkpointed
+    void setCheckpointing(std::uint64_t interval, std::function<void(const std::string &)> checkpoint);
+
+    // no more checkpoints in this run and the next ones. Can be called from the checkpoint callback, which is kept
+    // until the next setCheckpointing()
+    void stopCheckpointing() { checkpointInterval = 0; }
+
+    /* The state of the current run, to continue it later with restoreSnapshot(). Little endian:
+     * "MRCP", u32 version, u32 + house file name, u32 + algorithm name, i64 MaxSteps, i32 rows, i32 cols,
+     * i64 initial dirt (to check the house),
+     * i64 steps, i32 row, i32 col, f32 battery, u8 last step,
+     * u32 dirty cells, then per dirty cell u32 row-major index and u8 dirt level,
+     * u64 logged steps, u64 + the step log in its spill encoding (see StepLog),
+     * u8 has algorithm state, u32 + the SerializableAlgorithm::saveState() of the algorithm.
+     * The sensor / run recorders and the coverage are not in the snapshot */
+    std::string saveSnapshot() const;
 
-    void setAlgorithm(std::unique_ptr<AbstractAlgorithm> algorithm);
+    /* continues the run of 'snapshot' instead of starting a new one: call after reset() on the same house and
+     * setAlgorithm() with the same algorithm (setSeed() before it is overridden by the algorithm state, after it
+     * forks the run). Throws std::runtime_error if the snapshot is invalid, of another house or algorithm, if the
+     * algorithm is not a SerializableAlgorithm or if the run is recorded, the simulator must then be reset() */
+    void restoreSnapshot(const std::string &snapshot);
 
     // WallSensor implementation
     bool isWall(Direction d) const override;
@@ -28,36 +110,69 @@ public:
     // BatteryMeter implementation
     std::size_t getBatteryState() const override;
 
-    bool readHouseFile(const std::string &filePath);
+    bool readHouseFile(const std::string &filePath, GridLayout layout = GridLayout::RowMajor);
 
-    int run();
+    void reset(const House &house);
+
+    // run with FullOutputPolicy
+    std::int64_t run();
+
+    template<typename Policy>
+    std::int64_t run();
 
     void runWithSim();
 
-    int getMaxSteps() const { return maxSteps; }
+    void setRenderOptions(const RenderOptions &options) { renderOptions = options; }
+
+    std::int64_t getMaxSteps() const { return maxSteps; }
+
+    std::int64_t getInitialDirt() const { return initDirt; }
+
+    std::int64_t getTotalSteps() const { return simTotalSteps; }
+
+    std::int64_t getTotalDirt() const;
+
+    // FINISHED / WORKING / DEAD / UNKNOWN, as written to the output file
+    std::string calcStatus();
+
+    void createTimeoutOutputFile(std::int64_t timeoutScore);
 
-    int getInitialDirt() const { return initDirt; }
+    // O(1) thanks to the dirty cell index
+    bool isHouseCleanAndDocked() const;
 
-    void createTimeoutOutputFile(int timeoutScore);
+    const DirtIndex &getDirtIndex() const { return dirtIndex; }
 
 private:
-    int rows, cols, maxSteps;
+    int rows, cols;
+    std::int64_t maxSteps;
     float maxBatterySteps = -1;
     std::string houseLayoutName;
     std::string houseFileName;
-    std::vector<std::vector<char>> houseLayout;
+    Grid<char> houseLayout;
     bool dockingStationFound = false;
     std::pair<int, int> simDockingStationPosition;
-    int totalDirt;
-    int initDirt;
-    int simTotalSteps;
+    DirtIndex dirtIndex; // cells that still have dirt, the total dirt left is kept by the index
+    std::int64_t initDirt;
+    std::int64_t simTotalSteps;
     float batteryLevel;
     std::pair<int, int> simCurrPosition;
     std::unique_ptr<AbstractAlgorithm> algo;
     std::string algoName;
-    std::vector<std::string> simTotalStepsLog;
+    StepLog simTotalStepsLog; // one char per step, filled only by policies that record steps
+    Step lastStep = Step::Stay;
+    LatencyHistogram *stepLatency = nullptr;
+    std::unique_ptr<SensorRecorder> sensorRecorder; // the algorithm's sensors while recording
+    std::unique_ptr<RunTraceRecorder> runRecorder;
+    std::unique_ptr<CoverageMap> coverage;
+    std::unique_ptr<MemoryTracker> memoryTracker;
+    std::uint64_t memoryCapBytes = 0;
+    std::uint64_t checkpointInterval = 0;
+    std::function<void(const std::string &)> checkpoint;
+    RenderOptions renderOptions;
+    std::unique_ptr<TerminalRenderer> renderer; // only while runWithSim() runs
+    int stepsSinceFrame = 0;
+    std::chrono::steady_clock::time_point nextFrame;
     std::string input_file_name;
-    bool summaryOnly = false;
 
 
     // private methods:
@@ -73,25 +188,28 @@ private:
 
     void setBatteryLevel(float num);
 
-    int getTotalDirt() const;
-
     void printHouseLayout() const;
 
-    void printHouseLayoutForSim(const std::string &action) const;
+    // draws the house after 'action' unless the frame is skipped, and waits for the next frame ('last': always drawn)
+    void renderFrame(const std::string &action, bool last = false);
 
     void updateSimTotalStepsLog(Step step);
 
-    void createOutputFile();
+    void recordRunStep(Step step);
 
-    std::string parseSimTotalStepsLog();
+    // the output file up to "Steps: " (excluded)
+    std::string formatOutputHeader(std::int64_t score);
 
-    std::string getAlgorithmName(const std::unique_ptr<AbstractAlgorithm> &algorithm);
+    // writes the output file, the steps a chunk at a time if they were spilled to disk
+    void writeOutputFile(std::int64_t score);
 
-    std::string calcStatus();
+    void createOutputFile();
+
+    std::string getAlgorithmName(const std::unique_ptr<AbstractAlgorithm> &algorithm);
 
     std::string calcInDock();
 
-    int calcScore();
+    std::int64_t calcScore();
 };
 
 #endif // SIMULATOR_H
@@ -0,0 +1,177 @@
+#include "StepLog.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+constexpr char STEP_CHARS[] = "NESWsF";
+constexpr std::uint8_t RUN = 0x80;
+constexpr std::uint8_t NO_STEP = 7;
+constexpr std::size_t MIN_RUN = 3;
+constexpr std::size_t MAX_RUN = MIN_RUN + 15;
+// encoded bytes read from the temporary file at a time
+constexpr std::size_t READ_BLOCK = std::size_t(1) << 20;
+
+std::uint8_t stepCode(char step) {
+    switch (step) {
+        case 'N': return 0;
+        case 'E': return 1;
+        case 'S': return 2;
+        case 'W': return 3;
+        case 's': return 4;
+        default: return 5;
+    }
+}
+
+void encodeSteps(const std::string &steps, std::string &out) {
+    for (std::size_t i = 0; i < steps.size();) {
+        std::size_t run = 1;
+        while (run < MAX_RUN && i + run < steps.size() && steps[i + run] == steps[i]) {
+            run++;
+        }
+        if (run >= MIN_RUN) {
+            out += char(RUN | ((run - MIN_RUN) << 3) | stepCode(steps[i]));
+            i += run;
+        } else {
+            std::uint8_t second = i + 1 < steps.size() ? stepCode(steps[i + 1]) : NO_STEP;
+            out += char((stepCode(steps[i]) << 3) | second);
+            i += 2;
+        }
+    }
+}
+
+void decodeSteps(const char *data, std::size_t size, std::string &steps) {
+    for (std::size_t i = 0; i < size; i++) {
+        auto byte = std::uint8_t(data[i]);
+        if (byte & RUN) {
+            steps.append(((byte >> 3) & 0xF) + MIN_RUN, STEP_CHARS[std::min(byte & 7, 5)]);
+        } else {
+            steps += STEP_CHARS[std::min((byte >> 3) & 7, 5)];
+            if ((byte & 7) != NO_STEP) {
+                steps += STEP_CHARS[std::min(byte & 7, 5)];
+            }
+        }
+    }
+}
+
+int createTemporaryFile() {
+    std::error_code error;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(error);
+    if (error) {
+        dir = "/tmp";
+    }
+    std::string path = (dir / "myrobot-steps-XXXXXX").string();
+    int fd = mkstemp(path.data());
+    if (fd >= 0) {
+        // removed as soon as it is closed, even if the process dies
+        unlink(path.c_str());
+    }
+    return fd;
+}
+
+}
+
+StepLog::~StepLog() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void StepLog::clear() {
+    buffer.clear();
+    spillAt = spillSteps;
+    spilledSteps = 0;
+    fileBytes = 0;
+    if (fd >= 0 && ftruncate(fd, 0) != 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+void StepLog::reserve(std::uint64_t steps) {
+    buffer.reserve(std::size_t(std::min<std::uint64_t>(steps, spillSteps)));
+}
+
+void StepLog::spill() {
+    if (fd < 0) {
+        fd = createTemporaryFile();
+        if (fd < 0) {
+            spillAt = std::numeric_limits<std::size_t>::max();
+            return;
+        }
+    }
+    encoded.clear();
+    encodeSteps(buffer, encoded);
+    std::size_t done = 0;
+    while (done < encoded.size()) {
+        ssize_t n = pwrite(fd, encoded.data() + done, encoded.size() - done, off_t(fileBytes + done));
+        if (n <= 0) {
+            // disk full: the rest of the run stays in memory, the part written is past fileBytes and never read
+            spillAt = std::numeric_limits<std::size_t>::max();
+            return;
+        }
+        done += std::size_t(n);
+    }
+    fileBytes += encoded.size();
+    spilledSteps += buffer.size();
+    buffer.clear();
+}
+
+void StepLog::forEachEncodedBlock(const std::function<void(const char *, std::size_t)> &block) const {
+    std::string data(std::size_t(std::min<std::uint64_t>(READ_BLOCK, fileBytes)), '\0');
+    for (std::uint64_t offset = 0; offset < fileBytes;) {
+        std::size_t size = std::size_t(std::min<std::uint64_t>(READ_BLOCK, fileBytes - offset));
+        ssize_t n = pread(fd, data.data(), size, off_t(offset));
+        if (n <= 0) {
+            throw std::runtime_error("Failed to read the spilled step log");
+        }
+        block(data.data(), std::size_t(n));
+        offset += std::uint64_t(n);
+    }
+}
+
+void StepLog::forEachChunk(const std::function<void(const std::string &)> &chunk) const {
+    std::string steps;
+    std::string rest;
+    // a byte decodes to at most MAX_RUN steps, decoding a slice at a time bounds the pending steps
+    const std::size_t sliceBytes = std::max<std::size_t>(1, spillSteps / MAX_RUN);
+    forEachEncodedBlock([this, &chunk, &steps, &rest, sliceBytes](const char *data, std::size_t size) {
+        for (std::size_t offset = 0; offset < size; offset += sliceBytes) {
+            decodeSteps(data + offset, std::min(sliceBytes, size - offset), steps);
+            while (steps.size() >= spillSteps) {
+                rest.assign(steps, spillSteps);
+                steps.resize(spillSteps);
+                chunk(steps);
+                steps.swap(rest);
+            }
+        }
+    });
+    if (!steps.empty()) {
+        chunk(steps);
+    }
+    if (!buffer.empty()) {
+        chunk(buffer);
+    }
+}
+
+std::string StepLog::encode() const {
+    std::string out;
+    out.reserve(std::size_t(fileBytes) + buffer.size() / 2 + 1);
+    forEachEncodedBlock([&out](const char *data, std::size_t size) { out.append(data, size); });
+    encodeSteps(buffer, out);
+    return out;
+}
+
+void StepLog::decode(const char *data, std::size_t size) {
+    clear();
+    for (std::size_t offset = 0; offset < size; offset += READ_BLOCK) {
+        decodeSteps(data + offset, std::min(READ_BLOCK, size - offset), buffer);
+        if (buffer.size() >= spillAt) {
+            spill();
+        }
+    }
+}
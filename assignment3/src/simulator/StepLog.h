@@ -0,0 +1,78 @@
+#ifndef ASSIGNMENT3_STEPLOG_H
+#define ASSIGNMENT3_STEPLOG_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/* The steps of a run as written to the output file, one char per step ('N', 'E', 'S', 'W', 's', 'F').
+ * Up to 'spillSteps' steps are kept in memory. Beyond that, every full buffer is run length encoded and appended
+ * to an anonymous temporary file, so a run of MaxSteps >= 1e9 holds at most 'spillSteps' bytes of steps.
+ * Encoding, with the steps as their index in "NESWsF" (3 bits):
+ * - 0aaabbb: two steps a then b (b = 7: a alone, at the end of a spill)
+ * - 1lllsss: a run of l + 3 (3 to 18) steps s
+ * So the file is at most half the steps, and charging, cleaning and corridors take a byte per 18 steps: 2.5 to 5
+ * times smaller than the steps on the bench houses.
+ * The file is read and written with pread / pwrite only (no stdio lock), so a simulation thread cancelled in the
+ * middle of a spill cannot block the thread that writes the timeout output file. */
+class StepLog {
+public:
+    static constexpr std::size_t DEFAULT_SPILL_STEPS = std::size_t(1) << 24;
+
+    explicit StepLog(std::size_t spillSteps = DEFAULT_SPILL_STEPS) : spillSteps(spillSteps), spillAt(spillSteps) {}
+
+    ~StepLog();
+
+    StepLog(const StepLog &) = delete;
+
+    StepLog &operator=(const StepLog &) = delete;
+
+    /* forgets the steps, the buffer and the temporary file are kept for the next run */
+    void clear();
+
+    /* reserves room for 'steps' steps in memory (at most the spill threshold) */
+    void reserve(std::uint64_t steps);
+
+    void push(char step) {
+        buffer.push_back(step);
+        if (buffer.size() >= spillAt) {
+            spill();
+        }
+    }
+
+    std::uint64_t size() const { return spilledSteps + buffer.size(); }
+
+    /* true if some steps are in the temporary file, getSteps() is then only the end of the run */
+    bool isSpilled() const { return spilledSteps > 0; }
+
+    /* the steps still in memory */
+    const std::string &getSteps() const { return buffer; }
+
+    /* calls 'chunk' with all the steps in order, at most spillSteps of them at a time (the steps in memory come in
+     * a single chunk, larger only if spilling failed) */
+    void forEachChunk(const std::function<void(const std::string &)> &chunk) const;
+
+    /* all the steps in the spill encoding (the spilled part and the steps in memory), e.g. for a snapshot */
+    std::string encode() const;
+
+    /* replaces the steps with those of encode() */
+    void decode(const char *data, std::size_t size);
+
+private:
+    std::size_t spillSteps;
+    std::size_t spillAt; // spillSteps, or never once spilling failed in this run
+    std::string buffer;
+    std::string encoded; // spill() scratch
+    int fd = -1; // the unlinked temporary file, -1 until the first spill
+    std::uint64_t fileBytes = 0;
+    std::uint64_t spilledSteps = 0;
+
+    /* calls 'block' with the content of the temporary file, a block at a time */
+    void forEachEncodedBlock(const std::function<void(const char *, std::size_t)> &block) const;
+
+    /* encodes the buffer to the end of the temporary file. If no temporary file can be created the steps stay in
+     * memory, as they would without a threshold */
+    void spill();
+};
+
+#endif //ASSIGNMENT3_STEPLOG_H
@@ -0,0 +1,48 @@
+#include "TaskScheduler.h"
+
+TaskScheduler::TaskScheduler(std::size_t numOfHouses, std::size_t tasksPerHouse)
+        : numOfHouses(numOfHouses), tasksPerHouse(tasksPerHouse), readyOrder(numOfHouses), valid(numOfHouses, 0) {}
+
+bool TaskScheduler::claimHouse(std::size_t &houseId) {
+    // checked first so the counter does not keep growing once every house is claimed
+    if (nextHouse.load(std::memory_order_relaxed) >= numOfHouses) {
+        return false;
+    }
+    houseId = nextHouse.fetch_add(1, std::memory_order_relaxed);
+    return houseId < numOfHouses;
+}
+
+void TaskScheduler::houseValidated(std::size_t houseId, bool isValidHouse) {
+    {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        if (isValidHouse) {
+            valid[houseId] = 1;
+            readyOrder[readyCount.load(std::memory_order_relaxed)] = houseId;
+            readyCount.fetch_add(1, std::memory_order_release);
+        }
+        validatedCount.fetch_add(1, std::memory_order_release);
+    }
+    validatedCount.notify_all();
+}
+
+bool TaskScheduler::nextTask(std::size_t &houseId, std::size_t &taskInHouse) {
+    if (tasksPerHouse == 0) {
+        return false;
+    }
+    std::size_t task = nextTaskIndex.fetch_add(1, std::memory_order_relaxed);
+    std::size_t slot = task / tasksPerHouse;
+    while (true) {
+        // 'validated' is read before 'readyCount': if every house was validated, every ready house is visible
+        std::uint32_t validated = validatedCount.load(std::memory_order_acquire);
+        if (slot < readyCount.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (validated == numOfHouses) {
+            return false; // every valid house handed out all its tasks
+        }
+        validatedCount.wait(validated, std::memory_order_acquire);
+    }
+    houseId = readyOrder[slot];
+    taskInHouse = task % tasksPerHouse;
+    return true;
+}
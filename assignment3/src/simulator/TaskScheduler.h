@@ -0,0 +1,49 @@
+#ifndef ASSIGNMENT3_TASKSCHEDULER_H
+#define ASSIGNMENT3_TASKSCHEDULER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/* Hands out the work of a tournament to the worker threads: first the validation of the discovered house files,
+ * then the simulations of every house that turned out valid, as soon as it is.
+ * - claimHouse(): a house to validate (an atomic increment). Workers validate before they simulate, so the
+ *   houses are parsed in parallel and the simulations are unlocked as early as possible.
+ * - houseValidated(): publishes a valid house, its 'tasksPerHouse' tasks become available at once.
+ * - nextTask(): the next simulation task (an atomic increment). Task t belongs to the (t / tasksPerHouse)-th house
+ *   that became ready; if that house is still being validated the worker waits for it.
+ * A worker only waits once every house is claimed for validation, so the waits always end. */
+class TaskScheduler {
+public:
+    TaskScheduler(std::size_t numOfHouses, std::size_t tasksPerHouse);
+
+    /* returns false once every house is claimed */
+    bool claimHouse(std::size_t &houseId);
+
+    void houseValidated(std::size_t houseId, bool valid);
+
+    /* blocks until a task is ready, returns false once every valid house has handed out all its tasks */
+    bool nextTask(std::size_t &houseId, std::size_t &taskInHouse);
+
+    /* only meaningful once the workers are done */
+    bool isValid(std::size_t houseId) const { return valid[houseId]; }
+
+    std::size_t getValidHouses() const { return readyCount.load(std::memory_order_acquire); }
+
+private:
+    const std::size_t numOfHouses;
+    const std::size_t tasksPerHouse;
+
+    std::atomic<std::size_t> nextHouse{0};
+    std::atomic<std::size_t> nextTaskIndex{0};
+
+    std::mutex publishMutex; // orders the writes to readyOrder between validating workers
+    std::vector<std::size_t> readyOrder; // house ids, in the order they became ready
+    std::vector<char> valid;
+    std::atomic<std::size_t> readyCount{0};
+    std::atomic<std::uint32_t> validatedCount{0}; // valid or not, the workers wait on it
+};
+
+#endif //ASSIGNMENT3_TASKSCHEDULER_H
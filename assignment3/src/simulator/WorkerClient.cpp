@@ -0,0 +1,113 @@
+#include "WorkerClient.h"
+#include "Simulator.h"
+#include "Tracer.h"
+
+namespace {
+
+// how long to wait between two connection attempts
+constexpr int CONNECT_RETRY_MS = 200;
+
+std::vector<std::string> splitFields(const std::string &line) {
+    std::vector<std::string> fields;
+    std::istringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, '\t')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+}
+
+WorkerClient::WorkerClient(Runner &runner, std::string address) : runner(runner), address(std::move(address)) {
+    std::vector<std::string> houseNames = runner.getHouseNames();
+    for (std::size_t houseId = 0; houseId < houseNames.size(); houseId++) {
+        houseIds.emplace(houseNames[houseId], houseId);
+    }
+    std::vector<std::string> algoNames = runner.getAlgorithmNames();
+    for (std::size_t algoId = 0; algoId < algoNames.size(); algoId++) {
+        algoIds.emplace(algoNames[algoId], algoId);
+    }
+}
+
+void WorkerClient::run() {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < runner.getOptions().numOfThreads; ++i) {
+        threads.emplace_back(&WorkerClient::serveConnection, this, std::size_t(i));
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    std::cout << "Ran " << numOfRuns << " tasks for " << address << std::endl;
+}
+
+void WorkerClient::serveConnection(std::size_t connectionIndex) {
+    // every connection runs its tasks as a local worker would
+    runner.pinWorkerThread(connectionIndex);
+    Tracer::getTracer().setThreadName("connection " + std::to_string(connectionIndex));
+    StreamSocket connection;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CONNECT_TIMEOUT_MS);
+    while (!connection.valid()) {
+        try {
+            connection = StreamSocket::connect(address);
+        } catch (const std::exception &e) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                std::cerr << e.what() << std::endl;
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(CONNECT_RETRY_MS));
+        }
+    }
+
+    // Each connection keeps one simulator for all its tasks, as the local workers do
+    auto simulator = std::make_unique<Simulator>();
+    std::string response;
+    while (connection.writeAll("next\n") && connection.readLine(response)) {
+        std::vector<std::string> fields = splitFields(response);
+        if (fields.empty() || fields[0] == "done") {
+            return;
+        }
+        if (fields[0] == "wait" && fields.size() == 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::stoi(fields[1])));
+            continue;
+        }
+        if (fields[0] != "task") {
+            std::cerr << "Unexpected response from " << address << ": " << response << std::endl;
+            return;
+        }
+        if (!connection.writeAll(runTask(connectionIndex, fields, simulator) + "\n") || !connection.readLine(response)) {
+            break;
+        }
+        if (response != "ok") {
+            std::cerr << "Result rejected by " << address << ": " << response << std::endl;
+        }
+    }
+    // The coordinator closes the connections once every run has a result
+}
+
+std::string WorkerClient::runTask(std::size_t connectionIndex, const std::vector<std::string> &task,
+                                  std::unique_ptr<Simulator> &simulator) {
+    if (task.size() != 6) {
+        return "fail\t" + (task.size() > 1 ? task[1] : "0") + "\tinvalid task";
+    }
+    const std::string &taskId = task[1];
+    auto house = houseIds.find(task[2]);
+    if (house == houseIds.end() || !runner.isHouseValid(house->second)) {
+        return "fail\t" + taskId + "\tunknown or invalid house " + task[2] + " on this worker";
+    }
+    auto algo = algoIds.find(task[3]);
+    if (algo == algoIds.end()) {
+        return "fail\t" + taskId + "\tunknown algorithm " + task[3] + " on this worker";
+    }
+    std::uint64_t seed = task[4] == "-" ? NO_SEED : std::stoull(task[4]);
+
+    RunRecord record = runner.runOne(connectionIndex, house->second, algo->second, seed, task[5] == "1", simulator);
+    numOfRuns++;
+    std::ostringstream result;
+    result << "result\t" << taskId << '\t' << record.score << '\t' << getRunStatusName(record.status) << '\t'
+           << record.steps << '\t' << record.dirtLeft << '\t' << record.wallTimeUs;
+    if (runner.getOptions().trackMemory) {
+        result << '\t' << record.peakBytes << '\t' << record.allocations;
+    }
+    return result.str();
+}
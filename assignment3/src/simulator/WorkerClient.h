@@ -0,0 +1,36 @@
+#ifndef ASSIGNMENT3_WORKERCLIENT_H
+#define ASSIGNMENT3_WORKERCLIENT_H
+
+#include "Runner.h"
+#include "Socket.h"
+#include <unordered_map>
+
+/* The worker side of a Coordinator: runs the tasks a coordinator leases, with the algorithms and houses of its own
+ * runner (the same files, found with the same -house_path / -algo_path / -recursive layout as on the coordinator).
+ * Opens one connection per runner thread, each asking for a task, running it and reporting its result until the
+ * coordinator answers "done" or goes away. */
+class WorkerClient {
+public:
+    // how long a worker keeps trying to connect, the coordinator may still be validating its houses
+    static constexpr int CONNECT_TIMEOUT_MS = 30000;
+
+    WorkerClient(Runner &runner, std::string address);
+
+    /* returns once the coordinator has no more tasks */
+    void run();
+
+private:
+    Runner &runner;
+    std::string address;
+    std::unordered_map<std::string, std::size_t> houseIds;
+    std::unordered_map<std::string, std::size_t> algoIds;
+    std::atomic<std::size_t> numOfRuns = 0;
+
+    void serveConnection(std::size_t connectionIndex);
+
+    /* the response to a "task" line: a "result" or a "fail" request */
+    std::string runTask(std::size_t connectionIndex, const std::vector<std::string> &task,
+                        std::unique_ptr<Simulator> &simulator);
+};
+
+#endif //ASSIGNMENT3_WORKERCLIENT_H
@@ -1,11 +1,34 @@
 #include "utils.h"
 #include "AlgorithmRegistration.h"
-#include "Simulator.h"
-
-std::string houseDirPath = "";
-std::string algoDirPath = "";
-int numOfThreads = 10; // default value
-bool summaryOnly = false;
+#include "Runner.h"
+#include "Daemon.h"
+#include "Coordinator.h"
+#include "WorkerClient.h"
+#include "Tracer.h"
+#include <iomanip>
+
+RunnerOptions options;
+std::string resultsStreamPath = ""; // stream every result to this file as soon as it is ready (off if empty)
+ResultsFormat resultsFormat = ResultsFormat::CSV;
+std::string daemonSocketPath = ""; // serve jobs on this socket instead of running one tournament (off if empty)
+int reloadIntervalMs = 1000; // daemon mode: how often changed algorithm libraries are reloaded (0: never)
+std::string coordinatorAddress = ""; // run the tournament on the workers connecting to this address (off if empty)
+std::string workerAddress = ""; // run the tasks of the coordinator at this address (off if empty)
+int leaseMs = 10000; // coordinator mode: lease of a task on top of twice its house max steps
+std::string metricsPath = ""; // export the run metrics to this file (off if empty)
+MetricsFormat metricsFormat = MetricsFormat::Prometheus;
+int metricsIntervalMs = 1000; // how often the metrics file is rewritten during the run
+std::string tracePath = ""; // write a timeline of the run to this file, in the Chrome trace event format (off if empty)
+
+/* the batches of the output writer in the trace, called by the writer thread */
+void traceOutputBatch(Tracer::Clock::time_point start, Tracer::Clock::time_point end, std::size_t requests) {
+    thread_local bool named = false;
+    if (!named) {
+        Tracer::getTracer().setThreadName("output writer");
+        named = true;
+    }
+    Tracer::getTracer().complete("write files", start, end, Tracer::args({{"requests", std::to_string(requests)}}));
+}
 
 void print(std::string s) {
     std::cout << s << std::endl;
@@ -16,7 +39,13 @@ void handleCommandLineArguments(int argc, char **argv) {
         std::string arg = argv[i];
 
         if (arg == "-summary_only") {
-            summaryOnly = true;
+            options.summaryOnly = true;
+        } else if (arg == "-recursive") {
+            options.recursiveScan = true;
+        } else if (arg == "-pin_threads") {
+            options.pinThreads = true;
+        } else if (arg == "-track_memory") {
+            options.trackMemory = true;
         } else {
             std::istringstream ss(arg);
             std::string key;
@@ -28,11 +57,64 @@ void handleCommandLineArguments(int argc, char **argv) {
                 value.erase(0, value.find_first_not_of(" \t\n\r\f\v")); // Trim leading spaces
 
                 if (key == "-house_path") {
-                    houseDirPath = value;
+                    options.houseDirPath = value;
                 } else if (key == "-algo_path") {
-                    algoDirPath = value;
+                    options.algoDirPath = value;
                 } else if (key == "-num_threads") {
-                    numOfThreads = std::stoi(value);
+                    options.numOfThreads = std::stoi(value);
+                } else if (key == "-grid_layout") {
+                    options.gridLayout = parseGridLayout(value);
+                } else if (key == "-results_stream") {
+                    resultsStreamPath = value;
+                } else if (key == "-results_format") {
+                    resultsFormat = parseResultsFormat(value);
+                } else if (key == "-seeds") {
+                    options.numOfSeeds = std::stoi(value);
+                    if (options.numOfSeeds < 0) {
+                        throw std::runtime_error("Invalid number of seeds: " + value);
+                    }
+                } else if (key == "-cache") {
+                    options.cachePath = value;
+                } else if (key == "-daemon") {
+                    daemonSocketPath = value;
+                } else if (key == "-reload_interval") {
+                    reloadIntervalMs = std::stoi(value);
+                } else if (key == "-coordinator") {
+                    coordinatorAddress = value;
+                } else if (key == "-worker") {
+                    workerAddress = value;
+                } else if (key == "-lease_ms") {
+                    leaseMs = std::stoi(value);
+                } else if (key == "-metrics") {
+                    metricsPath = value;
+                } else if (key == "-metrics_format") {
+                    metricsFormat = parseMetricsFormat(value);
+                } else if (key == "-metrics_interval") {
+                    metricsIntervalMs = std::stoi(value);
+                } else if (key == "-trace") {
+                    tracePath = value;
+                } else if (key == "-record_sensors") {
+                    options.sensorTraceDir = value;
+                } else if (key == "-record_runs") {
+                    options.runTraceDir = value;
+                } else if (key == "-coverage") {
+                    options.coverageDir = value;
+                } else if (key == "-memory_cap") {
+                    // in MiB, a cap implies tracking
+                    int capMiB = std::stoi(value);
+                    if (capMiB <= 0) {
+                        throw std::runtime_error("Invalid memory cap: " + value);
+                    }
+                    options.memoryCapBytes = std::uint64_t(capMiB) << 20;
+                    options.trackMemory = true;
+                } else if (key == "-checkpoint") {
+                    options.checkpointDir = value;
+                } else if (key == "-checkpoint_interval") {
+                    long long interval = std::stoll(value);
+                    if (interval <= 0) {
+                        throw std::runtime_error("Invalid checkpoint interval: " + value);
+                    }
+                    options.checkpointInterval = std::uint64_t(interval);
                 } else {
                     throw std::runtime_error("Invalid argument key: " + key);
                 }
@@ -42,137 +124,18 @@ void handleCommandLineArguments(int argc, char **argv) {
         }
     }
     // if no houseDirPath is given, search in local working directory
-    if (houseDirPath.empty()) {
-        houseDirPath = std::filesystem::current_path().string();
+    if (options.houseDirPath.empty()) {
+        options.houseDirPath = std::filesystem::current_path().string();
     }
     // if no algoDirPath is given, search in local working directory
-    if (algoDirPath.empty()) {
-        algoDirPath = std::filesystem::current_path().string();
-    }
-}
-
-
-void runSim(Simulator *simulator, std::atomic<bool>* finished, std::condition_variable* cv_timeout, std::mutex* m, int* score) {
-    // Making the thread cancelable
-    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, nullptr);
-    pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, nullptr);
-
-    std::unique_lock<std::mutex> lock(*m); // Prevent the simulation thread from running before the main thread starts waiting
-    lock.unlock(); // Simulation thread should not hold the lock when executing the simulation
-
-    // Run the simulation and save the score
-    *score = simulator->run();
-
-    // Indicate that simulation has finished running
-    lock.lock();
-    *finished = true;
-    lock.unlock();
-
-    // Notify the main thread that the simulation is done
-    cv_timeout->notify_one();
-}
-
-int runWrapper(std::pair<std::string, std::unique_ptr<AbstractAlgorithm>> houseAlgoPair) {
-    const std::string &houseFilePath = houseAlgoPair.first;
-
-    // Get a reference to the algorithm object
-    AbstractAlgorithm& algo_ref = *houseAlgoPair.second;
-
-// Get the algo name using the reference
-    const std::type_info& type_info = typeid(algo_ref);
-    int status;
-    char *demangled = abi::__cxa_demangle(type_info.name(), nullptr, nullptr, &status);
-    std::string algo_name = (status == 0) ? demangled : type_info.name();
-    free(demangled);
-
-    std::unique_ptr<AbstractAlgorithm> algo = std::move(houseAlgoPair.second);
-
-    Simulator simulator(summaryOnly);
-    simulator.readHouseFile(houseFilePath);
-    simulator.setAlgorithm(std::move(algo));
-
-    int maxSteps = simulator.getMaxSteps();
-    int initialDirt = simulator.getInitialDirt();
-    int score = -1;  // Initialize score to an error value or default
-
-    std::atomic<bool> finished = false;
-    std::condition_variable cv_timeout;
-    std::mutex m;
-
-    // Prevent the simulation thread from running before the main thread starts waiting
-    std::unique_lock<std::mutex> lock(m);
-
-    // Create the simulation thread
-    std::thread simThread(runSim, &simulator, &finished, &cv_timeout, &m, &score);
-
-    // Put the main thread into waiting state and release the mutex
-    // Wait until cv notification or timeout has passed
-    if (!cv_timeout.wait_for(lock, std::chrono::milliseconds(maxSteps), [&finished]() { return finished.load(); })) {
-        // Thread running the simulation has reached its timeout
-        // Main thread reacquires the mutex
-        pthread_cancel(simThread.native_handle()); // Cancel the simulation thread
-        simThread.detach(); // Detach simulation thread, cleaning up without blocking the main thread
-
-        // Calculate the timeout score
-        int timeoutScore = (maxSteps * 2) + (initialDirt * 300) + 2000;
-
-        // Create an error file which notifies about the timeout
-        std::string errorFileName = algo_name + ".error";
-        writeError(errorFileName, "Timout has occurred running " + algo_name + " on " + houseFilePath);
-
-        // Create the timeout output file and return the timeout score
-        simulator.createTimeoutOutputFile(timeoutScore);
-        lock.unlock();
-        return timeoutScore;
-    } else {
-        // (Received cv notification) or (timeout has not passed and finished == true)
-        simThread.join();
-        return score;  // Return the score obtained from the simulation
-    }
-}
-
-void worker(std::queue<std::pair<std::string, std::unique_ptr<AbstractAlgorithm>>> &tasks, std::mutex &queueMutex,
-            std::map<std::string, std::map<std::string, int>> &results,
-            std::mutex &resultsMutex) {
-    while (true) {
-        std::pair<std::string, std::unique_ptr<AbstractAlgorithm>> task;
-
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            if (tasks.empty()) {
-                return; // No more tasks, exit thread
-            }
-            // Take the next task
-            task = std::move(tasks.front());
-            tasks.pop();
-        }
-
-        // Extract the file name from the full path
-        std::filesystem::path housePath(task.first);
-        std::string houseFileName = housePath.filename().string();
-
-        // Capture the algorithm name before moving the task
-        AbstractAlgorithm& algo_ref = *task.second;
-        const std::type_info& type_info = typeid(algo_ref);
-
-        int status;
-        char *demangled = abi::__cxa_demangle(type_info.name(), nullptr, nullptr, &status);
-        std::string algo_name = (status == 0) ? demangled : type_info.name();
-        free(demangled);  // Remember to free the demangled name
-
-        int score = runWrapper(std::move(task));
-        {
-            std::lock_guard<std::mutex> lock(resultsMutex);
-            results[houseFileName][algo_name] = score;
-        }
+    if (options.algoDirPath.empty()) {
+        options.algoDirPath = std::filesystem::current_path().string();
     }
 }
 
 
-void writeCSV(const std::string &filename,
-              const std::set<std::string> &algorithms,
-              const std::vector<std::string> &houses,
-              const std::map<std::string, std::map<std::string, int>> &results) {
+/* the columns are the valid houses of the job, in discovery order */
+void writeCSV(const std::string &filename, const Runner &runner, const Job &job, const JobResults &jobResults) {
     std::ofstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Failed to open CSV file: " << filename << std::endl;
@@ -181,30 +144,24 @@ void writeCSV(const std::string &filename,
 
     // Write the header
     file << "Algorithm/House";
-    for (const auto &house : houses) {
-        // Extract the file name from the full path
-        std::filesystem::path housePath(house);
-        std::string houseFileName = housePath.filename().string();
-        file << "," << houseFileName;
+    for (std::size_t h = 0; h < job.houseIds.size(); h++) {
+        if (jobResults.validHouses[h]) {
+            file << "," << runner.getHouseName(job.houseIds[h]);
+        }
     }
     file << "\n";
 
-    // Write the data
-    for (const auto &algorithm : algorithms) {
-        file << algorithm;
-        for (const auto &house : houses) {
-            // Extract the file name from the full path
-            std::filesystem::path housePath(house);
-            std::string houseFileName = housePath.filename().string();
-
-            auto algoIt = results.find(houseFileName);
-            if (algoIt != results.end()) {
-                auto houseIt = algoIt->second.find(algorithm);
-                if (houseIt != algoIt->second.end()) {
-                    file << "," << houseIt->second;
-                } else {
-                    file << ",";
-                }
+    // Write the data. With several runs per pair (-seeds) a cell holds the median score
+    std::vector<std::string> algoNames = runner.getAlgorithmNames();
+    for (std::size_t a = 0; a < job.algoIds.size(); a++) {
+        file << algoNames[job.algoIds[a]];
+        for (std::size_t h = 0; h < job.houseIds.size(); h++) {
+            if (!jobResults.validHouses[h]) {
+                continue;
+            }
+            ScoreStats stats = computeScoreStats(jobResults.results.getScores(h, a));
+            if (stats.runs > 0) {
+                file << "," << stats.p50;
             } else {
                 file << ",";
             }
@@ -213,141 +170,191 @@ void writeCSV(const std::string &filename,
     }
 }
 
-void checkHouseFiles(std::vector<std::string> &houseFiles) {
-    // Iterate over houseDirPath to find .house files
-    for (const auto &entry: std::filesystem::directory_iterator(houseDirPath)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".house") {
-            // Try to open the .house file
-            std::ifstream currHouseFile(entry.path());
-            if (!currHouseFile.is_open()) {
-                std::string errorFileName = entry.path().stem().string() + ".error";
-                writeError(errorFileName, "Failed to open house file: " + entry.path().string());
-                continue; // Skip this file
-            }
-            // Test if the house file is valid using readHouseFile
-            Simulator sim;
-            bool validHouseFile = sim.readHouseFile(entry.path());
-            if (!validHouseFile) {
-                std::string errorFileName = entry.path().stem().string() + ".error";
-                writeError(errorFileName, "Invalid house file: " + entry.path().string());
-                continue; // Skip this file
-            }
-            // If the file opened successfully and is valid, add it to the houseFiles vector
-            houseFiles.push_back(entry.path().string());
+/* one line per house x algorithm pair with the statistics of its runs (written with -seeds) */
+void writeStatsCSV(const std::string &filename, const Runner &runner, const Job &job, const JobResults &jobResults) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open CSV file: " << filename << std::endl;
+        return;
+    }
 
-            if (houseFiles.empty()) {
-                throw std::runtime_error("Cannot find .house files in " + std::filesystem::current_path().string());
-            }
-            // Close the file
-            currHouseFile.close();
+    file << "house,algorithm,runs,mean,stddev,min,p50,p90,p99,max\n";
+    file << std::fixed << std::setprecision(2);
+    std::vector<std::string> algoNames = runner.getAlgorithmNames();
+    for (std::size_t h = 0; h < job.houseIds.size(); h++) {
+        if (!jobResults.validHouses[h]) {
+            continue;
         }
-
-        if (houseFiles.empty()) {
-            throw std::runtime_error("Cannot find .house files in " + std::filesystem::current_path().string());
+        for (std::size_t a = 0; a < job.algoIds.size(); a++) {
+            ScoreStats stats = computeScoreStats(jobResults.results.getScores(h, a));
+            file << runner.getHouseName(job.houseIds[h]) << "," << algoNames[job.algoIds[a]] << "," << stats.runs;
+            if (stats.runs > 0) {
+                file << "," << stats.mean << "," << stats.stddev << "," << stats.min << "," << stats.p50 << ","
+                     << stats.p90 << "," << stats.p99 << "," << stats.max;
+            } else {
+                file << ",,,,,,,";
+            }
+            file << "\n";
         }
-
     }
 }
 
-void checkAlgorithmFiles(std::vector<void *> &algoHandles) {
-    // Iterate over algoDirPath to find .so files and open them with dlopen
-    for (const auto &entry: std::filesystem::directory_iterator(std::filesystem::path(algoDirPath))) {
-        if (entry.is_regular_file() &&
-            (entry.path().extension() == ".so" || entry.path().extension() == ".dylib")) {
-            void *handle = dlopen(entry.path().c_str(), RTLD_LAZY);
-            if (!handle) {
-                std::string errorFileName = entry.path().stem().string() + ".error";
-                writeError(errorFileName,
-                           "Failed to open algorithm file: " + entry.path().string() + "\ndlerror: " + dlerror());
-                continue; // Skip this file
-            }
-            // Store the handle for later dlclose
-            algoHandles.push_back(handle);
-        }
-
-        if (algoHandles.empty()) {
-            throw std::runtime_error("Cannot find .so files in " + std::filesystem::current_path().string());
-        }
+/* The heap use of the runs of a house x algorithm pair, by runner ids */
+struct PairMemory {
+    std::size_t runs = 0;
+    std::uint64_t peakBytes = 0; // the highest of the runs
+    std::uint64_t allocations = 0; // summed over the runs
+};
 
+/* one line per house x algorithm pair with the heap use of its algorithm (written with -track_memory) */
+void writeMemoryCSV(const std::string &filename, const Runner &runner, const Job &job, const JobResults &jobResults,
+                    const std::vector<PairMemory> &memory) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open CSV file: " << filename << std::endl;
+        return;
     }
-}
 
-void createHouseAlgoPairs(std::vector<std::string> &houseFiles, std::set<std::string> &algorithms, std::vector<std::pair<std::string, std::unique_ptr<AbstractAlgorithm>>> &houseAlgoPairs) {
-    // Create all possible pairs
-    for (const auto &house: houseFiles) {
-        for (const auto& algoFactoryPair : AlgorithmRegistrar::getAlgorithmRegistrar()) {
-            // Create the algorithm registrar
-            auto algorithm = algoFactoryPair.create();
-
-            // Check if the algorithm creation failed (returns nullptr)
-            if (algorithm) {
-                // Only add the pair if the algorithm is valid (non-null)
-                houseAlgoPairs.emplace_back(house, std::move(algorithm));
-                algorithms.insert(algoFactoryPair.name()); // using a set to prevent duplications
+    file << "house,algorithm,runs,peak_bytes,mean_allocations\n";
+    file << std::fixed << std::setprecision(2);
+    std::vector<std::string> algoNames = runner.getAlgorithmNames();
+    for (std::size_t h = 0; h < job.houseIds.size(); h++) {
+        if (!jobResults.validHouses[h]) {
+            continue;
+        }
+        for (std::size_t a = 0; a < job.algoIds.size(); a++) {
+            const PairMemory &pair = memory[job.houseIds[h] * algoNames.size() + job.algoIds[a]];
+            file << runner.getHouseName(job.houseIds[h]) << "," << algoNames[job.algoIds[a]] << "," << pair.runs;
+            if (pair.runs > 0) {
+                file << "," << pair.peakBytes << "," << double(pair.allocations) / double(pair.runs);
             } else {
-                std::string errorFileName = algoFactoryPair.name() + ".error";
-                writeError(errorFileName, "Algorithm Factory returned a nulptr for: " + algoFactoryPair.name());
-                break; // do not create house<->Algo pairs with this algorithm
+                file << ",,";
             }
+            file << "\n";
         }
     }
 }
 
-
 int main(int argc, char **argv) {
     try {
-        if (argc > 5) {
-            throw std::runtime_error("up to 5 command-line arguments allowed");
-        }
         handleCommandLineArguments(argc, argv);
 
-        std::vector<std::string> houseFiles;
-        checkHouseFiles(houseFiles);
+        // Tracing is on before any thread starts, so every thread records into its own buffer
+        if (!tracePath.empty()) {
+            Tracer::getTracer().enable();
+            Tracer::getTracer().setThreadName("main");
+        }
 
-        AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+        // Start the output writer thread here, simulation threads can be cancelled and must not create it
+        OutputWriter::getOutputWriter();
+        if (!tracePath.empty()) {
+            OutputWriter::getOutputWriter().setBatchObserver(traceOutputBatch);
+        }
 
-        std::vector<void *> algoHandles;
-        std::set<std::string> algorithms;
-        checkAlgorithmFiles(algoHandles);
+        // Declared before the runner, which points to them until it is destroyed
+        std::unique_ptr<Metrics> metrics;
+        Runner runner(options);
+        {
+            TraceSpan span("discover houses");
+            runner.discoverHouses();
+        }
+        {
+            TraceSpan span("load algorithms");
+            runner.loadAlgorithms();
+        }
 
-        // Vector to store pairs of house files and algorithm handles
-        std::vector<std::pair<std::string, std::unique_ptr<AbstractAlgorithm>>> houseAlgoPairs;
-        createHouseAlgoPairs(houseFiles, algorithms, houseAlgoPairs);
+        // Optional metrics, one slot per worker thread, exported periodically until the end of the run
+        if (!metricsPath.empty()) {
+            metrics = std::make_unique<Metrics>(runner.getOptions().numOfThreads, runner.getHouseNames(),
+                                                runner.getAlgorithmNames());
+            runner.setMetrics(metrics.get());
+            metrics->startExport(metricsPath, metricsFormat, metricsIntervalMs);
+        }
+        auto stopOutput = [&metrics]() {
+            if (metrics) {
+                metrics->stopExport();
+            }
+            OutputWriter::getOutputWriter().stop();
+            // written last: the output writer records into the trace until it stops
+            if (!tracePath.empty()) {
+                Tracer::getTracer().write(tracePath);
+            }
+        };
+
+        if (!daemonSocketPath.empty()) {
+            // Keep everything resident: the houses are parsed before the first request
+            runner.preloadHouses();
+            Daemon(runner, daemonSocketPath, reloadIntervalMs).serve();
+            stopOutput();
+            return 0;
+        }
 
-        std::queue<std::pair<std::string, std::unique_ptr<AbstractAlgorithm>>> tasks;
-        for (auto &pair: houseAlgoPairs) {
-            tasks.push(std::move(pair));
+        if (!workerAddress.empty()) {
+            // The houses are parsed before the first task, the coordinator only sends their names
+            runner.preloadHouses();
+            WorkerClient(runner, workerAddress).run();
+            stopOutput();
+            return 0;
         }
 
-        std::mutex queueMutex;
-        std::mutex resultsMutex;
-        std::vector<std::thread> threads;
-        std::map<std::string, std::map<std::string, int>> results;
+        Job job = runner.makeFullJob();
 
-        for (int i = 0; i < numOfThreads; ++i) {
-            threads.emplace_back(worker, std::ref(tasks), std::ref(queueMutex), std::ref(results), std::ref(resultsMutex));
+        // Optional stream of every result, written as the tasks complete
+        std::unique_ptr<ResultsSink> resultsSink;
+        if (!resultsStreamPath.empty()) {
+            resultsSink = std::make_unique<ResultsSink>(resultsStreamPath, resultsFormat, runner.getHouseNames(),
+                                                        runner.getAlgorithmNames());
         }
 
-        // Join the threads
-        for (auto &t: threads) {
-            if (t.joinable()) {
-                t.join();
+        // The records arrive from every worker thread
+        const std::size_t numOfAlgos = runner.getAlgorithmNames().size();
+        std::vector<PairMemory> memory(options.trackMemory ? runner.getHouseNames().size() * numOfAlgos : 0);
+        std::mutex memoryMutex;
+        Runner::RecordCallback onRecord = [&resultsSink, &memory, &memoryMutex, numOfAlgos](const RunRecord &record) {
+            if (resultsSink) {
+                resultsSink->append(record);
+            }
+            if (!memory.empty()) {
+                std::lock_guard<std::mutex> lock(memoryMutex);
+                PairMemory &pair = memory[record.houseId * numOfAlgos + record.algoId];
+                pair.runs++;
+                pair.peakBytes = std::max(pair.peakBytes, record.peakBytes);
+                pair.allocations += record.allocations;
             }
+        };
+        // The same job either on the local threads or on the workers of a coordinator
+        JobResults jobResults;
+        {
+            TraceSpan span("run job");
+            jobResults = coordinatorAddress.empty()
+                         ? runner.run(job, onRecord)
+                         : Coordinator(runner, coordinatorAddress, leaseMs).run(job, onRecord);
         }
 
-        // Write results to CSV
-        writeCSV("summary.csv", algorithms, houseFiles, results);
+        if (resultsSink) {
+            resultsSink->close();
+        }
 
-        // Clear the AlgorithmRegistrar to remove all registered algorithms
-        AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+        if (std::find(jobResults.validHouses.begin(), jobResults.validHouses.end(), true) == jobResults.validHouses.end()) {
+            stopOutput();
+            throw std::runtime_error("Cannot find valid .house files in " + options.houseDirPath);
+        }
 
-        // Close all opened .so files
-        for (void *handle: algoHandles) {
-            if (handle) {
-                dlclose(handle);
+        // Write results to CSV
+        {
+            TraceSpan span("write summary");
+            writeCSV("summary.csv", runner, job, jobResults);
+            if (options.numOfSeeds > 0) {
+                writeStatsCSV("summary_stats.csv", runner, job, jobResults);
+            }
+            if (options.trackMemory) {
+                writeMemoryCSV("summary_memory.csv", runner, job, jobResults, memory);
             }
         }
 
+        // Make sure every output and error file is written before exiting
+        stopOutput();
+
     } catch (const std::exception &e) {
         std::cerr << "Exception: " << e.what() << std::endl;
         return 1;
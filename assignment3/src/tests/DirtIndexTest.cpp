@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "DirtIndex.h"
+#include <utility>
+#include <vector>
+
+// A house of 100 x 150 cells: 2 x 3 regions of 64 x 64, the last ones partial
+class DirtIndexTest : public ::testing::Test {
+protected:
+    DirtIndex index;
+
+    void SetUp() override {
+        index.reset(100, 150);
+        index.setDirt(0, 0, 3);
+        index.setDirt(0, 63, 1);
+        index.setDirt(0, 64, 9);
+        index.setDirt(70, 149, 2);
+        index.setDirt(99, 5, 0); // clean cells are not indexed
+    }
+};
+
+TEST_F(DirtIndexTest, Counts) {
+    EXPECT_FALSE(index.isClean());
+    EXPECT_EQ(index.getTotalDirt(), 15);
+    EXPECT_EQ(index.getDirtyCells(), 4);
+    EXPECT_EQ(index.getDirtyCellsInRow(0), 3);
+    EXPECT_EQ(index.getDirtyCellsInRow(70), 1);
+    EXPECT_EQ(index.getDirtyCellsInRow(99), 0);
+    EXPECT_TRUE(index.isDirty(0, 63));
+    EXPECT_TRUE(index.isDirty(0, 64));
+    EXPECT_FALSE(index.isDirty(99, 5));
+}
+
+TEST_F(DirtIndexTest, Regions) {
+    EXPECT_EQ(index.getRegionRows(), 2);
+    EXPECT_EQ(index.getRegionCols(), 3);
+    EXPECT_EQ(index.getRegionDirt(0, 0), 4);
+    EXPECT_EQ(index.getRegionDirtyCells(0, 0), 2);
+    EXPECT_EQ(index.getRegionDirt(0, 1), 9);
+    EXPECT_EQ(index.getRegionDirtyCells(0, 1), 1);
+    EXPECT_EQ(index.getRegionDirt(1, 2), 2);
+    EXPECT_EQ(index.getRegionDirt(1, 0), 0);
+}
+
+TEST_F(DirtIndexTest, Cleaning) {
+    index.updateDirt(0, 0, 3, 2);
+    EXPECT_EQ(index.getTotalDirt(), 14);
+    EXPECT_EQ(index.getDirtyCells(), 4);
+    index.updateDirt(0, 63, 1, 0);
+    EXPECT_EQ(index.getDirtyCells(), 3);
+    EXPECT_FALSE(index.isDirty(0, 63));
+    EXPECT_EQ(index.getDirtyCellsInRow(0), 2);
+    EXPECT_EQ(index.getRegionDirtyCells(0, 0), 1);
+    // a restored snapshot may dirty a clean cell again
+    index.updateDirt(99, 5, 0, 4);
+    EXPECT_TRUE(index.isDirty(99, 5));
+    EXPECT_EQ(index.getRegionDirt(1, 0), 4);
+
+    index.updateDirt(0, 0, 2, 0);
+    index.updateDirt(0, 64, 9, 0);
+    index.updateDirt(70, 149, 2, 0);
+    index.updateDirt(99, 5, 4, 0);
+    EXPECT_TRUE(index.isClean());
+    EXPECT_EQ(index.getDirtyCells(), 0);
+}
+
+TEST_F(DirtIndexTest, ForEachDirtyCell) {
+    std::vector<std::pair<int, int>> cells;
+    index.forEachDirtyCell([&cells](int row, int col) { cells.emplace_back(row, col); });
+    std::vector<std::pair<int, int>> expected = {{0, 0}, {0, 63}, {0, 64}, {70, 149}};
+    EXPECT_EQ(cells, expected);
+}
+
+TEST_F(DirtIndexTest, Reset) {
+    index.reset(10, 10);
+    EXPECT_TRUE(index.isClean());
+    EXPECT_EQ(index.getDirtyCells(), 0);
+    EXPECT_EQ(index.getRegionRows(), 1);
+    EXPECT_FALSE(index.isDirty(0, 0));
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "Grid.h"
+#include <map>
+#include <set>
+
+// Every (row, col) of a tile has its own Z-order index, with the bits of col at the even positions
+TEST(GridTest, TileMortonIndex) {
+    std::set<int> indices;
+    for (int row = 0; row < GRID_TILE_SIZE; row++) {
+        for (int col = 0; col < GRID_TILE_SIZE; col++) {
+            int index = tileMortonIndex(row, col);
+            EXPECT_GE(index, 0);
+            EXPECT_LT(index, GRID_TILE_CELLS);
+            indices.insert(index);
+        }
+    }
+    EXPECT_EQ(indices.size(), std::size_t(GRID_TILE_CELLS));
+    EXPECT_EQ(tileMortonIndex(0, 1), 1);
+    EXPECT_EQ(tileMortonIndex(1, 0), 2);
+    EXPECT_EQ(tileMortonIndex(1, 1), 3);
+    EXPECT_EQ(tileMortonIndex(0, 2), 4);
+    EXPECT_EQ(tileMortonIndex(5, 3), 0b100111);
+    EXPECT_EQ(tileMortonIndex(7, 7), GRID_TILE_CELLS - 1);
+    // only the position inside the tile counts
+    EXPECT_EQ(tileMortonIndex(8 + 5, 16 + 3), tileMortonIndex(5, 3));
+}
+
+// Both layouts hold the same cells, also on the partial tiles of a grid that is not a multiple of 8
+TEST(GridTest, LayoutsHoldTheSameCells) {
+    const int rows = 13;
+    const int cols = 21;
+    Grid<int> rowMajor;
+    Grid<int> morton;
+    rowMajor.reset(rows, cols, GridLayout::RowMajor, -1);
+    morton.reset(rows, cols, GridLayout::Morton, -1);
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            rowMajor.at(row, col) = row * cols + col;
+            morton.at(row, col) = row * cols + col;
+        }
+    }
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            EXPECT_EQ(rowMajor.at(row, col), row * cols + col);
+            EXPECT_EQ(morton.at(row, col), row * cols + col);
+        }
+    }
+    EXPECT_EQ(morton.getLayout(), GridLayout::Morton);
+    EXPECT_TRUE(morton.inBounds(rows - 1, cols - 1));
+    EXPECT_FALSE(morton.inBounds(rows, 0));
+    EXPECT_FALSE(morton.inBounds(0, -1));
+}
+
+class TiledMapTest : public ::testing::TestWithParam<GridLayout> {
+protected:
+    // positions around the docking station, on both sides of the tile boundaries
+    std::map<std::pair<int, int>, int> cells() const {
+        std::map<std::pair<int, int>, int> positions;
+        int value = 1;
+        for (int row = -17; row <= 17; row += 3) {
+            for (int col = -70; col <= 70; col += 7) {
+                positions[{row, col}] = value++;
+            }
+        }
+        return positions;
+    }
+};
+
+// forEach gives back the position of every cell from its tile and index
+TEST_P(TiledMapTest, PositionRoundTrip) {
+    TiledMap<int> map(GetParam());
+    for (const auto &[position, value]: cells()) {
+        map[position] = value;
+    }
+    std::map<std::pair<int, int>, int> visited;
+    map.forEach([&visited](const std::pair<int, int> &position, int value) { visited[position] = value; });
+    EXPECT_EQ(visited, cells());
+    ASSERT_NE(map.find({-17, -70}), nullptr);
+    EXPECT_EQ(*map.find({-17, -70}), cells().at({-17, -70}));
+    EXPECT_EQ(map.find({1000, 1000}), nullptr);
+}
+
+TEST_P(TiledMapTest, SetLayout) {
+    TiledMap<int> map(GetParam());
+    for (const auto &[position, value]: cells()) {
+        map[position] = value;
+    }
+    GridLayout other = GetParam() == GridLayout::RowMajor ? GridLayout::Morton : GridLayout::RowMajor;
+    map.setLayout(other);
+    EXPECT_EQ(map.getLayout(), other);
+    std::map<std::pair<int, int>, int> visited;
+    map.forEach([&visited](const std::pair<int, int> &position, int value) { visited[position] = value; });
+    EXPECT_EQ(visited, cells());
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts, TiledMapTest, ::testing::Values(GridLayout::RowMajor, GridLayout::Morton));
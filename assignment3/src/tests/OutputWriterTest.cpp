@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "OutputWriter.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class OutputWriterTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              ("myrobot_output_writer_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::string path(const std::string &name) const { return (dir / name).string(); }
+
+    static std::string readFile(const std::string &fileName) {
+        std::ifstream file(fileName);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+};
+
+TEST_F(OutputWriterTest, TruncateAndAppend) {
+    OutputWriter &writer = OutputWriter::getOutputWriter();
+    writer.write(path("a"), "first\n", OutputWriter::Mode::Truncate);
+    writer.write(path("a"), "second\n", OutputWriter::Mode::Append);
+    writer.flush();
+    EXPECT_EQ(readFile(path("a")), "first\nsecond\n");
+
+    // a truncation drops what was appended before it, in the same batch or not
+    writer.write(path("a"), "third\n", OutputWriter::Mode::Append);
+    writer.write(path("a"), "new\n", OutputWriter::Mode::Truncate);
+    writer.write(path("a"), "end\n", OutputWriter::Mode::Append);
+    writer.flush();
+    EXPECT_EQ(readFile(path("a")), "new\nend\n");
+}
+
+TEST_F(OutputWriterTest, FlushWithNothingQueued) {
+    OutputWriter::getOutputWriter().flush();
+    OutputWriter::getOutputWriter().flush();
+}
+
+// Every thread finds all of its own writes in its file once its flush() returns, whatever the other threads push
+TEST_F(OutputWriterTest, FlushWaitsForTheCallersWrites) {
+    constexpr int THREADS = 8;
+    constexpr int ROUNDS = 50;
+    constexpr int LINES = 20;
+    std::vector<std::thread> threads;
+    std::vector<int> failures(THREADS, 0);
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([this, t, &failures] {
+            OutputWriter &writer = OutputWriter::getOutputWriter();
+            std::string fileName = path("thread_" + std::to_string(t));
+            for (int round = 0; round < ROUNDS; round++) {
+                std::string expected;
+                writer.write(fileName, "", OutputWriter::Mode::Truncate);
+                for (int line = 0; line < LINES; line++) {
+                    std::string text = std::to_string(round) + ":" + std::to_string(line) + "\n";
+                    writer.write(fileName, text, OutputWriter::Mode::Append);
+                    expected += text;
+                }
+                writer.flush();
+                if (readFile(fileName) != expected) {
+                    failures[t]++;
+                }
+            }
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    for (int t = 0; t < THREADS; t++) {
+        EXPECT_EQ(failures[t], 0) << "thread " << t;
+    }
+}
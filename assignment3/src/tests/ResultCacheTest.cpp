@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "ResultCache.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ResultCacheTest : public ::testing::Test {
+protected:
+    std::string fileName;
+
+    void SetUp() override {
+        fileName = (std::filesystem::temp_directory_path() / "myrobot_result_cache_test").string();
+        std::filesystem::remove(fileName);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(fileName);
+    }
+
+    static RunRecord makeRecord(std::int64_t score, RunStatus status = RunStatus::Finished) {
+        RunRecord record;
+        record.score = score;
+        record.status = status;
+        record.steps = score / 10;
+        record.dirtLeft = 3;
+        return record;
+    }
+
+    std::string readFile() const {
+        std::ifstream file(fileName);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+};
+
+TEST_F(ResultCacheTest, Keys) {
+    std::uint64_t key = ResultCache::makeKey(1, 2);
+    EXPECT_EQ(key, ResultCache::makeKey(1, 2, NO_SEED, 0));
+    EXPECT_NE(key, ResultCache::makeKey(2, 1));
+    EXPECT_NE(key, ResultCache::makeKey(1, 3));
+    EXPECT_NE(key, ResultCache::makeKey(1, 2, 0));
+    EXPECT_NE(ResultCache::makeKey(1, 2, 0), ResultCache::makeKey(1, 2, 1));
+    EXPECT_NE(key, ResultCache::makeKey(1, 2, NO_SEED, 1 << 20));
+    EXPECT_NE(ResultCache::makeKey(1, 2, NO_SEED, 1 << 20), ResultCache::makeKey(1, 2, NO_SEED, 2 << 20));
+}
+
+TEST_F(ResultCacheTest, StoreCommitLookup) {
+    ResultCache cache(fileName);
+    RunRecord record;
+    cache.store(1, makeRecord(100));
+    EXPECT_FALSE(cache.lookup(1, record)); // not committed yet
+    cache.commit();
+    ASSERT_TRUE(cache.lookup(1, record));
+    EXPECT_EQ(record.score, 100);
+    EXPECT_EQ(record.status, RunStatus::Finished);
+    EXPECT_EQ(record.steps, 10);
+    EXPECT_EQ(record.dirtLeft, 3);
+    EXPECT_EQ(record.wallTimeUs, 0u);
+
+    // only the runs that ended on their own are cached
+    cache.store(2, makeRecord(200, RunStatus::Timeout));
+    cache.store(3, makeRecord(300, RunStatus::Error));
+    cache.store(4, makeRecord(400, RunStatus::Dead));
+    cache.commit();
+    EXPECT_FALSE(cache.lookup(2, record));
+    EXPECT_FALSE(cache.lookup(3, record));
+    EXPECT_TRUE(cache.lookup(4, record));
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+// A stored result is in the file when store() returns, and a new cache (the next run) loads it
+TEST_F(ResultCacheTest, Persistence) {
+    {
+        ResultCache cache(fileName);
+        RunRecord record = makeRecord(100);
+        record.peakBytes = 4096;
+        record.allocations = 12;
+        cache.store(0xabc, record);
+        EXPECT_EQ(readFile(), "0000000000000abc 100 FINISHED 10 3 4096 12\n");
+        cache.store(0xdef, makeRecord(200));
+        cache.store(0xabc, makeRecord(300)); // the last line wins
+    }
+    ResultCache cache(fileName);
+    EXPECT_EQ(cache.size(), 2u);
+    RunRecord record;
+    ASSERT_TRUE(cache.lookup(0xabc, record));
+    EXPECT_EQ(record.score, 300);
+    EXPECT_EQ(record.peakBytes, 0u);
+    ASSERT_TRUE(cache.lookup(0xdef, record));
+    EXPECT_EQ(record.score, 200);
+}
+
+// The line cut by a crash is ignored, and the next results do not end up glued to it
+TEST_F(ResultCacheTest, CutLine) {
+    std::ofstream(fileName) << "0000000000000001 100 FINISHED 10 3\n0000000000000002 20";
+    {
+        ResultCache cache(fileName);
+        RunRecord record;
+        EXPECT_TRUE(cache.lookup(1, record));
+        EXPECT_FALSE(cache.lookup(2, record));
+        cache.store(3, makeRecord(300));
+    }
+    ResultCache cache(fileName);
+    RunRecord record;
+    EXPECT_FALSE(cache.lookup(2, record));
+    ASSERT_TRUE(cache.lookup(3, record));
+    EXPECT_EQ(record.score, 300);
+}
+
+// Every worker stores its results, none is lost or mixed with another
+TEST_F(ResultCacheTest, ConcurrentStores) {
+    constexpr int THREADS = 8;
+    constexpr int STORES = 200;
+    {
+        ResultCache cache(fileName);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; t++) {
+            threads.emplace_back([&cache, t] {
+                for (int i = 0; i < STORES; i++) {
+                    cache.store(std::uint64_t(t * STORES + i), makeRecord(t * STORES + i));
+                }
+            });
+        }
+        for (std::thread &thread: threads) {
+            thread.join();
+        }
+    }
+    ResultCache cache(fileName);
+    ASSERT_EQ(cache.size(), std::size_t(THREADS * STORES));
+    for (int key = 0; key < THREADS * STORES; key++) {
+        RunRecord record;
+        ASSERT_TRUE(cache.lookup(std::uint64_t(key), record));
+        EXPECT_EQ(record.score, key);
+    }
+}
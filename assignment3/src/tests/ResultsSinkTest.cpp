@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "ResultsSink.h"
+#include "OutputWriter.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* Records streamed by ResultsSink in every format are read back unchanged by readResultsStream() */
+class ResultsSinkTest : public ::testing::TestWithParam<ResultsFormat> {
+protected:
+    std::string fileName;
+    std::vector<std::string> houseNames = {"house_1.house", "sub,dir_\"quoted\"\t.house"};
+    std::vector<std::string> algoNames = {"Algorithm_A", "Algorithm_B"};
+
+    void SetUp() override {
+        fileName = (std::filesystem::temp_directory_path() /
+                    ("myrobot_results_sink_test_" + std::to_string(int(GetParam())))).string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(fileName);
+    }
+
+    std::vector<RunRecord> records(std::size_t count) const {
+        std::vector<RunRecord> all;
+        const RunStatus statuses[] = {RunStatus::Finished, RunStatus::Working, RunStatus::Dead, RunStatus::Timeout,
+                                      RunStatus::Error};
+        for (std::size_t i = 0; i < count; i++) {
+            RunRecord record;
+            record.houseId = std::uint32_t(i % houseNames.size());
+            record.algoId = std::uint32_t(i / houseNames.size() % algoNames.size());
+            record.seed = i % 3 == 0 ? NO_SEED : i;
+            record.score = std::int64_t(i) * 1000 - 5;
+            record.status = statuses[i % 5];
+            record.steps = std::int64_t(i) * 7;
+            record.dirtLeft = std::int64_t(i % 11);
+            record.wallTimeUs = i * 13;
+            record.peakBytes = i % 2 ? i * 4096 : 0;
+            record.allocations = i % 2 ? i : 0;
+            all.push_back(record);
+        }
+        return all;
+    }
+
+    void write(const std::vector<RunRecord> &all) {
+        ResultsSink sink(fileName, GetParam(), houseNames, algoNames);
+        for (const RunRecord &record: all) {
+            sink.append(record);
+        }
+        sink.close();
+        OutputWriter::getOutputWriter().flush();
+    }
+};
+
+TEST_P(ResultsSinkTest, RoundTrip) {
+    // more than a binary block
+    std::vector<RunRecord> all = records(ResultsSink::BINARY_BLOCK_RECORDS + 5);
+    write(all);
+    ResultsStream stream = readResultsStream(fileName, GetParam());
+    ASSERT_EQ(stream.records.size(), all.size());
+    for (std::size_t i = 0; i < all.size(); i++) {
+        const RunRecord &read = stream.records[i];
+        const RunRecord &expected = all[i];
+        EXPECT_EQ(stream.houseNames[read.houseId], houseNames[expected.houseId]) << i;
+        EXPECT_EQ(stream.algoNames[read.algoId], algoNames[expected.algoId]) << i;
+        EXPECT_EQ(read.seed, expected.seed) << i;
+        EXPECT_EQ(read.score, expected.score) << i;
+        EXPECT_EQ(read.status, expected.status) << i;
+        EXPECT_EQ(read.steps, expected.steps) << i;
+        EXPECT_EQ(read.dirtLeft, expected.dirtLeft) << i;
+        EXPECT_EQ(read.wallTimeUs, expected.wallTimeUs) << i;
+        EXPECT_EQ(read.peakBytes, expected.peakBytes) << i;
+        EXPECT_EQ(read.allocations, expected.allocations) << i;
+    }
+}
+
+// The end of a stream cut by a crash is ignored, the complete records before it are kept
+TEST_P(ResultsSinkTest, TruncatedStream) {
+    std::vector<RunRecord> all = records(ResultsSink::BINARY_BLOCK_RECORDS * 2);
+    write(all);
+    auto size = std::filesystem::file_size(fileName);
+    std::filesystem::resize_file(fileName, size - 3);
+    ResultsStream stream = readResultsStream(fileName, GetParam());
+    std::size_t kept = GetParam() == ResultsFormat::Binary ? ResultsSink::BINARY_BLOCK_RECORDS : all.size() - 1;
+    ASSERT_EQ(stream.records.size(), kept);
+    EXPECT_EQ(stream.records.back().score, all[kept - 1].score);
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, ResultsSinkTest,
+                         ::testing::Values(ResultsFormat::CSV, ResultsFormat::JSONLines, ResultsFormat::Binary));
+
+TEST(ResultsSinkJSONTest, EscapesControlCharacters) {
+    RunRecord record;
+    std::string line = ResultsSink::formatLine(ResultsFormat::JSONLines, record, "a\tb\x01\"c\\", "algo");
+    EXPECT_NE(line.find("\"house\":\"a\\u0009b\\u0001\\\"c\\\\\""), std::string::npos) << line;
+    for (char c: line.substr(0, line.size() - 1)) {
+        EXPECT_GE(static_cast<unsigned char>(c), 0x20);
+    }
+}
+
+TEST(ResultsSinkJSONTest, RejectsOtherFiles) {
+    std::string fileName = (std::filesystem::temp_directory_path() / "myrobot_results_sink_not_binary").string();
+    std::ofstream(fileName) << "house,algorithm\n";
+    EXPECT_THROW(readResultsStream(fileName, ResultsFormat::Binary), std::runtime_error);
+    std::filesystem::remove(fileName);
+    EXPECT_THROW(readResultsStream(fileName, ResultsFormat::CSV), std::runtime_error);
+}
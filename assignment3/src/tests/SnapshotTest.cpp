@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "Simulator.h"
+#include "OutputWriter.h"
+#include "Algorithm_206448649_314939398_A.h"
+#include "Algorithm_206448649_314939398_B.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* Simulator::saveSnapshot / restoreSnapshot with algorithm B (a SerializableAlgorithm), on a corpus house.
+ * The runs write their output file to the working directory of the test */
+class SnapshotTest : public ::testing::Test {
+protected:
+    static constexpr std::uint64_t SNAPSHOT_STEP = 50;
+
+    House house;
+
+    void SetUp() override {
+        ASSERT_TRUE(readHouse(std::string(TEST_CORPUS_DIR) + "/house_32.house", GridLayout::RowMajor, house));
+        house.fileName = "house_32.house";
+    }
+
+    /* the output file of the last run on the house */
+    static std::string readOutput() {
+        OutputWriter::getOutputWriter().flush();
+        std::ifstream file("house_32.house-B");
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    void start(Simulator &simulator, std::uint64_t seed) {
+        simulator.reset(house);
+        simulator.setAlgorithm(std::make_unique<Algorithm_206448649_314939398_B>(), "B");
+        ASSERT_TRUE(simulator.setSeed(seed));
+    }
+};
+
+// A run restored from its snapshot at step N goes on exactly like the original run: same result and output file,
+// with the steps before N from the snapshot
+TEST_F(SnapshotTest, RestoredRunMatchesOriginal) {
+    Simulator original;
+    start(original, 7);
+    std::vector<std::string> snapshots;
+    original.setCheckpointing(SNAPSHOT_STEP, [&snapshots](const std::string &state) { snapshots.push_back(state); });
+    std::int64_t score = original.run<FullOutputPolicy>();
+    ASSERT_GE(snapshots.size(), 2u) << "the run is too short for the test";
+    std::string output = readOutput();
+    ASSERT_FALSE(output.empty());
+
+    Simulator restored;
+    start(restored, 7);
+    restored.restoreSnapshot(snapshots[0]);
+    EXPECT_EQ(restored.getTotalSteps(), std::int64_t(SNAPSHOT_STEP));
+    std::vector<std::string> restoredSnapshots;
+    restored.setCheckpointing(SNAPSHOT_STEP, [&restoredSnapshots](const std::string &state) {
+        restoredSnapshots.push_back(state);
+    });
+    EXPECT_EQ(restored.run<FullOutputPolicy>(), score);
+    EXPECT_EQ(restored.getTotalSteps(), original.getTotalSteps());
+    EXPECT_EQ(restored.getTotalDirt(), original.getTotalDirt());
+    EXPECT_EQ(readOutput(), output);
+    // the algorithm state is serialized from hash maps, so only the number of checkpoints is compared
+    EXPECT_EQ(restoredSnapshots.size(), snapshots.size() - 1);
+}
+
+// stopCheckpointing() from the callback takes a single snapshot
+TEST_F(SnapshotTest, StopCheckpointing) {
+    Simulator simulator;
+    start(simulator, 1);
+    int calls = 0;
+    simulator.setCheckpointing(SNAPSHOT_STEP / 5, [&calls, &simulator](const std::string &) {
+        calls++;
+        simulator.stopCheckpointing();
+    });
+    simulator.run<SummaryOnlyPolicy>();
+    ASSERT_GT(simulator.getTotalSteps(), std::int64_t(SNAPSHOT_STEP));
+    EXPECT_EQ(calls, 1);
+}
+
+TEST_F(SnapshotTest, RejectsInvalidSnapshots) {
+    Simulator simulator;
+    start(simulator, 1);
+    std::string snapshot = simulator.saveSnapshot();
+
+    start(simulator, 1);
+    EXPECT_THROW(simulator.restoreSnapshot("not a snapshot"), std::runtime_error);
+    start(simulator, 1);
+    EXPECT_THROW(simulator.restoreSnapshot(snapshot.substr(0, snapshot.size() / 2)), std::runtime_error);
+
+    // another algorithm
+    simulator.reset(house);
+    simulator.setAlgorithm(std::make_unique<Algorithm_206448649_314939398_B>(), "other");
+    EXPECT_THROW(simulator.restoreSnapshot(snapshot), std::runtime_error);
+
+    // an algorithm that cannot restore its state
+    simulator.reset(house);
+    simulator.setAlgorithm(std::make_unique<Algorithm_206448649_314939398_A>(), "B");
+    EXPECT_THROW(simulator.restoreSnapshot(snapshot), std::runtime_error);
+
+    start(simulator, 1);
+    EXPECT_NO_THROW(simulator.restoreSnapshot(snapshot));
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "StepLog.h"
+
+namespace {
+
+/* every step of 'log', in order */
+std::string allSteps(const StepLog &log) {
+    std::string steps;
+    log.forEachChunk([&steps](const std::string &chunk) { steps += chunk; });
+    return steps;
+}
+
+/* pairs, runs of 3 to 18 (and longer) of every step, and an odd number of steps at the end */
+std::string mixedSteps() {
+    std::string steps = "NESWsNsEEs";
+    const std::string stepChars = "NESWs";
+    for (std::size_t length = 1; length <= 40; length++) {
+        steps.append(length, stepChars[length % stepChars.size()]);
+        steps += stepChars[(length + 2) % stepChars.size()];
+    }
+    return steps + "NNF";
+}
+
+}
+
+class StepLogTest : public ::testing::Test {
+protected:
+    // spills every 16 steps, so the tests go through the temporary file
+    StepLog log{16};
+
+    void push(const std::string &steps) {
+        for (char step: steps) {
+            log.push(step);
+        }
+    }
+};
+
+TEST_F(StepLogTest, InMemory) {
+    StepLog large;
+    for (char step: std::string("NNNsF")) {
+        large.push(step);
+    }
+    EXPECT_FALSE(large.isSpilled());
+    EXPECT_EQ(large.size(), 5u);
+    EXPECT_EQ(large.getSteps(), "NNNsF");
+    EXPECT_EQ(allSteps(large), "NNNsF");
+}
+
+TEST_F(StepLogTest, SpillRoundTrip) {
+    std::string steps = mixedSteps();
+    push(steps);
+    EXPECT_TRUE(log.isSpilled());
+    EXPECT_EQ(log.size(), steps.size());
+    EXPECT_LT(log.getSteps().size(), 16u);
+    EXPECT_EQ(allSteps(log), steps);
+}
+
+// A chunk never holds more than spillSteps steps, even when a spilled byte decodes to a long run
+TEST_F(StepLogTest, ChunkSize) {
+    std::string steps = std::string(1000, 's') + mixedSteps();
+    push(steps);
+    std::string chunks;
+    log.forEachChunk([&chunks](const std::string &chunk) {
+        EXPECT_LE(chunk.size(), 16u);
+        chunks += chunk;
+    });
+    EXPECT_EQ(chunks, steps);
+
+    StepLog decoded{100};
+    std::string encoded = log.encode();
+    decoded.decode(encoded.data(), encoded.size());
+    std::size_t numOfChunks = 0;
+    decoded.forEachChunk([&numOfChunks](const std::string &chunk) {
+        EXPECT_LE(chunk.size(), 100u);
+        numOfChunks++;
+    });
+    EXPECT_GE(numOfChunks, steps.size() / 100);
+}
+
+TEST_F(StepLogTest, EncodeDecode) {
+    std::string steps = mixedSteps();
+    push(steps);
+    std::string encoded = log.encode();
+    // at most a byte per 2 steps, and the runs take a byte per 18 steps at most
+    EXPECT_LE(encoded.size(), steps.size() / 2 + log.size() / 16 + 1);
+
+    StepLog decoded{16};
+    decoded.decode(encoded.data(), encoded.size());
+    EXPECT_EQ(decoded.size(), steps.size());
+    EXPECT_EQ(allSteps(decoded), steps);
+
+    StepLog inMemory;
+    inMemory.decode(encoded.data(), encoded.size());
+    EXPECT_FALSE(inMemory.isSpilled());
+    EXPECT_EQ(inMemory.getSteps(), steps);
+}
+
+TEST_F(StepLogTest, LongRuns) {
+    std::string steps(1000, 's');
+    steps += std::string(37, 'N') + "F";
+    push(steps);
+    std::string encoded = log.encode();
+    EXPECT_LT(encoded.size(), steps.size() / 10);
+    StepLog decoded;
+    decoded.decode(encoded.data(), encoded.size());
+    EXPECT_EQ(decoded.getSteps(), steps);
+}
+
+TEST_F(StepLogTest, ClearKeepsWorking) {
+    push(mixedSteps());
+    log.clear();
+    EXPECT_EQ(log.size(), 0u);
+    EXPECT_FALSE(log.isSpilled());
+    EXPECT_EQ(log.encode(), "");
+    push("EEEEEEEEEEEEEEEEEEEEWWs");
+    EXPECT_EQ(allSteps(log), "EEEEEEEEEEEEEEEEEEEEWWs");
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "TaskScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(TaskSchedulerTest, SingleWorker) {
+    TaskScheduler scheduler(3, 2);
+    std::size_t houseId = 0;
+    for (std::size_t expected = 0; expected < 3; expected++) {
+        ASSERT_TRUE(scheduler.claimHouse(houseId));
+        EXPECT_EQ(houseId, expected);
+    }
+    EXPECT_FALSE(scheduler.claimHouse(houseId));
+
+    // ready in the order they were validated, the invalid house has no tasks
+    scheduler.houseValidated(2, true);
+    scheduler.houseValidated(0, false);
+    scheduler.houseValidated(1, true);
+    EXPECT_EQ(scheduler.getValidHouses(), 2u);
+    EXPECT_FALSE(scheduler.isValid(0));
+    EXPECT_TRUE(scheduler.isValid(1));
+    EXPECT_TRUE(scheduler.isValid(2));
+
+    std::vector<std::pair<std::size_t, std::size_t>> tasks;
+    std::size_t taskInHouse = 0;
+    while (scheduler.nextTask(houseId, taskInHouse)) {
+        tasks.emplace_back(houseId, taskInHouse);
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> expected{{2, 0}, {2, 1}, {1, 0}, {1, 1}};
+    EXPECT_EQ(tasks, expected);
+    EXPECT_FALSE(scheduler.nextTask(houseId, taskInHouse));
+}
+
+TEST(TaskSchedulerTest, NoTasks) {
+    std::size_t houseId = 0;
+    std::size_t taskInHouse = 0;
+    TaskScheduler noHouses(0, 4);
+    EXPECT_FALSE(noHouses.claimHouse(houseId));
+    EXPECT_FALSE(noHouses.nextTask(houseId, taskInHouse));
+
+    TaskScheduler noAlgorithms(2, 0);
+    ASSERT_TRUE(noAlgorithms.claimHouse(houseId));
+    noAlgorithms.houseValidated(houseId, true);
+    EXPECT_FALSE(noAlgorithms.nextTask(houseId, taskInHouse));
+}
+
+// A worker asking for a task of a house still being validated waits for it, and gives up if it turns out invalid
+TEST(TaskSchedulerTest, WaitsForValidation) {
+    TaskScheduler scheduler(2, 1);
+    std::size_t first = 0;
+    std::size_t second = 0;
+    ASSERT_TRUE(scheduler.claimHouse(first));
+    ASSERT_TRUE(scheduler.claimHouse(second));
+
+    std::atomic<int> tasks{0};
+    std::atomic<bool> done{false};
+    std::thread worker([&] {
+        std::size_t houseId = 0;
+        std::size_t taskInHouse = 0;
+        while (scheduler.nextTask(houseId, taskInHouse)) {
+            EXPECT_EQ(houseId, second);
+            tasks++;
+        }
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done);
+    scheduler.houseValidated(second, true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(tasks, 1);
+    EXPECT_FALSE(done); // the second task could belong to the first house
+    scheduler.houseValidated(first, false);
+    worker.join();
+    EXPECT_TRUE(done);
+    EXPECT_EQ(tasks, 1);
+}
+
+// Workers validate then simulate like the runner does: every task of every valid house is handed out exactly once
+TEST(TaskSchedulerTest, ConcurrentWorkers) {
+    constexpr std::size_t HOUSES = 50;
+    constexpr std::size_t TASKS_PER_HOUSE = 7;
+    constexpr int WORKERS = 8;
+    TaskScheduler scheduler(HOUSES, TASKS_PER_HOUSE);
+    std::mutex mutex;
+    std::vector<int> handedOut(HOUSES * TASKS_PER_HOUSE, 0);
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < WORKERS; w++) {
+        workers.emplace_back([&] {
+            std::size_t houseId = 0;
+            while (scheduler.claimHouse(houseId)) {
+                scheduler.houseValidated(houseId, houseId % 3 != 0);
+            }
+            std::size_t taskInHouse = 0;
+            while (scheduler.nextTask(houseId, taskInHouse)) {
+                std::lock_guard<std::mutex> lock(mutex);
+                handedOut[houseId * TASKS_PER_HOUSE + taskInHouse]++;
+            }
+        });
+    }
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+
+    std::size_t validHouses = 0;
+    for (std::size_t houseId = 0; houseId < HOUSES; houseId++) {
+        bool valid = houseId % 3 != 0;
+        EXPECT_EQ(scheduler.isValid(houseId), valid);
+        validHouses += valid;
+        for (std::size_t task = 0; task < TASKS_PER_HOUSE; task++) {
+            EXPECT_EQ(handedOut[houseId * TASKS_PER_HOUSE + task], valid ? 1 : 0) << houseId << " " << task;
+        }
+    }
+    EXPECT_EQ(scheduler.getValidHouses(), validHouses);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "Tracer.h"
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+/* the tids of the trace file 'fileName', with the number of events of each */
+std::multiset<std::string> readTids(const std::string &fileName) {
+    std::ifstream file(fileName);
+    std::multiset<std::string> tids;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::size_t position = line.find("\"tid\":");
+        if (position != std::string::npos && line.find("\"ph\":\"M\"") == std::string::npos) {
+            position += 6;
+            tids.insert(line.substr(position, line.find_first_not_of("0123456789", position) - position));
+        }
+    }
+    return tids;
+}
+
+}
+
+class TracerTest : public ::testing::Test {
+protected:
+    std::string fileName;
+
+    void SetUp() override {
+        fileName = (std::filesystem::temp_directory_path() / "myrobot_tracer_test.json").string();
+        Tracer::getTracer().enable();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(fileName);
+    }
+};
+
+// Threads started one after the other share one track, none of their events is lost
+TEST_F(TracerTest, ExitedThreadsBuffersAreReused) {
+    Tracer::getTracer().write(fileName);
+    std::multiset<std::string> before = readTids(fileName);
+    std::set<std::string> tracksBefore(before.begin(), before.end());
+
+    constexpr int THREADS = 20;
+    for (int i = 0; i < THREADS; i++) {
+        std::thread([] { Tracer::getTracer().instant("reuse test"); }).join();
+    }
+    Tracer::getTracer().write(fileName);
+    std::multiset<std::string> after = readTids(fileName);
+    std::set<std::string> tracksAfter(after.begin(), after.end());
+    EXPECT_LE(tracksAfter.size(), tracksBefore.size() + 1);
+    EXPECT_EQ(after.size(), before.size() + THREADS);
+}
+
+// A thread keeps its newest events
+TEST_F(TracerTest, EventsAreCapped) {
+    std::string tid;
+    std::thread([&tid, this] {
+        for (std::size_t i = 0; i < Tracer::MAX_THREAD_EVENTS + 10; i++) {
+            Tracer::getTracer().instant("cap test");
+        }
+        // the last event is the only one with args
+        Tracer::getTracer().instant("cap test", Tracer::args({{"last", "yes"}}));
+        Tracer::getTracer().setThreadName("cap test thread");
+    }).join();
+    Tracer::getTracer().write(fileName);
+
+    std::ifstream file(fileName);
+    std::string line;
+    std::size_t capEvents = 0;
+    bool last = false;
+    while (std::getline(file, line)) {
+        if (line.find("\"name\":\"cap test\"") != std::string::npos) {
+            capEvents++;
+            last = line.find("\"last\":\"yes\"") != std::string::npos;
+        }
+    }
+    EXPECT_LE(capEvents, Tracer::MAX_THREAD_EVENTS);
+    EXPECT_GE(capEvents, Tracer::MAX_THREAD_EVENTS / 2);
+    EXPECT_TRUE(last);
+}
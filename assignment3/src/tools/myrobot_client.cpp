@@ -0,0 +1,48 @@
+#include "Socket.h"
+#include <iostream>
+#include <string>
+
+/* Submits one request to a myrobot daemon (myrobot -daemon=<socket>) and prints the response lines as they arrive.
+ * Usage: myrobot_client -socket=<path> <request...>
+ *   e.g. myrobot_client -socket=/tmp/myrobot.sock run houses=house_1.house seeds=10 summary_only
+ * Exits with 1 if the daemon answers with an error. */
+int main(int argc, char **argv) {
+    std::string socketPath;
+    std::string request;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("-socket=", 0) == 0) {
+            socketPath = arg.substr(8);
+        } else {
+            request += (request.empty() ? "" : " ") + arg;
+        }
+    }
+    if (socketPath.empty() || request.empty()) {
+        std::cerr << "Usage: " << argv[0] << " -socket=<path> list | run [houses=...] [algorithms=...] [seeds=N] "
+                  << "[summary_only] | shutdown" << std::endl;
+        return 1;
+    }
+
+    try {
+        StreamSocket socket = StreamSocket::connect(socketPath);
+        if (!socket.writeAll(request + "\n")) {
+            std::cerr << "Failed to send the request" << std::endl;
+            return 1;
+        }
+        std::string line;
+        while (socket.readLine(line)) {
+            if (line.rfind("ERROR", 0) == 0) {
+                std::cerr << line << std::endl;
+                return 1;
+            }
+            std::cout << line << std::endl;
+            if (line.rfind("END", 0) == 0) {
+                return 0;
+            }
+        }
+        std::cerr << "The daemon closed the connection" << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+    }
+    return 1;
+}
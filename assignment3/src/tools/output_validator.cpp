@@ -0,0 +1,406 @@
+#include "House.h"
+#include "Scoring.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* Checks <house>-<algorithm> output files against their houses: every Steps: line is re-simulated (without the
+ * algorithm) and the walls, the battery and the step limit are checked on the way, then NumSteps, DirtLeft, Status,
+ * InDock and Score are compared with the re-simulation. A file whose Score is the timeout score of its house, and
+ * whose steps and Status are those of a run cut before its end (no Finish step, the Status of the re-simulation),
+ * is a timed out run: its steps are checked, its counters (taken at an arbitrary point of a step) are not.
+ * The houses are parsed once each, then the files are validated in chunks by -num_threads threads.
+ * Usage: output_validator [-house_path=<dir>] [-recursive] [-num_threads=N] [<output files or directories...>]
+ * (the current directory by default). Exits with 1 if any file does not match its re-simulation. */
+namespace {
+
+// files claimed at once by a thread, consecutive files (of the same house) reuse the thread's grid copy
+constexpr std::size_t FILES_PER_CHUNK = 16;
+
+/* A house flattened for the re-simulation: row major with a border of walls, so a move is an index increment and
+ * a wall test is one compare, whatever the layout and the missing rows of the house file */
+struct ReplayHouse {
+    House house;
+    std::vector<char> cells;
+    int stride = 0; // padded columns
+    int dock = 0;
+    std::int64_t initialDirt = 0;
+
+    void flatten() {
+        int rows = house.layout.getRows();
+        int cols = house.layout.getCols();
+        stride = cols + 2;
+        cells.assign(std::size_t(rows + 2) * std::size_t(stride), 'W');
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                cells[std::size_t(r + 1) * stride + c + 1] = house.layout.at(r, c);
+            }
+        }
+        dock = (house.dockingStation.first + 1) * stride + house.dockingStation.second + 1;
+        initialDirt = house.dirt.getTotalDirt();
+    }
+};
+
+/* the fields of an output file */
+struct OutputFile {
+    std::int64_t numSteps = -1;
+    std::int64_t dirtLeft = -1;
+    std::string status;
+    std::string inDock;
+    std::int64_t score = -1;
+    std::string steps;
+    bool hasSteps = false;
+};
+
+struct ReplayResult {
+    std::int64_t steps = 0;
+    std::int64_t dirtLeft = 0;
+    bool finished = false;
+    bool inDock = true;
+    float batteryLevel = 0;
+    std::string violation; // empty if the steps are a valid run
+};
+
+struct FileTask {
+    std::filesystem::path path;
+    const ReplayHouse *house = nullptr;
+    std::string report{}; // the mismatches, empty if the file is valid
+    std::size_t steps = 0;
+    bool timeout = false;
+};
+
+bool parseOutputFile(const std::filesystem::path &path, OutputFile &output) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("Steps:", 0) == 0) {
+            output.steps = line.substr(line.size() > 6 && line[6] == ' ' ? 7 : 6);
+            output.hasSteps = true;
+            continue;
+        }
+        std::size_t equal = line.find(" = ");
+        if (equal == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, equal);
+        std::string value = line.substr(equal + 3);
+        try {
+            if (key == "NumSteps") {
+                output.numSteps = std::stoll(value);
+            } else if (key == "DirtLeft") {
+                output.dirtLeft = std::stoll(value);
+            } else if (key == "Status") {
+                output.status = value;
+            } else if (key == "InDock") {
+                output.inDock = value;
+            } else if (key == "Score") {
+                output.score = std::stoll(value);
+            }
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+    return output.hasSteps;
+}
+
+/* the same rules as Simulator::run(), on the flattened house. 'cells' is the caller's copy of house.cells, the cells
+ * it cleans are appended to 'cleaned' so the caller can restore them */
+ReplayResult replaySteps(const ReplayHouse &replayHouse, const std::string &steps, std::vector<char> &cells,
+                         std::vector<int> &cleaned) {
+    const House &house = replayHouse.house;
+    const float maxBattery = float(house.maxBattery);
+    const int stride = replayHouse.stride;
+    ReplayResult result;
+    result.dirtLeft = replayHouse.initialDirt;
+    float batteryLevel = maxBattery;
+    int position = replayHouse.dock;
+
+    for (std::size_t i = 0;; i++) {
+        if (result.steps > house.maxSteps) {
+            result.violation = "more than MaxSteps (" + std::to_string(house.maxSteps) + ") steps";
+            break;
+        }
+        if (batteryLevel == 0 && position != replayHouse.dock) {
+            result.violation = "battery empty away from the docking station after step " + std::to_string(i);
+            break;
+        }
+        if (i == steps.size()) {
+            break;
+        }
+        int move = 0;
+        switch (steps[i]) {
+            case 'F':
+                result.finished = true;
+                if (i + 1 != steps.size()) {
+                    result.violation = "steps after Finish";
+                }
+                break;
+            case 's':
+                if (position == replayHouse.dock) {
+                    batteryLevel = std::min(batteryLevel + maxBattery / 20, maxBattery);
+                } else {
+                    batteryLevel -= 1;
+                    char &cell = cells[position];
+                    if (cell >= '1' && cell <= '9') {
+                        cell--;
+                        result.dirtLeft--;
+                        cleaned.push_back(position);
+                    }
+                }
+                break;
+            case 'N':
+                move = -stride;
+                break;
+            case 'E':
+                move = 1;
+                break;
+            case 'S':
+                move = stride;
+                break;
+            case 'W':
+                move = -1;
+                break;
+            default:
+                result.violation = "invalid step '" + std::string(1, steps[i]) + "' at step " + std::to_string(i);
+                break;
+        }
+        if (result.finished || !result.violation.empty()) {
+            break;
+        }
+        if (move != 0) {
+            position += move;
+            if (cells[position] == 'W') {
+                result.violation = "walks into a wall at step " + std::to_string(i);
+                break;
+            }
+            batteryLevel -= 1;
+        }
+        result.steps++;
+    }
+    result.inDock = position == replayHouse.dock;
+    result.batteryLevel = batteryLevel;
+    return result;
+}
+
+template<typename T>
+void compareField(std::ostringstream &report, const char *field, const T &inFile, const T &replayed) {
+    if (inFile != replayed) {
+        report << "  " << field << " = " << inFile << ", re-simulation: " << replayed << '\n';
+    }
+}
+
+/* validates task.path, 'cells' is the calling thread's copy of the cells of task.house */
+void validateFile(FileTask &task, std::vector<char> &cells, std::vector<int> &cleaned) {
+    std::ostringstream report;
+    OutputFile output;
+    if (!parseOutputFile(task.path, output)) {
+        task.report = "  not a valid output file\n";
+        return;
+    }
+    const ReplayHouse &replayHouse = *task.house;
+    const House &house = replayHouse.house;
+
+    cleaned.clear();
+    ReplayResult result = replaySteps(replayHouse, output.steps, cells, cleaned);
+    for (int position: cleaned) {
+        cells[position] = replayHouse.cells[position];
+    }
+    task.steps = output.steps.size();
+
+    std::string status = calcRunStatus(result.finished, result.inDock, result.batteryLevel, result.steps,
+                                       house.maxSteps);
+    std::int64_t score = calcRunScore(status, result.inDock, result.steps, house.maxSteps, result.dirtLeft);
+    // a run cut by the timeout is scored by the house alone, its counters and steps were taken mid run. A finished
+    // run, or one whose Status is not that of its steps, is checked in full whatever its score
+    task.timeout = output.score != score && output.score == calcTimeoutScore(house.maxSteps, replayHouse.initialDirt) &&
+                   !result.finished && output.status == status;
+
+    if (!result.violation.empty()) {
+        // the simulator would have stopped the run there, the fields can't be compared
+        report << "  invalid steps: " << result.violation << '\n';
+    } else if (!task.timeout) {
+        compareField(report, "NumSteps", output.numSteps, result.steps);
+        compareField(report, "DirtLeft", output.dirtLeft, result.dirtLeft);
+        compareField(report, "Status", output.status, status);
+        compareField(report, "InDock", output.inDock, std::string(result.inDock ? "TRUE" : "FALSE"));
+        compareField(report, "Score", output.score, score);
+    }
+    task.report = report.str();
+}
+
+/* the house file name of an output file name <house file>-<algorithm> ("" if it is not one) */
+std::string getHouseFileName(const std::string &outputFileName) {
+    std::size_t end = outputFileName.find(".house-");
+    return end == std::string::npos ? "" : outputFileName.substr(0, end + 6);
+}
+
+bool isOutputFile(const std::filesystem::path &path) {
+    std::string extension = path.extension().string();
+    return !getHouseFileName(path.filename().string()).empty() && extension != ".error" && extension != ".trace";
+}
+
+/* runs 'work(i)' for every i < count on 'numOfThreads' threads, claiming 'chunk' indices at a time */
+template<typename Work>
+void parallelFor(std::size_t count, int numOfThreads, std::size_t chunk, const Work &work) {
+    std::atomic<std::size_t> next = 0;
+    auto loop = [&]() {
+        for (std::size_t begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk)) {
+            for (std::size_t i = begin; i < std::min(begin + chunk, count); i++) {
+                work(i);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numOfThreads; t++) {
+        threads.emplace_back(loop);
+    }
+    loop();
+    for (auto &thread: threads) {
+        thread.join();
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+    std::filesystem::path houseDirPath = std::filesystem::current_path();
+    bool recursive = false;
+    int numOfThreads = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::filesystem::path> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("-house_path=", 0) == 0) {
+            houseDirPath = arg.substr(12);
+        } else if (arg == "-recursive") {
+            recursive = true;
+        } else if (arg.rfind("-num_threads=", 0) == 0) {
+            numOfThreads = std::max(1, std::stoi(arg.substr(13)));
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Usage: " << argv[0] << " [-house_path=<dir>] [-recursive] [-num_threads=N] "
+                      << "[<output files or directories...>]" << std::endl;
+            return 1;
+        } else {
+            inputs.emplace_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        inputs.push_back(std::filesystem::current_path());
+    }
+
+    // The houses, by file name (the output files only have the file name of their house)
+    std::unordered_map<std::string, std::filesystem::path> housePaths;
+    auto addIfHouseFile = [&housePaths](const std::filesystem::directory_entry &entry) {
+        if (entry.is_regular_file() && entry.path().extension() == ".house") {
+            housePaths.emplace(entry.path().filename().string(), entry.path());
+        }
+    };
+    std::vector<FileTask> tasks;
+    try {
+        if (recursive) {
+            for (const auto &entry: std::filesystem::recursive_directory_iterator(houseDirPath)) {
+                addIfHouseFile(entry);
+            }
+        } else {
+            for (const auto &entry: std::filesystem::directory_iterator(houseDirPath)) {
+                addIfHouseFile(entry);
+            }
+        }
+        for (const auto &input: inputs) {
+            if (std::filesystem::is_directory(input)) {
+                for (const auto &entry: std::filesystem::directory_iterator(input)) {
+                    if (entry.is_regular_file() && isOutputFile(entry.path())) {
+                        tasks.push_back({entry.path()});
+                    }
+                }
+            } else {
+                tasks.push_back({input});
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Group the files by house, so the chunks a thread claims mostly share their house
+    std::sort(tasks.begin(), tasks.end(), [](const FileTask &a, const FileTask &b) {
+        return std::make_pair(getHouseFileName(a.path.filename().string()), a.path) <
+               std::make_pair(getHouseFileName(b.path.filename().string()), b.path);
+    });
+    std::unordered_map<std::string, std::size_t> houseIds;
+    std::vector<std::filesystem::path> usedHouses;
+    for (auto &task: tasks) {
+        auto house = housePaths.find(getHouseFileName(task.path.filename().string()));
+        if (house == housePaths.end()) {
+            task.report = "  no house file for it in " + houseDirPath.string() + "\n";
+        } else if (houseIds.emplace(house->first, usedHouses.size()).second) {
+            usedHouses.push_back(house->second);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    // Parse every house once, in parallel
+    std::vector<ReplayHouse> houses(usedHouses.size());
+    std::vector<char> validHouses(usedHouses.size());
+    parallelFor(usedHouses.size(), numOfThreads, 1, [&](std::size_t i) {
+        validHouses[i] = readHouse(usedHouses[i].string(), GridLayout::RowMajor, houses[i].house);
+        if (validHouses[i]) {
+            houses[i].flatten();
+        }
+    });
+    for (auto &task: tasks) {
+        auto houseId = houseIds.find(getHouseFileName(task.path.filename().string()));
+        if (houseId == houseIds.end()) {
+            continue;
+        }
+        if (validHouses[houseId->second]) {
+            task.house = &houses[houseId->second];
+        } else {
+            task.report = "  invalid house file " + usedHouses[houseId->second].string() + "\n";
+        }
+    }
+
+    // Validate the files, every thread re-simulates on its own copy of the cells of the current house
+    parallelFor(tasks.size(), numOfThreads, FILES_PER_CHUNK, [&](std::size_t i) {
+        thread_local const ReplayHouse *cellsHouse = nullptr;
+        thread_local std::vector<char> cells;
+        thread_local std::vector<int> cleaned;
+        FileTask &task = tasks[i];
+        if (!task.house) {
+            return;
+        }
+        if (cellsHouse != task.house) {
+            cells = task.house->cells;
+            cellsHouse = task.house;
+        }
+        validateFile(task, cells, cleaned);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t numOfMismatches = 0;
+    std::size_t numOfTimeouts = 0;
+    std::size_t numOfSteps = 0;
+    for (const auto &task: tasks) {
+        numOfSteps += task.steps;
+        numOfTimeouts += task.timeout;
+        if (!task.report.empty()) {
+            numOfMismatches++;
+            std::cout << task.path.string() << ":\n" << task.report;
+        }
+    }
+    std::cout << "Validated " << tasks.size() << " files (" << numOfSteps << " steps) in " << seconds * 1000
+              << " ms on " << numOfThreads << " threads: " << tasks.size() - numOfMismatches << " valid ("
+              << numOfTimeouts << " timeouts), " << numOfMismatches << " mismatches, "
+              << (seconds > 0 ? double(numOfSteps) / seconds / 1e6 : 0.0) << " M steps/s" << std::endl;
+    return numOfMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+#include "ResultsSink.h"
+#include "ResultsMatrix.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+/* Rebuilds summary.csv (and summary_stats.csv if the runs were seeded) from a results stream (myrobot
+ * -results_stream=<file>), e.g. of a tournament that died before writing its summary. The cells are the median
+ * scores of the records, as in myrobot's summary. The houses are the columns in the order of the stream (the
+ * order of their first record in the text formats), the algorithms the rows sorted by name.
+ * Usage: results_summary -results_stream=<file> [-results_format=csv|jsonl|bin] [-output_dir=<dir>] */
+namespace {
+
+void writeSummary(const std::string &fileName, const ResultsStream &stream, const ResultsMatrix &results,
+                  const std::vector<std::size_t> &algoOrder) {
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open CSV file: " + fileName);
+    }
+    file << "Algorithm/House";
+    for (const std::string &house: stream.houseNames) {
+        file << "," << house;
+    }
+    file << "\n";
+    for (std::size_t a: algoOrder) {
+        file << stream.algoNames[a];
+        for (std::size_t h = 0; h < stream.houseNames.size(); h++) {
+            ScoreStats stats = computeScoreStats(results.getScores(h, a));
+            if (stats.runs > 0) {
+                file << "," << stats.p50;
+            } else {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+}
+
+void writeStats(const std::string &fileName, const ResultsStream &stream, const ResultsMatrix &results,
+                const std::vector<std::size_t> &algoOrder) {
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open CSV file: " + fileName);
+    }
+    file << "house,algorithm,runs,mean,stddev,min,p50,p90,p99,max\n";
+    file << std::fixed << std::setprecision(2);
+    for (std::size_t h = 0; h < stream.houseNames.size(); h++) {
+        for (std::size_t a: algoOrder) {
+            ScoreStats stats = computeScoreStats(results.getScores(h, a));
+            file << stream.houseNames[h] << "," << stream.algoNames[a] << "," << stats.runs;
+            if (stats.runs > 0) {
+                file << "," << stats.mean << "," << stats.stddev << "," << stats.min << "," << stats.p50 << ","
+                     << stats.p90 << "," << stats.p99 << "," << stats.max;
+            } else {
+                file << ",,,,,,,";
+            }
+            file << "\n";
+        }
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+    std::string streamPath;
+    std::string outputDir = ".";
+    ResultsFormat format = ResultsFormat::CSV;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg.rfind("-results_stream=", 0) == 0) {
+                streamPath = arg.substr(16);
+            } else if (arg.rfind("-results_format=", 0) == 0) {
+                format = parseResultsFormat(arg.substr(16));
+            } else if (arg.rfind("-output_dir=", 0) == 0) {
+                outputDir = arg.substr(12);
+            } else {
+                streamPath.clear();
+                break;
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        streamPath.clear();
+    }
+    if (streamPath.empty()) {
+        std::cerr << "Usage: " << argv[0] << " -results_stream=<file> [-results_format=csv|jsonl|bin] "
+                  << "[-output_dir=<dir>]" << std::endl;
+        return 1;
+    }
+
+    try {
+        ResultsStream stream = readResultsStream(streamPath, format);
+        if (stream.records.empty()) {
+            throw std::runtime_error("No results in " + streamPath);
+        }
+
+        // The runs of a pair are its records in stream order, whatever their seeds
+        std::vector<std::size_t> runsPerPair(stream.houseNames.size() * stream.algoNames.size(), 0);
+        bool seeded = false;
+        for (const RunRecord &record: stream.records) {
+            runsPerPair[record.houseId * stream.algoNames.size() + record.algoId]++;
+            seeded = seeded || record.seed != NO_SEED;
+        }
+        ResultsMatrix results;
+        results.reset(stream.houseNames.size(), stream.algoNames.size(),
+                      std::max<std::size_t>(1, *std::max_element(runsPerPair.begin(), runsPerPair.end())));
+        std::fill(runsPerPair.begin(), runsPerPair.end(), 0);
+        for (const RunRecord &record: stream.records) {
+            std::size_t &run = runsPerPair[record.houseId * stream.algoNames.size() + record.algoId];
+            results.setScore(record.houseId, record.algoId, record.score, run++);
+        }
+
+        std::vector<std::size_t> algoOrder(stream.algoNames.size());
+        std::iota(algoOrder.begin(), algoOrder.end(), 0);
+        std::sort(algoOrder.begin(), algoOrder.end(), [&stream](std::size_t a, std::size_t b) {
+            return stream.algoNames[a] < stream.algoNames[b];
+        });
+
+        writeSummary(outputDir + "/summary.csv", stream, results, algoOrder);
+        if (seeded) {
+            writeStats(outputDir + "/summary_stats.csv", stream, results, algoOrder);
+        }
+        std::cout << stream.records.size() << " results of " << stream.houseNames.size() << " houses and "
+                  << stream.algoNames.size() << " algorithms" << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
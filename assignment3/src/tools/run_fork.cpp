@@ -0,0 +1,114 @@
+#include "Simulator.h"
+#include "AlgorithmRegistry.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* What-if continuations of a run: runs an algorithm on a house up to step N, takes a snapshot of the simulator and
+ * of the algorithm (see Simulator::saveSnapshot), then continues it K times from the snapshot, fork k with seed k,
+ * and prints how each fork ends next to the original run. The algorithm must be a SerializableAlgorithm, and a
+ * SeedableAlgorithm for the forks to differ (otherwise they all replay the original run from step N).
+ * Usage: run_fork -house=<file.house> -algo_path=<dir> [-algo=<name>] -step=N [-forks=K] [-seed=S]
+ * -seed seeds the original run (default: unseeded). */
+namespace {
+
+void printRun(const std::string &label, std::int64_t score, Simulator &simulator) {
+    std::cout << label << ": score " << score << ", " << simulator.getTotalSteps() << " steps, dirt left "
+              << simulator.getTotalDirt() << ", " << (score == -1 ? "ERROR" : simulator.calcStatus()) << std::endl;
+}
+
+}
+
+int main(int argc, char **argv) {
+    std::string housePath;
+    std::string algoDirPath;
+    std::string algoName;
+    long long forkStep = 0;
+    int numOfForks = 4;
+    long long seed = -1;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg.rfind("-house=", 0) == 0) {
+                housePath = arg.substr(7);
+            } else if (arg.rfind("-algo_path=", 0) == 0) {
+                algoDirPath = arg.substr(11);
+            } else if (arg.rfind("-algo=", 0) == 0) {
+                algoName = arg.substr(6);
+            } else if (arg.rfind("-step=", 0) == 0) {
+                forkStep = std::stoll(arg.substr(6));
+            } else if (arg.rfind("-forks=", 0) == 0) {
+                numOfForks = std::stoi(arg.substr(7));
+            } else if (arg.rfind("-seed=", 0) == 0) {
+                seed = std::stoll(arg.substr(6));
+            } else {
+                housePath.clear();
+                break;
+            }
+        }
+    } catch (const std::exception &) {
+        housePath.clear();
+    }
+    if (housePath.empty() || algoDirPath.empty() || forkStep <= 0 || numOfForks <= 0) {
+        std::cerr << "Usage: " << argv[0] << " -house=<file.house> -algo_path=<dir> [-algo=<name>] -step=N "
+                  << "[-forks=K] [-seed=S]" << std::endl;
+        return 1;
+    }
+
+    try {
+        AlgorithmRegistry algorithms;
+        algorithms.loadDirectory(algoDirPath, false);
+        std::vector<std::string> algoNames = algorithms.getNames();
+        if (algoName.empty() && algoNames.size() == 1) {
+            algoName = algoNames.front();
+        }
+        auto algoId = std::find(algoNames.begin(), algoNames.end(), algoName) - algoNames.begin();
+        if (std::size_t(algoId) == algoNames.size()) {
+            throw std::runtime_error(algoName.empty() ? "Several algorithms in " + algoDirPath + ", select one with -algo"
+                                                      : "Algorithm " + algoName + " is not in " + algoDirPath);
+        }
+        std::shared_ptr<const AlgorithmVersion> algorithm = algorithms.get(std::size_t(algoId));
+
+        House house;
+        if (!readHouse(housePath, GridLayout::RowMajor, house)) {
+            throw std::runtime_error("Invalid house file: " + housePath);
+        }
+        house.fileName = std::filesystem::path(housePath).filename().string();
+
+        // the original run, its snapshot is taken at the first checkpoint and the run goes on without checkpoints
+        Simulator simulator;
+        simulator.reset(house);
+        simulator.setAlgorithm(algorithm->factory(), algoName);
+        if (seed >= 0 && !simulator.setSeed(std::uint64_t(seed))) {
+            throw std::runtime_error(algoName + " is not seedable");
+        }
+        std::string snapshot;
+        simulator.setCheckpointing(std::uint64_t(forkStep), [&snapshot, &simulator](const std::string &state) {
+            snapshot = state;
+            simulator.stopCheckpointing();
+        });
+        std::int64_t score = simulator.run<SummaryOnlyPolicy>();
+        printRun(algoName + " on " + house.fileName, score, simulator);
+        if (snapshot.empty()) {
+            throw std::runtime_error("The run ended before step " + std::to_string(forkStep) +
+                                     " (or the algorithm cannot save its state)");
+        }
+        std::cout << "Snapshot at step " << forkStep << ": " << snapshot.size() << " bytes" << std::endl;
+
+        simulator.setCheckpointing(0, nullptr);
+        for (int k = 0; k < numOfForks; k++) {
+            simulator.reset(house);
+            simulator.setAlgorithm(algorithm->factory(), algoName);
+            simulator.restoreSnapshot(snapshot);
+            bool seeded = simulator.setSeed(std::uint64_t(k));
+            score = simulator.run<SummaryOnlyPolicy>();
+            printRun("Fork " + std::to_string(k) + (seeded ? " (seed " + std::to_string(k) + ")" : ""), score,
+                     simulator);
+        }
+        simulator.clearAlgorithm();
+    } catch (const std::exception &e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "RunTrace.h"
+#include "TerminalRenderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+/* Plays back a run trace (myrobot -record_runs=<dir>) in the terminal, without the simulator or the algorithm.
+ * Usage: run_player [-step=N] [-play] [-speed=<steps per second>] [-fps=N] [-view=<cols>x<rows>] <file.run>
+ * - without -play: prints the state at step N (default: the end of the run), found from the closest keyframe
+ * - with -play: plays from step N (default 0) to the end at -speed steps per second (default 20), redrawing at most
+ *   -fps times per second (default 30), so a high speed skips the steps between two frames. Only the cells that
+ *   changed since the previous frame are redrawn (see TerminalRenderer)
+ * Only a -view sized window (default 80x24) around the robot is drawn. */
+namespace {
+
+std::string readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/* the first coordinate of a 'size' window around 'center', kept inside [0, total) */
+int windowStart(int center, int size, int total) {
+    return std::clamp(center - size / 2, 0, std::max(0, total - size));
+}
+
+/* the state of the run, a line each */
+std::vector<std::string> formatStatus(const RunTracePlayer &player) {
+    const RunTraceHeader &header = player.getHeader();
+    const RunTraceState &state = player.getState();
+    std::ostringstream step;
+    step << "Step " << state.step << " / " << player.getNumOfSteps();
+    if (state.step > 0) {
+        step << " (" << "NESWsF"[int(player.getStep(state.step - 1))] << ")";
+    }
+    step << "   Battery " << std::floor(state.batteryLevel) << " / " << header.maxBattery
+         << "   Dirt left " << state.dirtLeft << "   Position (" << state.row << ", " << state.col << ")";
+    return {header.algoName + " on " + header.houseName, step.str()};
+}
+
+/* the house around the robot and the state of the run */
+std::string formatFrame(const RunTracePlayer &player, int viewCols, int viewRows) {
+    const RunTraceHeader &header = player.getHeader();
+    const RunTraceState &state = player.getState();
+    std::ostringstream frame;
+    for (const std::string &line: formatStatus(player)) {
+        frame << line << '\n';
+    }
+
+    int firstRow = windowStart(state.row, viewRows, header.rows);
+    int firstCol = windowStart(state.col, viewCols, header.cols);
+    int lastRow = std::min(header.rows, firstRow + viewRows);
+    int lastCol = std::min(header.cols, firstCol + viewCols);
+    std::string line;
+    for (int r = firstRow; r < lastRow; r++) {
+        line.clear();
+        for (int c = firstCol; c < lastCol; c++) {
+            line += (r == state.row && c == state.col) ? 'V' : player.getCell(r, c);
+        }
+        frame << line << '\n';
+    }
+    return frame.str();
+}
+
+}
+
+int main(int argc, char **argv) {
+    std::string tracePath;
+    long long startStep = -1;
+    bool play = false;
+    double speed = 20;
+    double fps = 30;
+    int viewCols = 80;
+    int viewRows = 24;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg.rfind("-step=", 0) == 0) {
+                startStep = std::stoll(arg.substr(6));
+            } else if (arg == "-play") {
+                play = true;
+            } else if (arg.rfind("-speed=", 0) == 0) {
+                speed = std::stod(arg.substr(7));
+            } else if (arg.rfind("-fps=", 0) == 0) {
+                fps = std::stod(arg.substr(5));
+            } else if (arg.rfind("-view=", 0) == 0) {
+                std::size_t x = arg.find('x', 6);
+                viewCols = std::stoi(arg.substr(6, x - 6));
+                viewRows = std::stoi(arg.substr(x + 1));
+            } else {
+                tracePath = arg;
+            }
+        }
+    } catch (const std::exception &) {
+        tracePath.clear();
+    }
+    if (tracePath.empty() || speed <= 0 || fps <= 0 || viewCols <= 0 || viewRows <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [-step=N] [-play] [-speed=<steps per second>] [-fps=N] "
+                  << "[-view=<cols>x<rows>] <file.run>" << std::endl;
+        return 1;
+    }
+
+    try {
+        RunTracePlayer player(readFile(tracePath));
+        if (!play) {
+            player.seek(startStep < 0 ? player.getNumOfSteps() : std::uint64_t(startStep));
+            std::cout << formatFrame(player, viewCols, viewRows) << player.getNumOfKeyframes() << " keyframes, one every "
+                      << player.getHeader().keyframeInterval << " steps" << std::endl;
+            return 0;
+        }
+
+        player.seek(startStep < 0 ? 0 : std::uint64_t(startStep));
+        // below one step per frame, the frames are spaced by the steps instead
+        const double frameSeconds = std::max(1.0 / fps, 1.0 / speed);
+        const double stepsPerFrame = speed * frameSeconds;
+        double pendingSteps = 0;
+        const RunTraceHeader &header = player.getHeader();
+        // the status lines are drawn above the view
+        TerminalRenderer renderer(viewCols, viewRows + 3);
+        auto nextFrame = std::chrono::steady_clock::now();
+        while (true) {
+            renderer.draw(formatStatus(player), header.rows, header.cols, player.getState().row,
+                          player.getState().col, [&player](int row, int col) {
+                        const RunTraceState &state = player.getState();
+                        return row == state.row && col == state.col ? 'V' : player.getCell(row, col);
+                    });
+            if (player.getState().step >= player.getNumOfSteps()) {
+                break;
+            }
+            for (pendingSteps += stepsPerFrame; pendingSteps >= 1 && player.stepForward(); pendingSteps -= 1) {
+            }
+            nextFrame += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(frameSeconds));
+            std::this_thread::sleep_until(nextFrame);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << tracePath << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
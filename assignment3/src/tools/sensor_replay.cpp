@@ -0,0 +1,126 @@
+#include "AlgorithmRegistry.h"
+#include "AlgorithmExtensions.h"
+#include "SensorTrace.h"
+#include "ResultsSink.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Replays sensor traces (myrobot -record_sensors=<dir>) on the algorithms of an algorithm directory, without the
+ * simulator: a fresh instance of the recorded algorithm gets the recorded sensor answers, and every step it returns
+ * is checked against the recorded one. The time reported is the algorithm's own (nextStep() and its sensor calls),
+ * so it can be profiled (perf, callgrind) on a real run without the simulation around it.
+ * Usage: sensor_replay -algo_path=<dir> [-repeat=N] <trace files...>
+ * Exits with 1 if a replay diverged from its recorded run (a non deterministic or changed algorithm). */
+namespace {
+
+std::string readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/* one replay of 'replayer' on a new instance of 'algorithm', returns the number of steps (diverged or not) */
+std::size_t replayOnce(const AlgorithmVersion &algorithm, SensorReplayer &replayer) {
+    replayer.rewind();
+    std::unique_ptr<AbstractAlgorithm> algo = algorithm.factory();
+    if (!algo) {
+        throw std::runtime_error("Algorithm Factory returned a nulptr for: " + algorithm.name);
+    }
+    algo->setMaxSteps(std::size_t(replayer.getHeader().maxSteps));
+    algo->setWallsSensor(replayer);
+    algo->setDirtSensor(replayer);
+    algo->setBatteryMeter(replayer);
+    if (replayer.getHeader().seed != NO_SEED) {
+        auto *seedable = dynamic_cast<SeedableAlgorithm *>(algo.get());
+        if (!seedable) {
+            throw std::runtime_error(algorithm.name + " is not seedable, but the trace is of a seeded run");
+        }
+        seedable->setSeed(replayer.getHeader().seed);
+    }
+    std::size_t numOfSteps = 0;
+    while (!replayer.done() && !replayer.hasDiverged()) {
+        Step step = algo->nextStep();
+        if (!replayer.checkStep(step)) {
+            break;
+        }
+        numOfSteps++;
+    }
+    return numOfSteps;
+}
+
+}
+
+int main(int argc, char **argv) {
+    std::string algoDirPath;
+    int repeat = 1;
+    std::vector<std::string> tracePaths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("-algo_path=", 0) == 0) {
+            algoDirPath = arg.substr(11);
+        } else if (arg.rfind("-repeat=", 0) == 0) {
+            repeat = std::max(1, std::stoi(arg.substr(8)));
+        } else {
+            tracePaths.push_back(arg);
+        }
+    }
+    if (algoDirPath.empty() || tracePaths.empty()) {
+        std::cerr << "Usage: " << argv[0] << " -algo_path=<dir> [-repeat=N] <trace files...>" << std::endl;
+        return 1;
+    }
+
+    AlgorithmRegistry algorithms;
+    try {
+        algorithms.loadDirectory(algoDirPath, false);
+    } catch (const std::exception &e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    std::vector<std::string> algoNames = algorithms.getNames();
+
+    bool allMatched = true;
+    for (const std::string &tracePath: tracePaths) {
+        try {
+            SensorReplayer replayer(readFile(tracePath));
+            const SensorTraceHeader &header = replayer.getHeader();
+            auto algoId = std::find(algoNames.begin(), algoNames.end(), header.algoName) - algoNames.begin();
+            if (std::size_t(algoId) == algoNames.size()) {
+                throw std::runtime_error("Algorithm " + header.algoName + " is not in " + algoDirPath);
+            }
+            std::shared_ptr<const AlgorithmVersion> algorithm = algorithms.get(std::size_t(algoId));
+
+            std::size_t numOfSteps = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeat && !replayer.hasDiverged(); r++) {
+                numOfSteps += replayOnce(*algorithm, replayer);
+            }
+            auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+
+            std::cout << tracePath << ": " << header.algoName << " on " << header.houseName;
+            if (header.seed != NO_SEED) {
+                std::cout << " (seed " << header.seed << ")";
+            }
+            if (replayer.hasDiverged()) {
+                allMatched = false;
+                std::cout << " DIVERGED: " << replayer.getError() << std::endl;
+                continue;
+            }
+            std::cout << std::fixed << std::setprecision(1) << ", " << numOfSteps / repeat << " steps, "
+                      << (numOfSteps ? double(elapsedNs) / double(numOfSteps) : 0.0) << " ns/step" << std::endl;
+        } catch (const std::exception &e) {
+            allMatched = false;
+            std::cerr << tracePath << ": " << e.what() << std::endl;
+        }
+    }
+    return allMatched ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#ifndef ASSIGNMENT3_ALGORITHMSTATE_H
+#define ASSIGNMENT3_ALGORITHMSTATE_H
+
+#include "utils.h"
+#include "Grid.h"
+#include <cstring>
+#include <type_traits>
+
+/* Helpers of the SerializableAlgorithm implementations: the state is a flat little endian byte string of the
+ * fields in the order they are written, read back in the same order. */
+class StateWriter {
+public:
+    template<typename T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
+
+    void write(const std::pair<int, int> &position) {
+        write(std::int32_t(position.first));
+        write(std::int32_t(position.second));
+    }
+
+    template<typename Steps>
+    void writeSteps(const Steps &steps) {
+        write(std::uint64_t(steps.size()));
+        for (Step step: steps) {
+            write(std::uint8_t(step));
+        }
+    }
+
+    /* the cells of the explored map, neighbors in their order (the algorithms iterate them) */
+    void writeVertices(const TiledMap<std::shared_ptr<Vertex>> &vertices) {
+        std::uint64_t count = 0;
+        vertices.forEach([&count](const std::pair<int, int> &, const std::shared_ptr<Vertex> &) { count++; });
+        write(count);
+        vertices.forEach([this](const std::pair<int, int> &, const std::shared_ptr<Vertex> &vertex) {
+            write(vertex->position);
+            write(std::uint8_t(vertex->visited));
+            write(std::int32_t(vertex->d));
+            write(std::uint8_t(vertex->pai));
+            write(std::int32_t(vertex->vertexDirtLevel));
+            write(std::uint32_t(vertex->neighbors.size()));
+            for (const auto &neighbor: vertex->neighbors) {
+                write(neighbor);
+            }
+        });
+    }
+
+    void writeDirt(const TiledMap<int> &dirt) {
+        std::uint64_t count = 0;
+        dirt.forEach([&count](const std::pair<int, int> &, int) { count++; });
+        write(count);
+        dirt.forEach([this](const std::pair<int, int> &position, int level) {
+            write(position);
+            write(std::int32_t(level));
+        });
+    }
+
+    const std::string &getState() const { return out; }
+
+private:
+    std::string out;
+};
+
+/* throws std::runtime_error if the state is shorter than what is read */
+class StateReader {
+public:
+    explicit StateReader(const std::string &in) : in(in) {}
+
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (sizeof(T) > in.size() - position) {
+            throw std::runtime_error("Truncated algorithm state");
+        }
+        T value;
+        std::memcpy(&value, in.data() + position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+
+    std::pair<int, int> readPosition() {
+        auto row = read<std::int32_t>();
+        return {row, read<std::int32_t>()};
+    }
+
+    template<typename Steps>
+    void readSteps(Steps &steps) {
+        steps.clear();
+        auto size = read<std::uint64_t>();
+        for (std::uint64_t i = 0; i < size; i++) {
+            steps.push_back(readStep());
+        }
+    }
+
+    void readVertices(TiledMap<std::shared_ptr<Vertex>> &vertices) {
+        vertices.clear();
+        auto count = read<std::uint64_t>();
+        for (std::uint64_t i = 0; i < count; i++) {
+            auto position = readPosition();
+            bool visited = read<std::uint8_t>() != 0;
+            auto d = read<std::int32_t>();
+            auto vertex = std::make_shared<Vertex>(position, d, readStep());
+            vertex->visited = visited;
+            vertex->vertexDirtLevel = read<std::int32_t>();
+            auto numOfNeighbors = read<std::uint32_t>();
+            if (numOfNeighbors > 4) {
+                throw std::runtime_error("Invalid vertex in algorithm state");
+            }
+            vertex->neighbors.resize(numOfNeighbors);
+            for (auto &neighbor: vertex->neighbors) {
+                neighbor = readPosition();
+            }
+            vertices[position] = std::move(vertex);
+        }
+    }
+
+    void readDirt(TiledMap<int> &dirt) {
+        dirt.clear();
+        auto count = read<std::uint64_t>();
+        for (std::uint64_t i = 0; i < count; i++) {
+            auto position = readPosition();
+            dirt[position] = read<std::int32_t>();
+        }
+    }
+
+    Step readStep() {
+        auto step = read<std::uint8_t>();
+        if (step > std::uint8_t(Step::Finish)) {
+            throw std::runtime_error("Invalid step in algorithm state");
+        }
+        return Step(step);
+    }
+
+    /* every field was read */
+    bool done() const { return position == in.size(); }
+
+private:
+    const std::string &in;
+    std::size_t position = 0;
+};
+
+#endif //ASSIGNMENT3_ALGORITHMSTATE_H
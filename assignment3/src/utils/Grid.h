@@ -0,0 +1,213 @@
+#ifndef ASSIGNMENT3_GRID_H
+#define ASSIGNMENT3_GRID_H
+
+#include "enums.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* Both layouts group cells into blocks of 64:
+ * - RowMajor: plain row-major storage (Grid) / 1x64 row strips (TiledMap)
+ * - Morton: 8x8 square tiles, cells inside a tile are stored in Z-order.
+ *   An 8x8 tile of chars is exactly one 64 byte cache line, so a North/South move stays in the same line. */
+constexpr int GRID_TILE_SHIFT = 3;
+constexpr int GRID_TILE_SIZE = 1 << GRID_TILE_SHIFT;
+constexpr int GRID_TILE_MASK = GRID_TILE_SIZE - 1;
+constexpr int GRID_TILE_CELLS = GRID_TILE_SIZE * GRID_TILE_SIZE;
+
+inline GridLayout parseGridLayout(const std::string &name) {
+    if (name == "row_major") return GridLayout::RowMajor;
+    if (name == "morton") return GridLayout::Morton;
+    throw std::runtime_error("Invalid grid layout: " + name + " (expected row_major / morton)");
+}
+
+inline std::string getGridLayoutName(GridLayout layout) {
+    return layout == GridLayout::Morton ? "morton" : "row_major";
+}
+
+/* Z-order index of (row, col) inside a single tile: interleave the 3 low bits of col (even bits) and row (odd bits) */
+inline int tileMortonIndex(int row, int col) {
+    auto spread = [](int v) { return (v & 1) | ((v & 2) << 1) | ((v & 4) << 2); };
+    return spread(col & GRID_TILE_MASK) | (spread(row & GRID_TILE_MASK) << 1);
+}
+
+/* Dense rows x cols grid, used by the simulator for the house layout */
+template<typename T>
+class Grid {
+public:
+    Grid() = default;
+
+    /* resize to rows x cols and fill every cell with 'fill'. Keeps the allocated capacity */
+    void reset(int newRows, int newCols, GridLayout newLayout, const T &fill = T()) {
+        rows = newRows;
+        cols = newCols;
+        layout = newLayout;
+        tileCols = (cols + GRID_TILE_MASK) >> GRID_TILE_SHIFT;
+        if (layout == GridLayout::RowMajor) {
+            cells.assign(std::size_t(rows) * cols, fill);
+        } else {
+            int tileRows = (rows + GRID_TILE_MASK) >> GRID_TILE_SHIFT;
+            cells.assign(std::size_t(tileRows) * tileCols * GRID_TILE_CELLS, fill);
+        }
+    }
+
+    bool inBounds(int row, int col) const {
+        return row >= 0 && row < rows && col >= 0 && col < cols;
+    }
+
+    T &at(int row, int col) { return cells[index(row, col)]; }
+
+    const T &at(int row, int col) const { return cells[index(row, col)]; }
+
+    int getRows() const { return rows; }
+
+    int getCols() const { return cols; }
+
+    GridLayout getLayout() const { return layout; }
+
+    bool empty() const { return rows == 0 || cols == 0; }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    int tileCols = 0;
+    GridLayout layout = GridLayout::RowMajor;
+    std::vector<T> cells;
+
+    std::size_t index(int row, int col) const {
+        if (layout == GridLayout::RowMajor) {
+            return std::size_t(row) * cols + col;
+        }
+        std::size_t tile = std::size_t(row >> GRID_TILE_SHIFT) * tileCols + (col >> GRID_TILE_SHIFT);
+        return tile * GRID_TILE_CELLS + tileMortonIndex(row, col);
+    }
+};
+
+/* Unbounded map from (row, col) to T, used by the algorithms for the explored house map.
+ * Positions are relative to the docking station (may be negative). Cells are stored in lazily allocated
+ * tiles of 64, missing cells read as T(), so operator[] behaves like std::unordered_map::operator[]. */
+template<typename T>
+class TiledMap {
+public:
+    explicit TiledMap(GridLayout layout = GridLayout::RowMajor) : layout(layout) {}
+
+    TiledMap(const TiledMap &) = delete;
+
+    TiledMap &operator=(const TiledMap &) = delete;
+
+    T &operator[](const std::pair<int, int> &position) {
+        TileKey key = tileKey(position);
+        if (!lastTile || key != lastKey) {
+            auto &tile = tiles[key];
+            if (!tile) {
+                tile = std::make_unique<Tile>();
+            }
+            lastKey = key;
+            lastTile = tile.get();
+        }
+        return (*lastTile)[cellIndex(position)];
+    }
+
+    /* returns nullptr if the tile holding 'position' was never allocated */
+    const T *find(const std::pair<int, int> &position) const {
+        auto it = tiles.find(tileKey(position));
+        if (it == tiles.end()) {
+            return nullptr;
+        }
+        return &(*it->second)[cellIndex(position)];
+    }
+
+    /* change the layout, re-homing every cell that holds a non default value */
+    void setLayout(GridLayout newLayout) {
+        if (newLayout == layout) {
+            return;
+        }
+        auto oldTiles = std::move(tiles);
+        GridLayout oldLayout = layout;
+        clear();
+        layout = newLayout;
+        for (auto &[key, tile]: oldTiles) {
+            for (int i = 0; i < GRID_TILE_CELLS; i++) {
+                if ((*tile)[i] != T()) {
+                    (*this)[cellPosition(oldLayout, key, i)] = std::move((*tile)[i]);
+                }
+            }
+        }
+    }
+
+    void clear() {
+        tiles.clear();
+        lastTile = nullptr;
+    }
+
+    /* calls 'visit' with the position and value of every cell that holds a non default value */
+    template<typename Visit>
+    void forEach(const Visit &visit) const {
+        for (const auto &[key, tile]: tiles) {
+            for (int i = 0; i < GRID_TILE_CELLS; i++) {
+                if ((*tile)[i] != T()) {
+                    visit(cellPosition(layout, key, i), (*tile)[i]);
+                }
+            }
+        }
+    }
+
+    /* set every cell back to T() but keep the allocated tiles, for scratch maps that are refilled often */
+    void resetValues() {
+        for (auto &[key, tile]: tiles) {
+            tile->fill(T());
+        }
+    }
+
+    GridLayout getLayout() const { return layout; }
+
+private:
+    using Tile = std::array<T, GRID_TILE_CELLS>;
+    using TileKey = std::pair<int, int>;
+
+    struct TileKeyHash {
+        std::size_t operator()(const TileKey &key) const {
+            return (std::uint64_t(std::uint32_t(key.first)) << 32 | std::uint32_t(key.second)) * 0x9E3779B97F4A7C15ull;
+        }
+    };
+
+    GridLayout layout;
+    std::unordered_map<TileKey, std::unique_ptr<Tile>, TileKeyHash> tiles;
+    // the explored map is accessed around the robot, so the last used tile is cached to skip the hash lookup
+    TileKey lastKey;
+    Tile *lastTile = nullptr;
+
+    TileKey tileKey(const std::pair<int, int> &position) const {
+        if (layout == GridLayout::RowMajor) {
+            return {position.first, position.second >> (2 * GRID_TILE_SHIFT)};
+        }
+        return {position.first >> GRID_TILE_SHIFT, position.second >> GRID_TILE_SHIFT};
+    }
+
+    int cellIndex(const std::pair<int, int> &position) const {
+        if (layout == GridLayout::RowMajor) {
+            return position.second & (GRID_TILE_CELLS - 1);
+        }
+        return tileMortonIndex(position.first, position.second);
+    }
+
+    static std::pair<int, int> cellPosition(GridLayout cellLayout, const TileKey &key, int index) {
+        if (cellLayout == GridLayout::RowMajor) {
+            return {key.first, (key.second << (2 * GRID_TILE_SHIFT)) | index};
+        }
+        int row = 0, col = 0;
+        for (int bit = 0; bit < GRID_TILE_SHIFT; bit++) {
+            col |= ((index >> (2 * bit)) & 1) << bit;
+            row |= ((index >> (2 * bit + 1)) & 1) << bit;
+        }
+        return {(key.first << GRID_TILE_SHIFT) | row, (key.second << GRID_TILE_SHIFT) | col};
+    }
+};
+
+#endif //ASSIGNMENT3_GRID_H
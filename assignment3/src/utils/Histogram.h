@@ -0,0 +1,110 @@
+#ifndef ASSIGNMENT3_HISTOGRAM_H
+#define ASSIGNMENT3_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+/* An HDR style histogram of non negative values (latencies): exact below 32, then 16 linear sub-buckets per power
+ * of two, so any recorded value is known within 1/16 (about 6%) whatever its magnitude. Fixed size, no allocation.
+ * A histogram has a single writer (record() is a relaxed load + store, no read-modify-write), other threads may
+ * take a snapshot at any time: it can miss the latest values, never tear a counter. */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << SUB_BUCKET_BITS;
+    // the exact buckets below 2 * SUB_BUCKETS, then SUB_BUCKETS per power of two up to 2^63
+    static constexpr std::size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    /* the bucket of 'value' */
+    static constexpr std::size_t bucketOf(std::uint64_t value) {
+        if (value < 2 * SUB_BUCKETS) {
+            return std::size_t(value);
+        }
+        int shift = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+        return std::size_t(shift + 1) * SUB_BUCKETS + std::size_t((value >> shift) - SUB_BUCKETS);
+    }
+
+    /* the smallest value of 'bucket' */
+    static constexpr std::uint64_t bucketValue(std::size_t bucket) {
+        if (bucket < 2 * SUB_BUCKETS) {
+            return bucket;
+        }
+        std::size_t shift = bucket / SUB_BUCKETS - 1;
+        return std::uint64_t(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    }
+
+    /* single writer only */
+    void record(std::uint64_t value) {
+        add(buckets[bucketOf(value)], 1);
+        add(sum, value);
+        if (value > max.load(std::memory_order_relaxed)) {
+            max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /* adds the values of 'histogram', which is no longer written (single writer only) */
+    void merge(const LatencyHistogram &histogram) {
+        for (std::size_t i = 0; i < NUM_BUCKETS; i++) {
+            add(buckets[i], histogram.buckets[i].load(std::memory_order_relaxed));
+        }
+        add(sum, histogram.sum.load(std::memory_order_relaxed));
+        std::uint64_t histogramMax = histogram.max.load(std::memory_order_relaxed);
+        if (histogramMax > max.load(std::memory_order_relaxed)) {
+            max.store(histogramMax, std::memory_order_relaxed);
+        }
+    }
+
+    /* a copy of the counters that can be merged with the other threads' histograms */
+    struct Snapshot {
+        std::array<std::uint64_t, NUM_BUCKETS> buckets{};
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t max = 0;
+
+        void merge(const LatencyHistogram &histogram) {
+            for (std::size_t i = 0; i < NUM_BUCKETS; i++) {
+                std::uint64_t n = histogram.buckets[i].load(std::memory_order_relaxed);
+                buckets[i] += n;
+                count += n;
+            }
+            sum += histogram.sum.load(std::memory_order_relaxed);
+            max = std::max(max, histogram.max.load(std::memory_order_relaxed));
+        }
+
+        /* the value at percentile 'p' (0 to 100), as the lower bound of its bucket, 0 if nothing was recorded */
+        std::uint64_t percentile(double p) const {
+            if (count == 0) {
+                return 0;
+            }
+            auto rank = std::uint64_t(p / 100.0 * double(count));
+            rank = std::max<std::uint64_t>(rank, 1);
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < NUM_BUCKETS; i++) {
+                seen += buckets[i];
+                if (seen >= rank) {
+                    return std::min(bucketValue(i), max);
+                }
+            }
+            return max;
+        }
+
+        double mean() const { return count ? double(sum) / double(count) : 0; }
+    };
+
+private:
+    std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> buckets{};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> max{0};
+
+    static void add(std::atomic<std::uint64_t> &counter, std::uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+static_assert(LatencyHistogram::bucketOf(~std::uint64_t(0)) == LatencyHistogram::NUM_BUCKETS - 1,
+              "every value has a bucket");
+
+#endif //ASSIGNMENT3_HISTOGRAM_H
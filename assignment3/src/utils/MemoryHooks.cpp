@@ -0,0 +1,96 @@
+#include "MemoryTracker.h"
+#include <cstddef>
+#include <cstdlib>
+#include <malloc.h>
+
+/* Replacements of the global operator new / delete that count the allocations of the current MemoryTracker.
+ * Linked into myrobot only. The executable exports them (-rdynamic), so they are also the operators of the
+ * algorithm libraries and of the standard containers they use. Without a current tracker an allocation costs
+ * one more thread local load than malloc. */
+namespace {
+
+void *allocate(std::size_t size, std::size_t alignment, bool nothrow) {
+    if (size == 0) {
+        size = 1;
+    }
+    void *p = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        p = std::malloc(size);
+    } else if (posix_memalign(&p, alignment, size) != 0) {
+        p = nullptr;
+    }
+    if (!p) {
+        if (nothrow) {
+            return nullptr;
+        }
+        throw std::bad_alloc();
+    }
+    if (MemoryTracker *tracker = MemoryTracker::getCurrent(); tracker && !tracker->allocated(malloc_usable_size(p))) {
+        std::free(p);
+        if (nothrow) {
+            return nullptr;
+        }
+        throw MemoryCapExceeded();
+    }
+    return p;
+}
+
+void deallocate(void *p) noexcept {
+    if (!p) {
+        return;
+    }
+    if (MemoryTracker *tracker = MemoryTracker::getCurrent()) {
+        tracker->freed(malloc_usable_size(p));
+    }
+    std::free(p);
+}
+
+}
+
+void *operator new(std::size_t size) { return allocate(size, 0, false); }
+
+void *operator new[](std::size_t size) { return allocate(size, 0, false); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, 0, true); }
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, 0, true); }
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, std::size_t(alignment), false);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, std::size_t(alignment), false);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocate(size, std::size_t(alignment), true);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocate(size, std::size_t(alignment), true);
+}
+
+void operator delete(void *p) noexcept { deallocate(p); }
+
+void operator delete[](void *p) noexcept { deallocate(p); }
+
+void operator delete(void *p, std::size_t) noexcept { deallocate(p); }
+
+void operator delete[](void *p, std::size_t) noexcept { deallocate(p); }
+
+void operator delete(void *p, const std::nothrow_t &) noexcept { deallocate(p); }
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept { deallocate(p); }
+
+void operator delete(void *p, std::align_val_t) noexcept { deallocate(p); }
+
+void operator delete[](void *p, std::align_val_t) noexcept { deallocate(p); }
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(p); }
+
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(p); }
@@ -0,0 +1,84 @@
+#ifndef ASSIGNMENT3_MEMORYTRACKER_H
+#define ASSIGNMENT3_MEMORYTRACKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+/* Thrown by operator new when an allocation would take a tracker over its cap */
+class MemoryCapExceeded : public std::bad_alloc {
+public:
+    const char *what() const noexcept override { return "memory cap exceeded"; }
+};
+
+/* The heap use of whatever runs on a thread while the tracker is current there (see Scope): bytes (as given by
+ * malloc_usable_size), peak and number of allocations, counted by the global operator new / delete of
+ * MemoryHooks.cpp. A build without MemoryHooks.cpp (the benchmarks, the tools) counts nothing.
+ * Only the memory allocated and freed while the tracker is current is counted, so a free of a block allocated
+ * before may bring the bytes below 0. A tracker has a single writer (its thread), other threads may read it. */
+class MemoryTracker {
+public:
+    /* starts counting from 0, 'capBytes' 0: no cap */
+    void reset(std::uint64_t capBytes) {
+        cap = std::int64_t(capBytes);
+        bytes.store(0, std::memory_order_relaxed);
+        peak.store(0, std::memory_order_relaxed);
+        allocations.store(0, std::memory_order_relaxed);
+        exceeded.store(false, std::memory_order_relaxed);
+    }
+
+    /* an allocation of 'size' bytes, false (and not counted) if it would exceed the cap */
+    bool allocated(std::size_t size) {
+        std::int64_t now = bytes.load(std::memory_order_relaxed) + std::int64_t(size);
+        if (cap > 0 && now > cap) {
+            exceeded.store(true, std::memory_order_relaxed);
+            return false;
+        }
+        bytes.store(now, std::memory_order_relaxed);
+        allocations.store(allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (now > peak.load(std::memory_order_relaxed)) {
+            peak.store(now, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void freed(std::size_t size) {
+        bytes.store(bytes.load(std::memory_order_relaxed) - std::int64_t(size), std::memory_order_relaxed);
+    }
+
+    std::uint64_t getPeakBytes() const { return std::uint64_t(peak.load(std::memory_order_relaxed)); }
+
+    std::uint64_t getAllocations() const { return allocations.load(std::memory_order_relaxed); }
+
+    /* an allocation was refused (even if the code that asked for it caught the exception) */
+    bool capExceeded() const { return exceeded.load(std::memory_order_relaxed); }
+
+    /* the tracker of the calling thread, nullptr if none */
+    static MemoryTracker *getCurrent() { return current; }
+
+    /* makes a tracker the current tracker of the calling thread until the end of the scope (nullptr: none) */
+    class Scope {
+    public:
+        explicit Scope(MemoryTracker *tracker) : previous(current) { current = tracker; }
+
+        ~Scope() { current = previous; }
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        MemoryTracker *previous;
+    };
+
+private:
+    static inline thread_local MemoryTracker *current = nullptr;
+
+    std::int64_t cap = 0;
+    std::atomic<std::int64_t> bytes{0};
+    std::atomic<std::int64_t> peak{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<bool> exceeded{false};
+};
+
+#endif //ASSIGNMENT3_MEMORYTRACKER_H
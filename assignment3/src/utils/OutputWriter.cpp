@@ -0,0 +1,189 @@
+#include "OutputWriter.h"
+#include <fstream>
+#include <iostream>
+#include <pthread.h>
+#include <unordered_map>
+
+OutputWriter &OutputWriter::getOutputWriter() {
+    static OutputWriter instance;
+    return instance;
+}
+
+OutputWriter::OutputWriter() : writerThread(&OutputWriter::writerLoop, this) {}
+
+OutputWriter::~OutputWriter() {
+    stop();
+}
+
+void OutputWriter::write(const std::string &fileName, std::string content, Mode mode) {
+    // Simulation threads are cancelled asynchronously on timeout. One cancelled while it allocates the request
+    // (holding the malloc lock) or pushes it would block every other thread, so write() is never cancelled
+    int oldCancelState;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldCancelState);
+    if (stopping.load(std::memory_order_acquire)) {
+        writeFile(fileName, content, mode);
+    } else {
+        auto *request = new Request();
+        request->fileName = fileName;
+        request->content = std::move(content);
+        request->mode = mode;
+        push(request);
+    }
+    pthread_setcancelstate(oldCancelState, nullptr);
+}
+
+void OutputWriter::flush() {
+    if (stopping.load(std::memory_order_acquire)) {
+        return; // the writes are synchronous
+    }
+    std::atomic<bool> flushed{false};
+    auto *marker = new Request();
+    marker->flushed = &flushed;
+    push(marker);
+    // the writer thread sets 'flushed' before bumping batchesWritten, and never touches it again
+    while (true) {
+        std::uint64_t batches = batchesWritten.load(std::memory_order_acquire);
+        if (flushed.load(std::memory_order_acquire)) {
+            return;
+        }
+        batchesWritten.wait(batches);
+    }
+}
+
+void OutputWriter::stop() {
+    if (stopping.exchange(true) || !writerThread.joinable()) {
+        return;
+    }
+    // wake the writer thread with an empty request, it exits once everything before it is written
+    push(new Request());
+    writerThread.join();
+}
+
+void OutputWriter::push(Request *request) {
+    // A producer cancelled between the two steps of the push would block the queue for good (see write())
+    int oldCancelState;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldCancelState);
+    link(request);
+    submitted.fetch_add(1, std::memory_order_release);
+    submitted.notify_one();
+    pthread_setcancelstate(oldCancelState, nullptr);
+}
+
+void OutputWriter::link(Request *request) {
+    request->next.store(nullptr, std::memory_order_relaxed);
+    Request *prev = head.exchange(request, std::memory_order_acq_rel);
+    prev->next.store(request, std::memory_order_release);
+}
+
+/* returns nullptr if the queue is empty, or if the next request is still being pushed */
+OutputWriter::Request *OutputWriter::pop() {
+    Request *first = tail;
+    Request *next = first->next.load(std::memory_order_acquire);
+    if (first == &stub) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        tail = next;
+        return first;
+    }
+    if (first != head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    // 'first' is the last request: put the stub back behind it so 'first' can be taken out
+    link(&stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+    return nullptr;
+}
+
+void OutputWriter::writerLoop() {
+    std::vector<Request *> batch;
+    std::uint64_t done = 0;
+    while (true) {
+        std::uint64_t target = submitted.load(std::memory_order_acquire);
+        if (target == done) {
+            if (stopping.load(std::memory_order_acquire)) {
+                return;
+            }
+            submitted.wait(done);
+            continue;
+        }
+        // take everything submitted so far
+        while (done + batch.size() < target) {
+            if (Request *request = pop()) {
+                batch.push_back(request);
+            } else {
+                std::this_thread::yield(); // a producer is between the two steps of its push
+            }
+        }
+        BatchObserver observer = batchObserver.load(std::memory_order_acquire);
+        if (observer) {
+            auto start = std::chrono::steady_clock::now();
+            std::size_t requests = batch.size();
+            writeBatch(batch);
+            observer(start, std::chrono::steady_clock::now(), requests);
+        } else {
+            writeBatch(batch);
+        }
+        done = target;
+        batchesWritten.fetch_add(1, std::memory_order_release);
+        batchesWritten.notify_all();
+    }
+}
+
+void OutputWriter::writeBatch(std::vector<Request *> &batch) {
+    struct PendingFile {
+        Mode mode = Mode::Append;
+        std::string content;
+    };
+    std::unordered_map<std::string, PendingFile> files;
+    std::vector<const std::string *> order;
+    std::vector<std::atomic<bool> *> markers;
+
+    for (Request *request: batch) {
+        if (request->flushed) {
+            markers.push_back(request->flushed);
+        } else if (!request->fileName.empty()) {
+            auto [it, inserted] = files.try_emplace(request->fileName);
+            if (inserted) {
+                order.push_back(&it->first);
+            }
+            PendingFile &file = it->second;
+            if (request->mode == Mode::Truncate) {
+                // whatever was appended earlier in this batch is overwritten anyway
+                file.mode = Mode::Truncate;
+                file.content = std::move(request->content);
+            } else {
+                file.content += request->content;
+            }
+        }
+        delete request;
+    }
+    batch.clear();
+
+    for (const std::string *fileName: order) {
+        const PendingFile &file = files[*fileName];
+        writeFile(*fileName, file.content, file.mode);
+    }
+    // every request before a marker is in this batch or an earlier one
+    for (std::atomic<bool> *flushed: markers) {
+        flushed->store(true, std::memory_order_release);
+    }
+}
+
+void OutputWriter::writeFile(const std::string &fileName, const std::string &content, Mode mode) {
+    std::ofstream file(fileName, mode == Mode::Truncate ? std::ios::trunc : std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open or create file: " << fileName << std::endl;
+        return;
+    }
+    file.write(content.data(), std::streamsize(content.size()));
+}
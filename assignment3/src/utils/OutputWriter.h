@@ -0,0 +1,81 @@
+#ifndef ASSIGNMENT3_OUTPUTWRITER_H
+#define ASSIGNMENT3_OUTPUTWRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Writes the output and error files on a dedicated thread, off the simulation critical path.
+ * Any thread can call write(): the request is pushed into a lock-free MPSC queue and write() returns at once.
+ * The writer thread drains the queue in batches, merges the requests of each file and writes every file with
+ * a single open + write per batch. */
+class OutputWriter {
+public:
+    enum class Mode { Truncate, Append };
+
+    // called by the writer thread after every batch with its start, end and number of requests
+    using BatchObserver = void (*)(std::chrono::steady_clock::time_point start,
+                                   std::chrono::steady_clock::time_point end, std::size_t requests);
+
+    static OutputWriter &getOutputWriter();
+
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter &) = delete;
+
+    OutputWriter &operator=(const OutputWriter &) = delete;
+
+    /* Truncate replaces the file content with 'content', Append adds it at the end of the file.
+     * Not a cancellation point: the calling thread is never cancelled inside */
+    void write(const std::string &fileName, std::string content, Mode mode);
+
+    /* block until everything written before this call is in the files: pushes a marker behind the requests of the
+     * calling thread (and of any write() that happened before) and waits for the writer thread to reach it */
+    void flush();
+
+    /* flush and stop the writer thread. Later writes are done synchronously by the calling thread */
+    void stop();
+
+    /* observe the batches of the writer thread (nullptr: none), e.g. to trace them. The writer is also linked into
+     * the algorithm libraries, which must not depend on the tracer, so the host installs it (see main.cpp) */
+    void setBatchObserver(BatchObserver observer) { batchObserver.store(observer, std::memory_order_release); }
+
+private:
+    struct Request {
+        std::atomic<Request *> next{nullptr};
+        std::string fileName;
+        std::string content;
+        Mode mode = Mode::Append;
+        std::atomic<bool> *flushed = nullptr; // flush() marker: set once the requests before it are in the files
+    };
+
+    OutputWriter();
+
+    // Vyukov intrusive MPSC queue: producers exchange 'head', the writer thread is the only one touching 'tail'
+    Request stub;
+    std::atomic<Request *> head{&stub};
+    Request *tail = &stub;
+
+    std::atomic<std::uint64_t> submitted{0}; // requests pushed so far
+    std::atomic<std::uint64_t> batchesWritten{0}; // bumped after every batch, flush() waits on it
+    std::atomic<bool> stopping{false};
+    std::atomic<BatchObserver> batchObserver{nullptr};
+    std::thread writerThread;
+
+    void push(Request *request);
+
+    void link(Request *request);
+
+    Request *pop();
+
+    void writerLoop();
+
+    void writeBatch(std::vector<Request *> &batch);
+
+    static void writeFile(const std::string &fileName, const std::string &content, Mode mode);
+};
+
+#endif //ASSIGNMENT3_OUTPUTWRITER_H
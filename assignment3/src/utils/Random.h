@@ -0,0 +1,64 @@
+#ifndef ASSIGNMENT3_RANDOM_H
+#define ASSIGNMENT3_RANDOM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/* xoshiro256** PRNG (Blackman & Vigna). Small, fast, and cheap to seed, so every algorithm instance owns one.
+ * Satisfies UniformRandomBitGenerator, so it works with the <random> distributions and std::shuffle. */
+class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed = 0) { reseed(seed); }
+
+    // the 256 bit state is expanded from the 64 bit seed with splitmix64, as recommended by the authors
+    void reseed(std::uint64_t seed) {
+        for (auto &word: state) {
+            seed += 0x9e3779b97f4a7c15ull;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // the generator state, to save and restore a run
+    std::array<std::uint64_t, 4> getState() const { return {state[0], state[1], state[2], state[3]}; }
+
+    void setState(const std::array<std::uint64_t, 4> &newState) {
+        std::copy(newState.begin(), newState.end(), state);
+    }
+
+    // uniform in [0, bound), Lemire's multiply-shift (the bias is negligible for the small bounds used here)
+    std::uint32_t below(std::uint32_t bound) {
+        return std::uint32_t(((operator()() >> 32) * bound) >> 32);
+    }
+
+private:
+    std::uint64_t state[4];
+
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif //ASSIGNMENT3_RANDOM_H
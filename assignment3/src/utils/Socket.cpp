@@ -0,0 +1,218 @@
+#include "Socket.h"
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+bool isTcpAddress(const std::string &address) {
+    return address.rfind("tcp:", 0) == 0;
+}
+
+sockaddr_un makeUnixAddress(const std::string &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path is too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+/* "tcp:<host>:<port>" -> getaddrinfo results, the caller frees them */
+addrinfo *resolveTcpAddress(const std::string &address, bool passive) {
+    std::string hostPort = address.substr(4);
+    std::size_t colon = hostPort.rfind(':');
+    if (colon == std::string::npos) {
+        throw std::runtime_error("Invalid TCP address (expected tcp:<host>:<port>): " + address);
+    }
+    std::string host = hostPort.substr(0, colon);
+    std::string port = hostPort.substr(colon + 1);
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    addrinfo *result = nullptr;
+    int error = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+    if (error != 0) {
+        throw std::runtime_error("Failed to resolve " + address + ": " + ::gai_strerror(error));
+    }
+    return result;
+}
+
+}
+
+std::string StreamSocket::getUnixPath(const std::string &address) {
+    if (isTcpAddress(address)) {
+        return "";
+    }
+    return address.rfind("unix:", 0) == 0 ? address.substr(5) : address;
+}
+
+StreamSocket StreamSocket::listen(const std::string &address) {
+    if (isTcpAddress(address)) {
+        addrinfo *info = resolveTcpAddress(address, true);
+        int fd = ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+        if (fd < 0) {
+            ::freeaddrinfo(info);
+            throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+        }
+        StreamSocket socket(fd);
+        int reuse = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        bool bound = ::bind(fd, info->ai_addr, info->ai_addrlen) == 0;
+        ::freeaddrinfo(info);
+        if (!bound || ::listen(fd, 64) < 0) {
+            throw std::runtime_error("Failed to listen on " + address + ": " + std::strerror(errno));
+        }
+        return socket;
+    }
+
+    std::string path = getUnixPath(address);
+    sockaddr_un unixAddress = makeUnixAddress(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+    }
+    StreamSocket socket(fd);
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&unixAddress), sizeof(unixAddress)) < 0 || ::listen(fd, 64) < 0) {
+        throw std::runtime_error("Failed to listen on " + path + ": " + std::strerror(errno));
+    }
+    return socket;
+}
+
+StreamSocket StreamSocket::connect(const std::string &address) {
+    if (isTcpAddress(address)) {
+        addrinfo *info = resolveTcpAddress(address, false);
+        int fd = ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+        if (fd < 0) {
+            ::freeaddrinfo(info);
+            throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+        }
+        StreamSocket socket(fd);
+        bool connected = ::connect(fd, info->ai_addr, info->ai_addrlen) == 0;
+        ::freeaddrinfo(info);
+        if (!connected) {
+            throw std::runtime_error("Failed to connect to " + address + ": " + std::strerror(errno));
+        }
+        // the protocols are request / response lines, don't let Nagle hold them back
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        return socket;
+    }
+
+    std::string path = getUnixPath(address);
+    sockaddr_un unixAddress = makeUnixAddress(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+    }
+    StreamSocket socket(fd);
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&unixAddress), sizeof(unixAddress)) < 0) {
+        throw std::runtime_error("Failed to connect to " + path + ": " + std::strerror(errno));
+    }
+    return socket;
+}
+
+StreamSocket::~StreamSocket() {
+    close();
+}
+
+StreamSocket::StreamSocket(StreamSocket &&other) noexcept: fd(other.fd), buffer(std::move(other.buffer)) {
+    other.fd = -1;
+}
+
+StreamSocket &StreamSocket::operator=(StreamSocket &&other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        buffer = std::move(other.buffer);
+        other.fd = -1;
+    }
+    return *this;
+}
+
+StreamSocket StreamSocket::accept(int timeoutMs) const {
+    if (timeoutMs >= 0) {
+        pollfd pollFd{fd, POLLIN, 0};
+        int ready;
+        do {
+            ready = ::poll(&pollFd, 1, timeoutMs);
+        } while (ready < 0 && errno == EINTR);
+        if (ready <= 0) {
+            return StreamSocket();
+        }
+    }
+    int clientFd;
+    do {
+        clientFd = ::accept(fd, nullptr, nullptr);
+    } while (clientFd < 0 && errno == EINTR);
+    if (clientFd >= 0) {
+        int noDelay = 1;
+        ::setsockopt(clientFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // fails harmlessly on Unix sockets
+    }
+    return StreamSocket(clientFd);
+}
+
+bool StreamSocket::readLine(std::string &line) {
+    while (true) {
+        std::size_t end = buffer.find('\n');
+        if (end != std::string::npos) {
+            line = buffer.substr(0, end);
+            buffer.erase(0, end + 1);
+            return true;
+        }
+        char chunk[4096];
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            // a last line without '\n' still counts
+            if (buffer.empty()) {
+                return false;
+            }
+            line.swap(buffer);
+            buffer.clear();
+            return true;
+        }
+        buffer.append(chunk, std::size_t(received));
+    }
+}
+
+bool StreamSocket::writeAll(const std::string &data) const {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        // MSG_NOSIGNAL: a peer that disconnected must not kill the process with SIGPIPE
+        ssize_t written = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        sent += std::size_t(written);
+    }
+    return true;
+}
+
+void StreamSocket::shutdown() const {
+    if (fd >= 0) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+}
+
+void StreamSocket::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
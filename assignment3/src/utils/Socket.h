@@ -0,0 +1,56 @@
+#ifndef ASSIGNMENT3_SOCKET_H
+#define ASSIGNMENT3_SOCKET_H
+
+#include <string>
+
+/* A blocking stream socket, Unix domain or TCP, with line oriented reads and writes (the daemon and coordinator
+ * protocols are made of lines). Addresses are "unix:<path>", "tcp:<host>:<port>", or a plain path (Unix domain).
+ * Owns the file descriptor: movable, not copyable. Failures to create / connect throw std::runtime_error,
+ * failures on an open connection are returned, so a peer that goes away does not bring the server down. */
+class StreamSocket {
+public:
+    /* binds and listens on 'address'. A stale Unix socket file left by a previous server is replaced */
+    static StreamSocket listen(const std::string &address);
+
+    static StreamSocket connect(const std::string &address);
+
+    /* the socket file of a Unix domain address (to remove it), empty for TCP */
+    static std::string getUnixPath(const std::string &address);
+
+    StreamSocket() = default;
+
+    ~StreamSocket();
+
+    StreamSocket(StreamSocket &&other) noexcept;
+
+    StreamSocket &operator=(StreamSocket &&other) noexcept;
+
+    StreamSocket(const StreamSocket &) = delete;
+
+    StreamSocket &operator=(const StreamSocket &) = delete;
+
+    /* blocks until a client connects, returns an invalid socket if accept fails.
+     * With 'timeoutMs' >= 0, also returns an invalid socket if no client connected in time */
+    StreamSocket accept(int timeoutMs = -1) const;
+
+    /* reads up to '\n' (not included in 'line'). Returns false once the peer closed the connection */
+    bool readLine(std::string &line);
+
+    /* returns false if the peer is gone */
+    bool writeAll(const std::string &data) const;
+
+    bool valid() const { return fd >= 0; }
+
+    void close();
+
+    /* makes a readLine blocked on this socket (in another thread) return false */
+    void shutdown() const;
+
+private:
+    int fd = -1;
+    std::string buffer; // read ahead of the current line
+
+    explicit StreamSocket(int fd) : fd(fd) {}
+};
+
+#endif //ASSIGNMENT3_SOCKET_H
@@ -0,0 +1,112 @@
+#include "TerminalRenderer.h"
+#include <algorithm>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+
+// unchanged characters between two changes that are rewritten rather than skipped with a cursor move
+constexpr int MAX_GAP = 6;
+
+void moveCursor(std::string &out, int line, int col) {
+    out += "\x1b[" + std::to_string(line + 1) + ';' + std::to_string(col + 1) + 'H';
+}
+
+}
+
+TerminalRenderer::TerminalRenderer(int viewCols, int viewRows) : viewCols(viewCols), viewRows(viewRows) {
+    if (viewCols <= 0 || viewRows <= 0) {
+        winsize size{};
+        bool terminal = ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0;
+        if (viewCols <= 0) {
+            this->viewCols = terminal ? size.ws_col : 80;
+        }
+        if (viewRows <= 0) {
+            this->viewRows = terminal ? size.ws_row : 24;
+        }
+    }
+}
+
+TerminalRenderer::~TerminalRenderer() {
+    if (cleared) {
+        out.clear();
+        moveCursor(out, int(lastStatus.size()) + frameRows, 0);
+        out += "\x1b[?25h";
+        ::write(STDOUT_FILENO, out.data(), out.size());
+    }
+}
+
+int TerminalRenderer::follow(int origin, int focus, int size, int total) {
+    if (size >= total) {
+        return 0;
+    }
+    int margin = size / 4;
+    if (focus < origin + margin || focus >= origin + size - margin) {
+        origin = focus - size / 2;
+    }
+    return std::clamp(origin, 0, total - size);
+}
+
+void TerminalRenderer::resize(int statusLines, int rows, int cols) {
+    // the status lines are taken from the view, the last line is left for the cursor
+    int rowsLeft = std::max(1, viewRows - statusLines - 1);
+    int newRows = std::min(rows, rowsLeft);
+    int newCols = std::min(cols, viewCols);
+    if (newRows != frameRows || newCols != frameCols || statusLines != int(lastStatus.size())) {
+        frameRows = newRows;
+        frameCols = newCols;
+        frame.assign(std::size_t(frameRows) * frameCols, ' ');
+        screen.clear();
+        lastStatus.assign(statusLines, std::string());
+        cleared = false;
+    }
+}
+
+void TerminalRenderer::present(const std::vector<std::string> &status) {
+    out.clear();
+    if (!cleared) {
+        // clear the screen and hide the cursor, every cell is drawn
+        out += "\x1b[?25l\x1b[2J";
+        screen.assign(frame.size(), '\0');
+        cleared = true;
+    }
+    for (std::size_t i = 0; i < status.size(); i++) {
+        if (status[i] != lastStatus[i]) {
+            moveCursor(out, int(i), 0);
+            out += status[i];
+            out += "\x1b[K";
+            lastStatus[i] = status[i];
+        }
+    }
+    int firstLine = int(status.size());
+    for (int r = 0; r < frameRows; r++) {
+        const std::size_t rowStart = std::size_t(r) * frameCols;
+        int c = 0;
+        while (c < frameCols) {
+            if (frame[rowStart + c] == screen[rowStart + c]) {
+                c++;
+                continue;
+            }
+            // a run of changes, including the short unchanged gaps inside it
+            int end = c + 1;
+            for (int gap = 0; end < frameCols && gap <= MAX_GAP; end++) {
+                gap = frame[rowStart + end] == screen[rowStart + end] ? gap + 1 : 0;
+            }
+            while (frame[rowStart + end - 1] == screen[rowStart + end - 1]) {
+                end--;
+            }
+            moveCursor(out, firstLine + r, c);
+            out.append(frame, rowStart + c, std::size_t(end - c));
+            c = end;
+        }
+    }
+    screen = frame;
+    moveCursor(out, firstLine + frameRows, 0);
+    for (std::size_t written = 0; written < out.size();) {
+        ssize_t n = ::write(STDOUT_FILENO, out.data() + written, out.size() - written);
+        if (n <= 0) {
+            break;
+        }
+        written += std::size_t(n);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef ASSIGNMENT3_TERMINALRENDERER_H
+#define ASSIGNMENT3_TERMINALRENDERER_H
+
+#include <string>
+#include <vector>
+
+/* Draws a grid, under a few status lines, in an ANSI terminal. Only the characters that changed since the previous
+ * frame are written (with cursor addressing), and a whole frame is a single write(), so a frame costs about the
+ * cells the robot changed rather than the whole house. A grid larger than the view is drawn through a viewport that
+ * follows the robot: it moves (by half a view) only when the robot gets close to one of its edges. */
+class TerminalRenderer {
+public:
+    /* the size of the grid view, 0: the size of the terminal (80x24 if stdout is not a terminal) */
+    TerminalRenderer(int viewCols = 0, int viewRows = 0);
+
+    /* restores the cursor, below the last frame */
+    ~TerminalRenderer();
+
+    TerminalRenderer(const TerminalRenderer &) = delete;
+
+    TerminalRenderer &operator=(const TerminalRenderer &) = delete;
+
+    /* draws 'status' (one line each) then the viewport of the rows x cols grid 'cellAt(row, col)' that follows
+     * (focusRow, focusCol) */
+    template<typename CellAt>
+    void draw(const std::vector<std::string> &status, int rows, int cols, int focusRow, int focusCol, CellAt cellAt) {
+        resize(int(status.size()), rows, cols);
+        originRow = follow(originRow, focusRow, frameRows, rows);
+        originCol = follow(originCol, focusCol, frameCols, cols);
+        for (int r = 0; r < frameRows; r++) {
+            for (int c = 0; c < frameCols; c++) {
+                frame[std::size_t(r) * frameCols + c] = cellAt(originRow + r, originCol + c);
+            }
+        }
+        present(status);
+    }
+
+private:
+    int viewCols;
+    int viewRows;
+    int frameRows = 0; // the drawn part of the view (the view, or the grid if it is smaller)
+    int frameCols = 0;
+    int originRow = 0; // grid cell at the top left of the view
+    int originCol = 0;
+    bool cleared = false; // the screen holds the previous frame
+    std::vector<std::string> lastStatus;
+    std::string screen; // what the terminal shows, frameRows x frameCols
+    std::string frame; // the frame being drawn
+    std::string out;
+
+    /* the origin that keeps 'focus' away from the edges of a 'size' view over 'total' cells */
+    static int follow(int origin, int focus, int size, int total);
+
+    /* starts over with a cleared screen if the layout of the frame changed */
+    void resize(int statusLines, int rows, int cols);
+
+    /* writes the differences between 'frame' and 'screen' */
+    void present(const std::vector<std::string> &status);
+};
+
+#endif //ASSIGNMENT3_TERMINALRENDERER_H
@@ -0,0 +1,118 @@
+#include "Topology.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace {
+
+const std::string CPU_DIR = "/sys/devices/system/cpu/";
+const std::string NODE_DIR = "/sys/devices/system/node/";
+
+/* the first integer of a /sys file, or 'fallback' if it cannot be read */
+int readInt(const std::string &path, int fallback) {
+    std::ifstream file(path);
+    int value;
+    return file >> value ? value : fallback;
+}
+
+/* parses a /sys CPU list such as "0-3,8,10-11" */
+std::vector<int> readCpuList(const std::string &path) {
+    std::vector<int> cpus;
+    std::ifstream file(path);
+    std::string range;
+    while (std::getline(file, range, ',')) {
+        std::size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception &) {
+            // trailing newline or an unreadable file
+        }
+    }
+    return cpus;
+}
+
+}
+
+CpuTopology CpuTopology::detect() {
+    // The CPUs this process may run on (taskset / cgroup cpusets restrict them)
+    std::vector<int> allowed;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) {
+                allowed.push_back(cpu);
+            }
+        }
+    }
+    if (allowed.empty()) {
+        for (int cpu = 0; cpu < int(std::max(1u, std::thread::hardware_concurrency())); cpu++) {
+            allowed.push_back(cpu);
+        }
+    }
+
+    std::map<int, int> nodeOfCpu;
+    std::error_code error;
+    for (const auto &entry: std::filesystem::directory_iterator(NODE_DIR, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) == 0 && name.size() > 4 && std::isdigit(static_cast<unsigned char>(name[4]))) {
+            int node = std::stoi(name.substr(4));
+            for (int cpu: readCpuList(entry.path().string() + "/cpulist")) {
+                nodeOfCpu[cpu] = node;
+            }
+        }
+    }
+
+    CpuTopology topology;
+    std::map<std::pair<int, int>, int> coreIndex; // (package, core id) -> core
+    std::map<int, int> nodeIndex;
+    for (int cpu: allowed) {
+        std::string topologyDir = CPU_DIR + "cpu" + std::to_string(cpu) + "/topology/";
+        int package = readInt(topologyDir + "physical_package_id", 0);
+        int coreId = readInt(topologyDir + "core_id", cpu);
+        auto [core, newCore] = coreIndex.emplace(std::make_pair(package, coreId), int(coreIndex.size()));
+        int node = nodeOfCpu.count(cpu) ? nodeOfCpu[cpu] : 0;
+        nodeIndex.emplace(node, int(nodeIndex.size()));
+        topology.cpus.push_back({cpu, core->second, node, newCore});
+    }
+    topology.numOfCores = coreIndex.size();
+    topology.numOfNodes = nodeIndex.size();
+
+    // Worker order: the primary CPUs before the SMT siblings, and consecutive workers on different nodes, so
+    // N workers get N cores (and spread the memory bandwidth) before two of them share a core
+    std::map<std::pair<bool, int>, std::size_t> rankInNode; // (primary, node) -> CPUs ranked so far
+    std::vector<std::pair<std::tuple<bool, std::size_t, int>, Cpu>> ordered;
+    for (const Cpu &cpu: topology.cpus) {
+        std::size_t rank = rankInNode[{cpu.primary, cpu.node}]++;
+        ordered.push_back({{!cpu.primary, rank, nodeIndex[cpu.node]}, cpu});
+    }
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+    topology.cpus.clear();
+    for (const auto &[key, cpu]: ordered) {
+        topology.cpus.push_back(cpu);
+    }
+    return topology;
+}
+
+int CpuTopology::getWorkerCpu(std::size_t workerIndex) const {
+    return cpus[workerIndex % cpus.size()].id;
+}
+
+bool CpuTopology::pinCurrentThread(int cpu) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+}
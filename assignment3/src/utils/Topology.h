@@ -0,0 +1,39 @@
+#ifndef ASSIGNMENT3_TOPOLOGY_H
+#define ASSIGNMENT3_TOPOLOGY_H
+
+#include <cstddef>
+#include <vector>
+
+/* The CPUs this process may run on, grouped into physical cores and NUMA nodes, read from /sys (Linux).
+ * Without /sys, every allowed CPU counts as its own core on node 0. */
+class CpuTopology {
+public:
+    struct Cpu {
+        int id;
+        int core; // physical core index (distinct for every package x core id), SMT siblings share it
+        int node; // NUMA node
+        bool primary; // first allowed CPU of its core
+    };
+
+    static CpuTopology detect();
+
+    std::size_t getNumOfCpus() const { return cpus.size(); }
+
+    std::size_t getNumOfCores() const { return numOfCores; }
+
+    std::size_t getNumOfNodes() const { return numOfNodes; }
+
+    /* the CPU of the i-th worker: one CPU per core first, alternating between the NUMA nodes, then the SMT siblings */
+    int getWorkerCpu(std::size_t workerIndex) const;
+
+    /* binds the calling thread to 'cpu'. Threads it creates afterwards inherit the binding.
+     * Returns false if the CPU is not allowed */
+    static bool pinCurrentThread(int cpu);
+
+private:
+    std::vector<Cpu> cpus; // in worker order
+    std::size_t numOfCores = 0;
+    std::size_t numOfNodes = 0;
+};
+
+#endif //ASSIGNMENT3_TOPOLOGY_H
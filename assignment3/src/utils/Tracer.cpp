@@ -0,0 +1,134 @@
+#include "Tracer.h"
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+std::string jsonEscape(const std::string &s) {
+    std::string escaped;
+    for (char c: s) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+}
+
+Tracer &Tracer::getTracer() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::ThreadBuffer &Tracer::getThreadBuffer() {
+    // hands the buffer back when the thread exits, its events stay for write()
+    thread_local struct Owner {
+        ThreadBuffer *buffer = nullptr;
+
+        ~Owner() {
+            if (buffer) {
+                std::lock_guard<std::mutex> lock(getTracer().buffersMutex);
+                buffer->inUse = false;
+            }
+        }
+    } owner;
+    if (!owner.buffer) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (const auto &buffer: buffers) {
+            if (!buffer->inUse) {
+                buffer->inUse = true;
+                owner.buffer = buffer.get();
+                return *owner.buffer;
+            }
+        }
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        owner.buffer = buffers.back().get();
+        owner.buffer->tid = int(buffers.size());
+        owner.buffer->events.reserve(1024);
+    }
+    return *owner.buffer;
+}
+
+void Tracer::push(Event event) {
+    ThreadBuffer &buffer = getThreadBuffer();
+    if (buffer.events.size() == MAX_THREAD_EVENTS) {
+        // the oldest half goes at once, so dropping costs O(1) per event
+        buffer.events.erase(buffer.events.begin(), buffer.events.begin() + MAX_THREAD_EVENTS / 2);
+        buffer.dropped += MAX_THREAD_EVENTS / 2;
+    }
+    buffer.events.push_back(std::move(event));
+}
+
+void Tracer::setThreadName(std::string name) {
+    if (isEnabled()) {
+        getThreadBuffer().name = std::move(name);
+    }
+}
+
+void Tracer::complete(const char *name, Clock::time_point start, Clock::time_point end, std::string args) {
+    if (isEnabled()) {
+        push({name, 'X', toUs(start), toUs(end) - toUs(start), std::move(args)});
+    }
+}
+
+void Tracer::instant(const char *name, std::string args) {
+    if (isEnabled()) {
+        push({name, 'i', toUs(Clock::now()), 0, std::move(args)});
+    }
+}
+
+std::string Tracer::args(std::initializer_list<std::pair<const char *, std::string>> values) {
+    std::string result = "{";
+    for (const auto &[key, value]: values) {
+        if (result.size() > 1) {
+            result += ',';
+        }
+        result += '"';
+        result += key;
+        result += "\":\"" + jsonEscape(value) + '"';
+    }
+    return result + "}";
+}
+
+void Tracer::write(const std::string &fileName) const {
+    std::ofstream file(fileName, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open trace file: " << fileName << std::endl;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&first]() {
+        const char *s = first ? "" : ",\n";
+        first = false;
+        return s;
+    };
+    std::size_t dropped = 0;
+    for (const auto &buffer: buffers) {
+        dropped += buffer->dropped;
+        if (!buffer->name.empty()) {
+            file << separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"args\":{\"name\":\"" << jsonEscape(buffer->name) << "\"}}";
+        }
+        for (const Event &event: buffer->events) {
+            file << separator() << "{\"ph\":\"" << event.phase << "\",\"name\":\"" << event.name
+                 << "\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << event.startUs;
+            if (event.phase == 'X') {
+                file << ",\"dur\":" << event.durationUs;
+            } else {
+                file << ",\"s\":\"t\"";
+            }
+            if (!event.args.empty()) {
+                file << ",\"args\":" << event.args;
+            }
+            file << "}";
+        }
+    }
+    file << "\n]}\n";
+    if (dropped > 0) {
+        std::cerr << fileName << ": the oldest " << dropped << " events were dropped" << std::endl;
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef ASSIGNMENT3_TRACER_H
+#define ASSIGNMENT3_TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Records a timeline of the run (-trace) and writes it in the Chrome trace event format, to open in
+ * chrome://tracing or Perfetto. Every thread appends its events to its own buffer, with no lock and no
+ * formatting: the events are only turned into JSON by write(), once the traced threads are done.
+ * Off unless enabled, then recording costs a clock read and a vector push per event.
+ * The buffer of an exited thread is taken over by the next new thread (same track), so a daemon that keeps
+ * starting threads has as many buffers as it ever had threads at once. A buffer keeps its newest
+ * MAX_THREAD_EVENTS events, the older ones are dropped. */
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t MAX_THREAD_EVENTS = std::size_t(1) << 18;
+
+    static Tracer &getTracer();
+
+    Tracer(const Tracer &) = delete;
+
+    Tracer &operator=(const Tracer &) = delete;
+
+    void enable() { enabled.store(true, std::memory_order_relaxed); }
+
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /* the name of the calling thread in the timeline */
+    void setThreadName(std::string name);
+
+    /* a span of the calling thread. 'name' must be a literal (it is kept as a pointer), 'args' is made by args() */
+    void complete(const char *name, Clock::time_point start, Clock::time_point end, std::string args = "");
+
+    /* a point in time of the calling thread */
+    void instant(const char *name, std::string args = "");
+
+    /* the "args" of an event: {"key": "value", ...} */
+    static std::string args(std::initializer_list<std::pair<const char *, std::string>> values);
+
+    /* writes every event recorded so far. The threads that record events must be stopped */
+    void write(const std::string &fileName) const;
+
+private:
+    struct Event {
+        const char *name;
+        char phase; // 'X': complete, 'i': instant
+        std::int64_t startUs;
+        std::int64_t durationUs;
+        std::string args;
+    };
+
+    struct ThreadBuffer {
+        int tid;
+        bool inUse = true; // guarded by buffersMutex
+        std::string name;
+        std::vector<Event> events;
+        std::size_t dropped = 0; // the oldest events, dropped to keep MAX_THREAD_EVENTS
+    };
+
+    std::atomic<bool> enabled{false};
+    Clock::time_point startTime = Clock::now();
+    mutable std::mutex buffersMutex; // guards the list, not the buffers
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; // kept after their threads exit, for the next threads
+
+    Tracer() = default;
+
+    /* the calling thread's buffer, taken on its first event: the buffer of an exited thread, or a new one */
+    ThreadBuffer &getThreadBuffer();
+
+    void push(Event event);
+
+    std::int64_t toUs(Clock::time_point time) const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time - startTime).count();
+    }
+};
+
+/* Records a span from its construction to its destruction, if tracing is enabled */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char *name) : name(name), active(Tracer::getTracer().isEnabled()) {
+        if (active) {
+            start = Tracer::Clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (active) {
+            Tracer::getTracer().complete(name, start, Tracer::Clock::now(), std::move(args));
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    /* false if tracing is off: the caller can skip building the args */
+    bool isActive() const { return active; }
+
+    void setArgs(std::string args) { this->args = std::move(args); }
+
+private:
+    const char *name;
+    bool active;
+    Tracer::Clock::time_point start;
+    std::string args;
+};
+
+#endif //ASSIGNMENT3_TRACER_H
@@ -61,14 +61,7 @@ std::pair<int, int> moveInDirection(std::pair<int, int> position, Direction dir)
 }
 
 void writeError(const std::string &fileName, const std::string &errorMessage) {
-    // open the file named 'fileName' (if it does not exist create it)
-    std::ofstream errorFile(fileName);
-    // check if the file cannot be opened
-    if (errorFile.is_open()) {
-        // write the error message in the file
-        errorFile << errorMessage << std::endl;
-        errorFile.close();
-    } else {
-        std::cerr << "Failed to open or create error file: " << fileName << std::endl;
-    }
+    // append to the error file (if it does not exist it is created) on the writer thread. Several simulations
+    // can report errors for the same algorithm concurrently, so the file is never truncated
+    OutputWriter::getOutputWriter().write(fileName, errorMessage + '\n', OutputWriter::Mode::Append);
 }
@@ -2,6 +2,7 @@
 #define ASSIGNMENT3_UTILS_H
 
 #include "enums.h"
+#include "OutputWriter.h"
 #include <queue>
 #include <unordered_map>
 #include <memory>